@@ -0,0 +1,566 @@
+// Recalcula el contador de eventos a partir de logs NMEA crudos con las mismas reglas
+// del firmware: nmea_verify_checksum, gps_parse_gprmc (main/modules/nmea_parser.c),
+// el filtrado de procesar_sentencia_nmea y la máquina de estados del monitor
+// (main/modules/monitor_eventos.h).
+//
+//   auditor_nmea [-u umbral_kmh] [-m umbral_movimiento_kmh] [-k] [-j hilos]
+//                [-c chunk_mb] [-e] [--continuo] [--paridad] log.nmea...
+//
+// Cada archivo se mapea en memoria y se corta en chunks en límites de sentencia.
+// Los hilos buscan '\n' y calculan el XOR del checksum de a 8 bytes, parsean las
+// GPRMC y guardan por fix solo los campos que la sentencia escribió; el hilo
+// principal reduce los chunks en orden. Como el parser del firmware conserva
+// los campos ausentes de la sentencia anterior, la reducción en orden arrastra
+// ese estado y el resultado es idéntico al del equipo (--paridad lo comprueba
+// pasando además cada archivo por nmea_acumular en lecturas del tamaño de las de
+// task_gps_read_and_parse).
+//
+// La excepción son los logs con bytes NUL o con líneas que no entran enteras en el
+// acumulador junto con una lectura: ahí lo que ve el firmware depende de cómo caen
+// las lecturas del UART. Esos archivos se marcan como "paridad no garantizada".
+//
+// Por defecto cada archivo es un arranque (estado del monitor y Kalman desde cero);
+// con --continuo los archivos se encadenan como un único flujo.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "modules/nmea_parser.h"
+#include "modules/monitor_eventos.h"
+
+// El lector del firmware acumula en nmea_acumulador_t: una línea más larga no
+// llega entera a procesar_sentencia_nmea
+#define LINEA_MAX       (NMEA_ACUMULADOR_MAX - 2)
+// task_gps_read_and_parse lee de a sizeof(rx_temp) - 1 bytes
+#define LECTURA_UART    127
+// Desde este largo (con '\r', sin '\n') el acumulador puede vaciarse a mitad de
+// la línea según dónde corten las lecturas
+#define LINEA_SEGURA    (NMEA_ACUMULADOR_MAX - 1 - LECTURA_UART)
+// gps_parse_gprmc trabaja sobre una copia de 127 caracteres
+#define PARSER_MAX      127
+
+// ===========================================================
+//  BÚSQUEDA Y CHECKSUM DE A UNA PALABRA
+// ===========================================================
+#define UNOS  0x0101010101010101ULL
+#define ALTOS 0x8080808080808080ULL
+
+// Bit alto en cada byte igual a b. Puede marcar falsos positivos solo por encima
+// de una coincidencia real, así que el primer bit y "hay alguno" son exactos.
+static inline uint64_t bytes_iguales(uint64_t w, uint8_t b)
+{
+    uint64_t x = w ^ (UNOS * b);
+    return (x - UNOS) & ~x & ALTOS;
+}
+
+static inline uint64_t leer64(const uint8_t *p)
+{
+    uint64_t w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+static const uint8_t *buscar_nl(const uint8_t *p, const uint8_t *fin)
+{
+    while (p + 8 <= fin) {
+        uint64_t m = bytes_iguales(leer64(p), '\n');
+        if (m) return p + (__builtin_ctzll(m) >> 3);
+        p += 8;
+    }
+    for (; p < fin; p++)
+        if (*p == '\n') return p;
+    return NULL;
+}
+
+static inline int valor_hex(uint8_t c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// Mismo resultado que nmea_verify_checksum. Camino rápido para la forma habitual
+// "$...*HH" sin '*' ni NUL intermedios; el resto se delega a la función del firmware.
+static bool checksum_ok(const uint8_t *s, size_t len)
+{
+    if (len >= 4 && s[len - 3] == '*') {
+        int hi = valor_hex(s[len - 2]), lo = valor_hex(s[len - 1]);
+        if (hi >= 0 && lo >= 0) {
+            const uint8_t *p = s + 1, *fin = s + len - 3;
+            uint64_t x = 0, raros = 0;
+            while (p + 8 <= fin) {
+                uint64_t w = leer64(p);
+                x ^= w;
+                raros |= bytes_iguales(w, '*') | bytes_iguales(w, 0);
+                p += 8;
+            }
+            uint8_t cs = 0;
+            for (; p < fin; p++) {
+                cs ^= *p;
+                if (*p == '*' || *p == 0) raros = 1;
+            }
+            if (!raros) {
+                x ^= x >> 32;
+                x ^= x >> 16;
+                x ^= x >> 8;
+                return (uint8_t)(cs ^ (uint8_t)x) == (uint8_t)(hi << 4 | lo);
+            }
+        }
+    }
+    char buf[LINEA_MAX + 1];
+    memcpy(buf, s, len);
+    buf[len] = 0;
+    return nmea_verify_checksum(buf);
+}
+
+// ===========================================================
+//  FASE PARALELA: CHUNKS → REGISTROS POR GPRMC
+// ===========================================================
+#define ESCRIBE_VALID   0x01    // la sentencia tenía campo 2 (estado)
+#define ESCRIBE_VEL     0x02    // la sentencia tenía campo 7 (velocidad)
+#define VALID           0x04
+
+typedef struct {
+    uint32_t offset;        // desde el inicio del chunk
+    uint8_t flags;
+    double vel;             // km/h tal como la deja gps_parse_gprmc
+} registro_t;
+
+typedef struct {
+    const uint8_t *ini, *fin;
+    uint64_t base;          // offset del chunk en el archivo
+    registro_t *reg;
+    size_t n, cap;
+    uint64_t lineas, rmc, rmc_ok;
+    uint64_t nul, largas;   // lo que rompe la paridad con el acumulador del firmware
+    bool listo;
+} chunk_t;
+
+static void agregar_registro(chunk_t *c, const registro_t *r)
+{
+    if (c->n == c->cap) {
+        c->cap = c->cap ? c->cap * 2 : 4096;
+        c->reg = realloc(c->reg, c->cap * sizeof(registro_t));
+        if (c->reg == NULL) { perror("realloc"); exit(1); }
+    }
+    c->reg[c->n++] = *r;
+}
+
+// Tokens no vacíos separados por ',' (lo que recorre strtok_r en el parser)
+static int contar_tokens(const char *s)
+{
+    int n = 0;
+    bool dentro = false;
+    for (; *s; s++) {
+        if (*s == ',') dentro = false;
+        else if (!dentro) { dentro = true; n++; }
+    }
+    return n;
+}
+
+static void procesar_linea(chunk_t *c, const uint8_t *s, size_t len)
+{
+    c->lineas++;
+    if (len < 6 || len > LINEA_MAX || memcmp(s, "$GPRMC", 6) != 0) return;
+    c->rmc++;
+    if (!checksum_ok(s, len)) return;
+    c->rmc_ok++;
+
+    char buf[PARSER_MAX + 1];
+    size_t n = len < PARSER_MAX ? len : PARSER_MAX;
+    memcpy(buf, s, n);
+    buf[n] = 0;
+
+    gps_data_t gps = {0};
+    gps_parse_gprmc(buf, &gps);
+    int tokens = contar_tokens(buf);
+
+    registro_t r = { .offset = (uint32_t)(s - c->ini), .vel = gps.speed_kmh };
+    if (tokens > 2) r.flags |= ESCRIBE_VALID | (gps.valid ? VALID : 0);
+    if (tokens > 7) r.flags |= ESCRIBE_VEL;
+    if (r.flags) agregar_registro(c, &r);
+}
+
+static void procesar_chunk(chunk_t *c)
+{
+    const uint8_t *p = c->ini;
+    const uint8_t *nl;
+    while ((nl = buscar_nl(p, c->fin)) != NULL) {
+        size_t len = nl - p;
+        if (len >= LINEA_SEGURA) c->largas++;
+        if (len > 0 && p[len - 1] == '\r') len--;
+        procesar_linea(c, p, len);
+        p = nl + 1;
+    }
+    // una línea final sin '\n' nunca llega a procesar_sentencia_nmea
+
+    for (const uint8_t *z = c->ini; (z = memchr(z, 0, c->fin - z)) != NULL; z++)
+        c->nul++;
+}
+
+// ===========================================================
+//  REDUCCIÓN EN ORDEN
+// ===========================================================
+typedef struct {
+    double umbral;
+    double umbral_movimiento;
+    bool kalman;
+} reglas_t;
+
+// Estado que el firmware arrastra entre sentencias
+typedef struct {
+    bool valid;
+    double vel;
+    kalman_t kf;
+    bool kalman_listo;
+    monitor_eventos_t monitor;
+    uint64_t fixes, eventos;
+} estado_t;
+
+typedef struct {
+    uint64_t offset;
+    double vel;
+} evento_t;
+
+typedef struct {
+    evento_t *e;
+    size_t n, cap;
+} eventos_t;
+
+// Lo que hace procesar_sentencia_nmea con un fix válido y luego task_monitor_velocidad
+static bool aplicar_fix(estado_t *st, const reglas_t *r)
+{
+    st->fixes++;
+    if (r->kalman) {
+        if (!st->kalman_listo) {
+            kalman_init(&st->kf, CONFIG_GPS_KALMAN_Q_MILI / 1000.0, CONFIG_GPS_KALMAN_R_MILI / 1000.0);
+            st->kf.estimate = st->vel;
+            st->kalman_listo = true;
+        }
+        st->vel = kalman_update(&st->kf, st->vel);
+    }
+    if (st->vel < r->umbral_movimiento) st->vel = 0.0;
+
+    if (monitor_eventos_evaluar(&st->monitor, st->vel, r->umbral)) {
+        st->eventos++;
+        return true;
+    }
+    return false;
+}
+
+static void reducir_chunk(estado_t *st, const reglas_t *r, const chunk_t *c, eventos_t *ev)
+{
+    for (size_t i = 0; i < c->n; i++) {
+        const registro_t *g = &c->reg[i];
+        if (g->flags & ESCRIBE_VALID) st->valid = g->flags & VALID;
+        if (g->flags & ESCRIBE_VEL) st->vel = g->vel;
+        if (!st->valid) continue;
+        if (aplicar_fix(st, r) && ev) {
+            if (ev->n == ev->cap) {
+                ev->cap = ev->cap ? ev->cap * 2 : 256;
+                ev->e = realloc(ev->e, ev->cap * sizeof(evento_t));
+                if (ev->e == NULL) { perror("realloc"); exit(1); }
+            }
+            ev->e[ev->n++] = (evento_t){ .offset = c->base + g->offset, .vel = st->vel };
+        }
+    }
+}
+
+// ===========================================================
+//  HILOS
+// ===========================================================
+typedef struct {
+    chunk_t *chunks;
+    size_t n_chunks;
+    size_t siguiente;       // próximo chunk a tomar
+    size_t reducidos;       // chunks ya reducidos (limita la memoria en vuelo)
+    size_t en_vuelo_max;
+    pthread_mutex_t mutex;
+    pthread_cond_t cambio;
+} trabajo_t;
+
+static void *hilo_trabajo(void *arg)
+{
+    trabajo_t *t = arg;
+    for (;;) {
+        pthread_mutex_lock(&t->mutex);
+        while (t->siguiente < t->n_chunks && t->siguiente >= t->reducidos + t->en_vuelo_max)
+            pthread_cond_wait(&t->cambio, &t->mutex);
+        if (t->siguiente >= t->n_chunks) {
+            pthread_mutex_unlock(&t->mutex);
+            return NULL;
+        }
+        chunk_t *c = &t->chunks[t->siguiente++];
+        pthread_mutex_unlock(&t->mutex);
+
+        procesar_chunk(c);
+
+        pthread_mutex_lock(&t->mutex);
+        c->listo = true;
+        pthread_cond_broadcast(&t->cambio);
+        pthread_mutex_unlock(&t->mutex);
+    }
+}
+
+// Corta [datos, datos+tam) en chunks que empiezan justo después de un '\n'
+static size_t cortar_chunks(const uint8_t *datos, size_t tam, size_t objetivo, chunk_t **salida)
+{
+    size_t cap = tam / objetivo + 2, n = 0;
+    chunk_t *c = calloc(cap, sizeof(chunk_t));
+    size_t ini = 0;
+    while (ini < tam) {
+        size_t fin = ini + objetivo;
+        if (fin >= tam) {
+            fin = tam;
+        } else {
+            const uint8_t *nl = buscar_nl(datos + fin, datos + tam);
+            fin = nl ? (size_t)(nl - datos) + 1 : tam;
+        }
+        c[n++] = (chunk_t){ .ini = datos + ini, .fin = datos + fin, .base = ini };
+        ini = fin;
+    }
+    *salida = c;
+    return n;
+}
+
+typedef struct {
+    uint64_t bytes, lineas, rmc, rmc_ok;
+    uint64_t nul, largas;
+} totales_t;
+
+static int auditar_archivo(const char *ruta, int hilos, size_t chunk_bytes, const reglas_t *r,
+                           estado_t *st, totales_t *tot, eventos_t *ev)
+{
+    int fd = open(ruta, O_RDONLY);
+    if (fd < 0) { perror(ruta); return -1; }
+    struct stat sb;
+    fstat(fd, &sb);
+    size_t tam = sb.st_size;
+    if (tam == 0) { close(fd); return 0; }
+
+    const uint8_t *datos = mmap(NULL, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (datos == MAP_FAILED) { perror(ruta); return -1; }
+    madvise((void *)datos, tam, MADV_SEQUENTIAL);
+
+    trabajo_t t = { .en_vuelo_max = 2 * hilos };
+    t.n_chunks = cortar_chunks(datos, tam, chunk_bytes, &t.chunks);
+    pthread_mutex_init(&t.mutex, NULL);
+    pthread_cond_init(&t.cambio, NULL);
+
+    pthread_t *th = malloc(hilos * sizeof(pthread_t));
+    for (int i = 0; i < hilos; i++) pthread_create(&th[i], NULL, hilo_trabajo, &t);
+
+    for (size_t i = 0; i < t.n_chunks; i++) {
+        chunk_t *c = &t.chunks[i];
+        pthread_mutex_lock(&t.mutex);
+        while (!c->listo) pthread_cond_wait(&t.cambio, &t.mutex);
+        pthread_mutex_unlock(&t.mutex);
+
+        reducir_chunk(st, r, c, ev);
+        tot->lineas += c->lineas;
+        tot->rmc += c->rmc;
+        tot->rmc_ok += c->rmc_ok;
+        tot->nul += c->nul;
+        tot->largas += c->largas;
+        free(c->reg);
+        c->reg = NULL;
+
+        pthread_mutex_lock(&t.mutex);
+        t.reducidos = i + 1;
+        pthread_cond_broadcast(&t.cambio);
+        pthread_mutex_unlock(&t.mutex);
+    }
+    for (int i = 0; i < hilos; i++) pthread_join(th[i], NULL);
+    tot->bytes += tam;
+
+    free(th);
+    free(t.chunks);
+    pthread_mutex_destroy(&t.mutex);
+    pthread_cond_destroy(&t.cambio);
+    munmap((void *)datos, tam);
+    return 0;
+}
+
+// ===========================================================
+//  REFERENCIA SERIE (--paridad)
+// ===========================================================
+// Recorre el archivo como task_gps_read_and_parse: lecturas de LECTURA_UART bytes
+// a nmea_acumular y, por línea, lo que hace procesar_sentencia_nmea con las GPRMC,
+// con un gps_data_t persistente y solo funciones del firmware. Con arranque el
+// acumulador empieza vacío; si no, sigue con el resto del archivo anterior.
+typedef struct {
+    const reglas_t *r;
+    estado_t *st;
+    gps_data_t gps;
+} serie_t;
+
+static void serie_por_linea(char *linea, void *ctx)
+{
+    serie_t *s = ctx;
+    if (!nmea_verify_checksum(linea)) return;
+    if (strncmp(linea, "$GPRMC", 6) != 0) return;
+    if (gps_parse_gprmc(linea, &s->gps) && s->gps.valid) {
+        s->st->vel = s->gps.speed_kmh;
+        aplicar_fix(s->st, s->r);
+        s->gps.speed_kmh = s->st->vel;
+    }
+}
+
+static uint64_t auditar_serie(const char *ruta, const reglas_t *r, estado_t *st, bool arranque)
+{
+    static nmea_acumulador_t acc;
+    if (arranque) acc.largo = 0;
+
+    FILE *f = fopen(ruta, "rb");
+    if (f == NULL) { perror(ruta); return 0; }
+    static serie_t s;
+    s.r = r;
+    s.st = st;
+    s.gps.valid = st->valid;
+    s.gps.speed_kmh = st->vel;
+
+    uint8_t lectura[LECTURA_UART];
+    size_t n;
+    while ((n = fread(lectura, 1, sizeof(lectura), f)) > 0)
+        nmea_acumular(&acc, lectura, n, serie_por_linea, &s);
+
+    st->valid = s.gps.valid;
+    st->vel = s.gps.speed_kmh;
+    fclose(f);
+    return st->eventos;
+}
+
+// ===========================================================
+//  LISTADO DE EVENTOS (-e)
+// ===========================================================
+static void listar_eventos(const char *ruta, const eventos_t *ev)
+{
+    FILE *f = fopen(ruta, "rb");
+    if (f == NULL) return;
+    char linea[256];
+    for (size_t i = 0; i < ev->n; i++) {
+        gps_data_t gps = {0};
+        fseek(f, ev->e[i].offset, SEEK_SET);
+        if (fgets(linea, sizeof(linea), f)) {
+            linea[strcspn(linea, "\r\n")] = 0;
+            gps_parse_gprmc(linea, &gps);
+        }
+        printf("  evento offset=%llu fecha=%.6s hora=%.6s vel=%.2f lat=%.6f lon=%.6f\n",
+               (unsigned long long)ev->e[i].offset, gps.date, gps.time, ev->e[i].vel,
+               gps.latitude, gps.longitude);
+    }
+    fclose(f);
+}
+
+// ===========================================================
+//  MAIN
+// ===========================================================
+int main(int argc, char **argv)
+{
+    reglas_t reglas = {
+        .umbral = CONFIG_MONITOR_UMBRAL_VELOCIDAD_KMH,
+        .umbral_movimiento = CONFIG_GPS_UMBRAL_MOVIMIENTO_KMH,
+        .kalman = false,
+    };
+    int hilos = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t chunk_mb = 16;
+    bool listar = false, continuo = false, paridad = false;
+    const char *logs[4096];
+    int n_logs = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-u") && i + 1 < argc) reglas.umbral = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-m") && i + 1 < argc) reglas.umbral_movimiento = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-k")) reglas.kalman = true;
+        else if (!strcmp(argv[i], "-j") && i + 1 < argc) hilos = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-c") && i + 1 < argc) chunk_mb = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-e")) listar = true;
+        else if (!strcmp(argv[i], "--continuo")) continuo = true;
+        else if (!strcmp(argv[i], "--paridad")) paridad = true;
+        else if (argv[i][0] != '-' && n_logs < 4096) logs[n_logs++] = argv[i];
+        else {
+            fprintf(stderr, "uso: %s [-u umbral_kmh] [-m umbral_movimiento_kmh] [-k] [-j hilos] [-c chunk_mb]\n"
+                            "          [-e] [--continuo] [--paridad] log.nmea...\n", argv[0]);
+            return 2;
+        }
+    }
+    if (n_logs == 0) {
+        fprintf(stderr, "falta al menos un log NMEA\n");
+        return 2;
+    }
+    if (hilos < 1) hilos = 1;
+    if (chunk_mb < 1) chunk_mb = 1;
+
+    estado_t st = {0}, ref = {0};
+    totales_t tot = {0};
+    uint64_t eventos_total = 0;
+    int diferencias = 0, no_garantizados = 0;
+    struct timespec t0, t1;
+    double segundos = 0;
+
+    for (int i = 0; i < n_logs; i++) {
+        if (!continuo) {
+            eventos_total += st.eventos;
+            st = (estado_t){0};
+        }
+        uint64_t previos = st.eventos, fixes_previos = st.fixes;
+        uint64_t nul_previos = tot.nul, largas_previas = tot.largas;
+        eventos_t ev = {0};
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        if (auditar_archivo(logs[i], hilos, chunk_mb << 20, &reglas, &st, &tot, listar ? &ev : NULL) < 0)
+            return 1;
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        segundos += (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+        printf("%s: fixes=%llu eventos=%llu\n", logs[i],
+               (unsigned long long)(st.fixes - fixes_previos), (unsigned long long)(st.eventos - previos));
+        if (tot.nul != nul_previos || tot.largas != largas_previas) {
+            printf("  ⚠️  paridad no garantizada: %llu bytes NUL, %llu líneas de %d bytes o más\n",
+                   (unsigned long long)(tot.nul - nul_previos),
+                   (unsigned long long)(tot.largas - largas_previas), LINEA_SEGURA);
+            no_garantizados++;
+        }
+        if (listar) listar_eventos(logs[i], &ev);
+        free(ev.e);
+
+        if (paridad) {
+            if (!continuo) ref = (estado_t){0};
+            uint64_t ref_previos = ref.eventos;
+            auditar_serie(logs[i], &reglas, &ref, !continuo || i == 0);
+            if (ref.eventos - ref_previos != st.eventos - previos || ref.fixes != st.fixes) {
+                printf("  ❌ paridad: serie fixes=%llu eventos=%llu\n",
+                       (unsigned long long)ref.fixes, (unsigned long long)(ref.eventos - ref_previos));
+                diferencias++;
+            }
+        }
+    }
+    eventos_total += st.eventos;
+
+    printf("\narchivos: %d, %.1f MB, líneas: %llu, GPRMC: %llu (checksum OK %llu)\n",
+           n_logs, tot.bytes / 1e6, (unsigned long long)tot.lineas,
+           (unsigned long long)tot.rmc, (unsigned long long)tot.rmc_ok);
+    // el firmware guarda el contador como uint16_t
+    printf("eventos: %llu (en el display del equipo: %u)\n",
+           (unsigned long long)eventos_total, (unsigned)(eventos_total & 0xFFFF));
+    printf("hilos: %d, %.3f s, %.2f GB/s\n", hilos, segundos, segundos > 0 ? tot.bytes / segundos / 1e9 : 0);
+    if (paridad && (diferencias || !no_garantizados))
+        printf("paridad con el acumulador del firmware: %s\n", diferencias ? "❌ DIFERENCIAS" : "✅ idéntica");
+    else if (paridad)
+        printf("paridad con el acumulador del firmware: ✅ idéntica en lecturas de %d bytes; %d archivo(s) "
+               "dependen de dónde corten las lecturas reales\n", LECTURA_UART, no_garantizados);
+    else if (no_garantizados)
+        printf("paridad con el firmware no garantizada en %d archivo(s): usar --paridad\n", no_garantizados);
+    return diferencias ? 1 : 0;
+}
@@ -0,0 +1,425 @@
+// Barrido de parámetros del detector de exceso: reproduce los fixes de uno o más
+// logs NMEA a través de Kalman + umbral de movimiento + máquina de estados del
+// monitor para miles de combinaciones a la vez y reporta por combinación eventos,
+// falsos disparos, excesos perdidos y retardo de detección frente a la verdad.
+//
+//   barrido_umbrales [-u min:max:paso] [-m min:max:paso] [-q min:max:paso] [-R min:max:paso]
+//                    [-v etiquetas.csv | -r umbral_ref -d duracion_min_s] [-t tolerancia_s]
+//                    [-o resultados.csv] [-n mejores] [-j hilos] log.nmea...
+//
+// -q 0 equivale a Kalman desactivado. La verdad son intervalos "t_ini,t_fin" en
+// segundos desde 2000-01-01 UTC (-v); sin etiquetas se deriva de la velocidad cruda:
+// tramos sobre -r que duran al menos -d segundos.
+//
+// Los parámetros y el estado se guardan como estructura de arreglos: la
+// actualización de un fix recorre todas las combinaciones en un bucle sin saltos
+// que el compilador vectoriza. Las combinaciones se reparten en bloques entre
+// hilos; cada bloque recorre todos los fixes con su estado en caché.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "modules/nmea_parser.h"
+#include "modules/trayecto_codec.h"
+
+// ===========================================================
+//  FIXES
+// ===========================================================
+typedef struct {
+    double *t;      // segundos desde 2000
+    double *vel;    // km/h crudos (gps_parse_gprmc)
+    size_t n, cap;
+} fixes_t;
+
+static void leer_log(const char *ruta, fixes_t *f)
+{
+    FILE *fp = fopen(ruta, "r");
+    if (fp == NULL) { perror(ruta); exit(1); }
+    char linea[256];
+    gps_data_t gps = {0};
+    while (fgets(linea, sizeof(linea), fp)) {
+        linea[strcspn(linea, "\r\n")] = 0;
+        if (!nmea_verify_checksum(linea)) continue;
+        if (!gps_parse_gprmc(linea, &gps) || !gps.valid) continue;
+
+        uint32_t s = trayecto_segundos_desde_2000(gps.date, gps.time);
+        if (s == 0) continue;
+        const char *punto = strchr(gps.time, '.');
+        double t = s + (punto ? atof(punto) : 0.0);
+
+        if (f->n == f->cap) {
+            f->cap = f->cap ? f->cap * 2 : 65536;
+            f->t = realloc(f->t, f->cap * sizeof(double));
+            f->vel = realloc(f->vel, f->cap * sizeof(double));
+            if (f->t == NULL || f->vel == NULL) { perror("realloc"); exit(1); }
+        }
+        f->t[f->n] = t;
+        f->vel[f->n] = gps.speed_kmh;
+        f->n++;
+    }
+    fclose(fp);
+}
+
+// ===========================================================
+//  VERDAD
+// ===========================================================
+typedef struct {
+    double *ini, *fin;
+    size_t n;
+} verdad_t;
+
+static void verdad_agregar(verdad_t *v, double ini, double fin)
+{
+    v->ini = realloc(v->ini, (v->n + 1) * sizeof(double));
+    v->fin = realloc(v->fin, (v->n + 1) * sizeof(double));
+    v->ini[v->n] = ini;
+    v->fin[v->n] = fin;
+    v->n++;
+}
+
+static void leer_etiquetas(const char *ruta, verdad_t *v)
+{
+    FILE *fp = fopen(ruta, "r");
+    if (fp == NULL) { perror(ruta); exit(1); }
+    char linea[128];
+    double a, b;
+    while (fgets(linea, sizeof(linea), fp))
+        if (sscanf(linea, "%lf,%lf", &a, &b) == 2) verdad_agregar(v, a, b);
+    fclose(fp);
+}
+
+static void derivar_verdad(const fixes_t *f, double umbral, double duracion_min, verdad_t *v)
+{
+    size_t i = 0;
+    while (i < f->n) {
+        if (f->vel[i] <= umbral) { i++; continue; }
+        size_t j = i;
+        while (j + 1 < f->n && f->vel[j + 1] > umbral) j++;
+        if (f->t[j] - f->t[i] >= duracion_min) verdad_agregar(v, f->t[i], f->t[j]);
+        i = j + 1;
+    }
+}
+
+// ===========================================================
+//  COMBINACIONES (estructura de arreglos)
+// ===========================================================
+typedef struct {
+    size_t n;
+    // parámetros
+    double *umbral, *umbral_mov, *q, *r;
+    // estado por combinación
+    double *estimado, *p;
+    double *sobre, *ultimo_verdadero;
+    // resultados (contadores en double, ver actualizar())
+    double *eventos, *verdaderos, *falsos;
+    double *retardo_suma, *retardo_max;
+} barrido_t;
+
+typedef struct {
+    double min, max, paso;
+} rango_t;
+
+static size_t rango_cantidad(const rango_t *r)
+{
+    if (r->paso <= 0 || r->max < r->min) return 1;
+    return (size_t)((r->max - r->min) / r->paso + 1e-9) + 1;
+}
+
+static double *reservar(size_t n)
+{
+    double *p = calloc(n, sizeof(double));
+    if (p == NULL) { perror("calloc"); exit(1); }
+    return p;
+}
+
+static void barrido_init(barrido_t *b, const rango_t *u, const rango_t *m, const rango_t *q, const rango_t *r)
+{
+    size_t nu = rango_cantidad(u), nm = rango_cantidad(m), nq = rango_cantidad(q), nr = rango_cantidad(r);
+    b->n = nu * nm * nq * nr;
+    b->umbral = reservar(b->n);
+    b->umbral_mov = reservar(b->n);
+    b->q = reservar(b->n);
+    b->r = reservar(b->n);
+    b->estimado = reservar(b->n);
+    b->p = reservar(b->n);
+    b->retardo_suma = reservar(b->n);
+    b->retardo_max = reservar(b->n);
+    b->sobre = reservar(b->n);
+    b->ultimo_verdadero = reservar(b->n);
+    b->eventos = reservar(b->n);
+    b->verdaderos = reservar(b->n);
+    b->falsos = reservar(b->n);
+
+    size_t k = 0;
+    for (size_t a = 0; a < nu; a++)
+        for (size_t c = 0; c < nm; c++)
+            for (size_t d = 0; d < nq; d++)
+                for (size_t e = 0; e < nr; e++, k++) {
+                    b->umbral[k] = u->min + a * u->paso;
+                    b->umbral_mov[k] = m->min + c * m->paso;
+                    b->q[k] = q->min + d * q->paso;
+                    b->r[k] = r->min + e * r->paso;
+                }
+}
+
+// Arranque del equipo: kalman_init (P = 1) y estimación = primera velocidad,
+// monitor fuera del umbral
+static void barrido_reiniciar(barrido_t *b, size_t desde, size_t hasta, double vel0)
+{
+    for (size_t j = desde; j < hasta; j++) {
+        b->estimado[j] = vel0;
+        b->p[j] = 1.0;
+        b->sobre[j] = 0;
+        b->ultimo_verdadero[j] = -1.0;
+    }
+}
+
+// Un fix para todas las combinaciones. Mismas operaciones que kalman_update,
+// el corte de procesar_sentencia_nmea y monitor_eventos_evaluar, sin saltos:
+// banderas y contadores son double (0/1) para que todo el bucle use el mismo
+// ancho de carril. dentro: el fix cae en el intervalo verdadero k (con tolerancia).
+// Fuera de línea para que los restrict de los parámetros valgan en el bucle.
+__attribute__((noinline))
+static void actualizar(size_t n, double z, double k, double dentro, double retardo,
+                       const double *restrict umbral, const double *restrict umbral_mov,
+                       const double *restrict q, const double *restrict r,
+                       double *restrict est, double *restrict p, double *restrict sobre,
+                       double *restrict ultimo, double *restrict eventos, double *restrict verdaderos,
+                       double *restrict falsos, double *restrict rsuma, double *restrict rmax)
+{
+    for (size_t j = 0; j < n; j++) {
+        double pj = p[j] + q[j];
+        double kg = pj / (pj + r[j]);
+        double e = est[j] + kg * (z - est[j]);
+        p[j] = pj * (1.0 - kg);
+        est[j] = e;
+        // Q = 0 → sin Kalman (con P inicial 1 el filtro no sería la identidad)
+        double v = q[j] > 0.0 ? e : z;
+        v = v < umbral_mov[j] ? 0.0 : v;
+
+        double s = v > umbral[j] ? 1.0 : 0.0;
+        double ev = s * (1.0 - sobre[j]);
+        sobre[j] = s;
+
+        double nuevo = ev * dentro * (ultimo[j] != k ? 1.0 : 0.0);
+        eventos[j] += ev;
+        verdaderos[j] += nuevo;
+        falsos[j] += ev - nuevo;
+        ultimo[j] = nuevo > 0.0 ? k : ultimo[j];
+        double rn = nuevo * retardo;
+        rsuma[j] += rn;
+        rmax[j] = rmax[j] > rn ? rmax[j] : rn;
+    }
+}
+
+// ===========================================================
+//  RECORRIDO POR BLOQUES DE COMBINACIONES
+// ===========================================================
+// Lo que cada fix aporta, igual para todas las combinaciones (calculado una vez)
+typedef struct {
+    size_t n;
+    double *z, *k, *dentro, *retardo;
+    bool *reinicio;         // primer fix de un log: el equipo arrancó
+} entradas_t;
+
+// Un bloque de combinaciones recorre todos los fixes; cabe en caché L1/L2
+#define BLOQUE 512
+
+typedef struct {
+    barrido_t *b;
+    const entradas_t *in;
+    size_t siguiente;
+    pthread_mutex_t mutex;
+} trabajo_t;
+
+static void barrer_bloque(barrido_t *b, const entradas_t *in, size_t desde, size_t hasta)
+{
+    size_t n = hasta - desde;
+    for (size_t i = 0; i < in->n; i++) {
+        if (in->reinicio[i]) barrido_reiniciar(b, desde, hasta, in->z[i]);
+        actualizar(n, in->z[i], in->k[i], in->dentro[i], in->retardo[i],
+                   b->umbral + desde, b->umbral_mov + desde, b->q + desde, b->r + desde,
+                   b->estimado + desde, b->p + desde, b->sobre + desde,
+                   b->ultimo_verdadero + desde, b->eventos + desde, b->verdaderos + desde,
+                   b->falsos + desde, b->retardo_suma + desde, b->retardo_max + desde);
+    }
+}
+
+static void *hilo_barrido(void *arg)
+{
+    trabajo_t *t = arg;
+    for (;;) {
+        pthread_mutex_lock(&t->mutex);
+        size_t desde = t->siguiente;
+        t->siguiente += BLOQUE;
+        pthread_mutex_unlock(&t->mutex);
+        if (desde >= t->b->n) return NULL;
+        size_t hasta = desde + BLOQUE < t->b->n ? desde + BLOQUE : t->b->n;
+        barrer_bloque(t->b, t->in, desde, hasta);
+    }
+}
+
+// ===========================================================
+//  RESULTADOS
+// ===========================================================
+static double puntaje(const barrido_t *b, size_t j, size_t n_verdad)
+{
+    // cada error (falso o perdido) pesa lo mismo; el retardo desempata
+    double perdidos = (double)n_verdad - b->verdaderos[j];
+    double retardo = b->verdaderos[j] ? b->retardo_suma[j] / b->verdaderos[j] : 0;
+    return b->falsos[j] + perdidos + retardo * 1e-3;
+}
+
+static const barrido_t *b_orden;
+static size_t n_verdad_orden;
+
+static int comparar_puntaje(const void *x, const void *y)
+{
+    double a = puntaje(b_orden, *(const size_t *)x, n_verdad_orden);
+    double c = puntaje(b_orden, *(const size_t *)y, n_verdad_orden);
+    return (a > c) - (a < c);
+}
+
+static void imprimir(FILE *f, const barrido_t *b, size_t j, size_t n_verdad, double horas)
+{
+    int verdaderos = (int)b->verdaderos[j];
+    fprintf(f, "%.2f,%.2f,%.4f,%.4f,%d,%d,%d,%zu,%.3f,%.2f,%.2f\n",
+            b->umbral[j], b->umbral_mov[j], b->q[j], b->r[j],
+            (int)b->eventos[j], verdaderos, (int)b->falsos[j], n_verdad - verdaderos,
+            horas > 0 ? b->falsos[j] / horas : 0.0,
+            verdaderos ? b->retardo_suma[j] / verdaderos : 0.0, b->retardo_max[j]);
+}
+
+static rango_t leer_rango(const char *s)
+{
+    rango_t r = {0};
+    int n = sscanf(s, "%lf:%lf:%lf", &r.min, &r.max, &r.paso);
+    if (n == 1) { r.max = r.min; r.paso = 0; }
+    return r;
+}
+
+// ===========================================================
+//  MAIN
+// ===========================================================
+int main(int argc, char **argv)
+{
+    rango_t ru = { 20, 40, 0.5 };
+    rango_t rm = { 0, 10, 1 };
+    rango_t rq = { 0, 0.2, 0.025 };
+    rango_t rr = { CONFIG_GPS_KALMAN_R_MILI / 1000.0, 0, 0 };
+    const char *etiquetas = NULL, *salida = NULL;
+    double umbral_ref = CONFIG_MONITOR_UMBRAL_VELOCIDAD_KMH, duracion_min = 2.0, tolerancia = 2.0;
+    size_t mejores = 10;
+    int hilos = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *logs[256];
+    int n_logs = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-u") && i + 1 < argc) ru = leer_rango(argv[++i]);
+        else if (!strcmp(argv[i], "-m") && i + 1 < argc) rm = leer_rango(argv[++i]);
+        else if (!strcmp(argv[i], "-q") && i + 1 < argc) rq = leer_rango(argv[++i]);
+        else if (!strcmp(argv[i], "-R") && i + 1 < argc) rr = leer_rango(argv[++i]);
+        else if (!strcmp(argv[i], "-v") && i + 1 < argc) etiquetas = argv[++i];
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc) umbral_ref = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-d") && i + 1 < argc) duracion_min = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc) tolerancia = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc) salida = argv[++i];
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc) mejores = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-j") && i + 1 < argc) hilos = atoi(argv[++i]);
+        else if (argv[i][0] != '-' && n_logs < 256) logs[n_logs++] = argv[i];
+        else {
+            fprintf(stderr, "uso: %s [-u min:max:paso] [-m min:max:paso] [-q min:max:paso] [-R min:max:paso]\n"
+                            "          [-v etiquetas.csv | -r umbral_ref -d duracion_min_s] [-t tolerancia_s]\n"
+                            "          [-o resultados.csv] [-n mejores] [-j hilos] log.nmea...\n", argv[0]);
+            return 2;
+        }
+    }
+    if (n_logs == 0) {
+        fprintf(stderr, "falta al menos un log NMEA\n");
+        return 2;
+    }
+    if (hilos < 1) hilos = 1;
+
+    fixes_t f = {0};
+    size_t *inicio_log = calloc(n_logs + 1, sizeof(size_t));
+    for (int i = 0; i < n_logs; i++) {
+        inicio_log[i] = f.n;
+        leer_log(logs[i], &f);
+    }
+    inicio_log[n_logs] = f.n;
+    if (f.n == 0) {
+        fprintf(stderr, "no hay fixes válidos\n");
+        return 1;
+    }
+
+    verdad_t v = {0};
+    if (etiquetas) leer_etiquetas(etiquetas, &v);
+    else derivar_verdad(&f, umbral_ref, duracion_min, &v);
+
+    barrido_t b;
+    barrido_init(&b, &ru, &rm, &rq, &rr);
+
+    entradas_t in = {
+        .n = f.n, .z = f.vel,
+        .k = reservar(f.n), .dentro = reservar(f.n), .retardo = reservar(f.n),
+        .reinicio = calloc(f.n, sizeof(bool)),
+    };
+    double horas = 0;
+    size_t k = 0;
+    for (int l = 0; l < n_logs; l++) {
+        if (inicio_log[l] == inicio_log[l + 1]) continue;
+        in.reinicio[inicio_log[l]] = true;
+        horas += (f.t[inicio_log[l + 1] - 1] - f.t[inicio_log[l]]) / 3600.0;
+        for (size_t i = inicio_log[l]; i < inicio_log[l + 1]; i++) {
+            double t = f.t[i];
+            // intervalo verdadero vigente (los logs vienen en orden temporal)
+            while (k < v.n && v.fin[k] + tolerancia < t) k++;
+            bool dentro = k < v.n && t >= v.ini[k] - tolerancia;
+            double retardo = dentro ? t - v.ini[k] : 0.0;
+            in.k[i] = (double)k;
+            in.dentro[i] = dentro ? 1.0 : 0.0;
+            in.retardo[i] = retardo < 0 ? 0 : retardo;
+        }
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    trabajo_t trabajo = { .b = &b, .in = &in };
+    pthread_mutex_init(&trabajo.mutex, NULL);
+    pthread_t *th = malloc(hilos * sizeof(pthread_t));
+    for (int i = 0; i < hilos; i++) pthread_create(&th[i], NULL, hilo_barrido, &trabajo);
+    for (int i = 0; i < hilos; i++) pthread_join(th[i], NULL);
+    free(th);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double seg = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    printf("fixes: %zu (%.1f h), excesos verdaderos: %zu, combinaciones: %zu\n", f.n, horas, v.n, b.n);
+    printf("barrido: %.3f s con %d hilos, %.1f M actualizaciones/s\n\n", seg, hilos, seg > 0 ? f.n * (double)b.n / seg / 1e6 : 0);
+
+    const char *cabecera = "umbral,umbral_mov,q,r,eventos,verdaderos,falsos,perdidos,falsos_por_hora,retardo_medio_s,retardo_max_s\n";
+    if (salida) {
+        FILE *fo = fopen(salida, "w");
+        if (fo == NULL) { perror(salida); return 1; }
+        fputs(cabecera, fo);
+        for (size_t j = 0; j < b.n; j++) imprimir(fo, &b, j, v.n, horas);
+        fclose(fo);
+    }
+
+    size_t *orden = malloc(b.n * sizeof(size_t));
+    for (size_t j = 0; j < b.n; j++) orden[j] = j;
+    b_orden = &b;
+    n_verdad_orden = v.n;
+    qsort(orden, b.n, sizeof(size_t), comparar_puntaje);
+    printf("mejores %zu:\n%s", mejores < b.n ? mejores : b.n, cabecera);
+    for (size_t j = 0; j < mejores && j < b.n; j++) imprimir(stdout, &b, orden[j], v.n, horas);
+
+    free(orden);
+    free(inicio_log);
+    return 0;
+}
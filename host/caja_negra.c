@@ -0,0 +1,304 @@
+// Caja negra del receptor (main/modules/caja_negra_codec.c) en host:
+//
+//   caja_negra extraer volcado.bin > crudo.nmea
+//       Reconstruye el flujo crudo desde un volcado de la partición "caja_negra"
+//       (parttool.py read_partition --partition-name caja_negra --output volcado.bin),
+//       en orden, byte a byte. Los huecos (bloques descartados o ilegibles) van a stderr.
+//
+//   caja_negra medir [-p MB=8] [-o imagen.bin] captura.nmea...
+//       Pasa capturas por el mismo camino que el firmware (lecturas de 127 bytes,
+//       bloques de CAJA_BLOQUE_CRUDO, compresión, partición circular en RAM de -p MB),
+//       reporta relación de compresión, costo por bloque, bytes por fix, MB por día a
+//       5 Hz RMC+GGA y días que entran en la partición, y verifica que la extracción
+//       devuelve exactamente lo último que entró.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "modules/caja_negra_codec.h"
+
+#define LECTURA_UART 127        // lo que entrega uart_read_bytes por vuelta en el firmware
+
+static caja_compresor_t compresor;
+
+// ===========================================================
+//  PARTICIÓN EN RAM
+// ===========================================================
+typedef struct {
+    uint8_t *datos;
+    size_t largo;
+} imagen_t;
+
+static bool ram_leer(void *ctx, uint32_t offset, void *dst, size_t len)
+{
+    imagen_t *im = ctx;
+    if (offset + len > im->largo) return false;
+    memcpy(dst, im->datos + offset, len);
+    return true;
+}
+
+static bool ram_escribir(void *ctx, uint32_t offset, const void *src, size_t len)
+{
+    imagen_t *im = ctx;
+    if (offset + len > im->largo) return false;
+    // como la flash NOR: solo se pueden bajar bits
+    const uint8_t *s = src;
+    for (size_t i = 0; i < len; i++) im->datos[offset + i] &= s[i];
+    return true;
+}
+
+static bool ram_borrar(void *ctx, uint32_t offset)
+{
+    imagen_t *im = ctx;
+    memset(im->datos + offset, 0xFF, CAJA_SECTOR);
+    return true;
+}
+
+static uint8_t *leer_archivo(const char *ruta, size_t *largo)
+{
+    FILE *f = fopen(ruta, "rb");
+    if (f == NULL) { perror(ruta); exit(1); }
+    fseek(f, 0, SEEK_END);
+    *largo = (size_t)ftell(f);
+    rewind(f);
+    uint8_t *d = malloc(*largo + 1);
+    if (d == NULL || fread(d, 1, *largo, f) != *largo) { perror(ruta); exit(1); }
+    fclose(f);
+    return d;
+}
+
+// ===========================================================
+//  EXTRACCIÓN
+// ===========================================================
+typedef struct {
+    uint32_t seq;
+    uint32_t indice;
+} sector_t;
+
+typedef struct {
+    FILE *salida;
+    uint64_t bytes;
+    uint32_t bloques;
+    uint32_t errores;
+    uint64_t perdidos;
+} extraccion_t;
+
+static int comparar_seq(const void *a, const void *b)
+{
+    int32_t d = (int32_t)(((const sector_t *)a)->seq - ((const sector_t *)b)->seq);
+    return (d > 0) - (d < 0);
+}
+
+static void extraer_bloque(void *ctx, const caja_bloque_t *b, const uint8_t *payload)
+{
+    extraccion_t *x = ctx;
+    static uint8_t crudo[CAJA_BLOQUE_CRUDO];
+
+    if (b->perdidos) {
+        fprintf(stderr, "hueco: %u bytes descartados en el equipo antes del bloque de t=%u ms (offset %llu)\n",
+                (unsigned)b->perdidos, (unsigned)b->t_ms, (unsigned long long)x->bytes);
+        x->perdidos += b->perdidos;
+    }
+    if (b->flags & CAJA_FLAG_COMPRIMIDO) {
+        if (!caja_descomprimir(&compresor, payload, b->largo, crudo, b->crudo)) {
+            fprintf(stderr, "bloque de t=%u ms ilegible (offset %llu)\n", (unsigned)b->t_ms, (unsigned long long)x->bytes);
+            x->errores++;
+            return;
+        }
+        payload = crudo;
+    }
+    if (x->salida) fwrite(payload, 1, b->crudo, x->salida);
+    x->bytes += b->crudo;
+    x->bloques++;
+}
+
+static void extraer_imagen(const uint8_t *datos, size_t largo, extraccion_t *x)
+{
+    size_t n = largo / CAJA_SECTOR;
+    sector_t *sectores = malloc(n * sizeof(sector_t));
+    size_t validos = 0;
+    for (size_t s = 0; s < n; s++) {
+        uint32_t seq;
+        if (caja_decodificar_sector(datos + s * CAJA_SECTOR, &seq, NULL, NULL, NULL) >= 0)
+            sectores[validos++] = (sector_t){ .seq = seq, .indice = (uint32_t)s };
+    }
+    qsort(sectores, validos, sizeof(sector_t), comparar_seq);
+
+    for (size_t i = 0; i < validos; i++) {
+        if (i > 0 && sectores[i].seq != sectores[i - 1].seq + 1)
+            fprintf(stderr, "hueco: faltan los sectores %u..%u\n", (unsigned)sectores[i - 1].seq + 1,
+                    (unsigned)sectores[i].seq - 1);
+        caja_decodificar_sector(datos + sectores[i].indice * CAJA_SECTOR, NULL, NULL, extraer_bloque, x);
+    }
+    fprintf(stderr, "%zu sectores, %u bloques, %llu bytes, %llu descartados en el equipo, %u ilegibles\n",
+            validos, (unsigned)x->bloques, (unsigned long long)x->bytes, (unsigned long long)x->perdidos,
+            (unsigned)x->errores);
+    free(sectores);
+}
+
+static int cmd_extraer(int argc, char **argv)
+{
+    if (argc < 1) {
+        fprintf(stderr, "uso: caja_negra extraer volcado.bin > crudo.nmea\n");
+        return 2;
+    }
+    size_t largo;
+    uint8_t *datos = leer_archivo(argv[0], &largo);
+    extraccion_t x = { .salida = stdout };
+    extraer_imagen(datos, largo, &x);
+    free(datos);
+    return x.errores ? 1 : 0;
+}
+
+// ===========================================================
+//  MEDICIÓN
+// ===========================================================
+static double ahora_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static size_t contar_fixes(const uint8_t *d, size_t n)
+{
+    size_t fixes = 0;
+    for (size_t i = 0; i + 6 <= n; i++)
+        if (d[i] == '$' && memcmp(d + i + 3, "RMC", 3) == 0) fixes++;
+    return fixes;
+}
+
+static int cmd_medir(int argc, char **argv)
+{
+    double mb = 8.0;
+    const char *ruta_imagen = NULL;
+    int opt;
+    optind = 1;
+    while ((opt = getopt(argc, argv, "p:o:")) != -1) {
+        switch (opt) {
+            case 'p': mb = atof(optarg); break;
+            case 'o': ruta_imagen = optarg; break;
+            default:
+                fprintf(stderr, "uso: caja_negra medir [-p MB=8] [-o imagen.bin] captura.nmea...\n");
+                return 2;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "uso: caja_negra medir [-p MB=8] [-o imagen.bin] captura.nmea...\n");
+        return 2;
+    }
+
+    // todas las capturas seguidas, como un único flujo del receptor
+    size_t total = 0;
+    uint8_t *flujo = NULL;
+    for (int i = optind; i < argc; i++) {
+        size_t largo;
+        uint8_t *d = leer_archivo(argv[i], &largo);
+        flujo = realloc(flujo, total + largo);
+        memcpy(flujo + total, d, largo);
+        total += largo;
+        free(d);
+    }
+
+    imagen_t im = { .largo = ((size_t)(mb * 1024 * 1024) / CAJA_SECTOR) * CAJA_SECTOR };
+    im.datos = malloc(im.largo);
+    memset(im.datos, 0xFF, im.largo);
+    caja_almacen_t almacen = {
+        .ctx = &im, .n_sectores = (uint32_t)(im.largo / CAJA_SECTOR),
+        .leer = ram_leer, .escribir = ram_escribir, .borrar_sector = ram_borrar,
+    };
+    caja_escritor_t escritor;
+    caja_escritor_init(&escritor, &almacen);
+
+    static uint8_t bloque[CAJA_BLOQUE_CRUDO];
+    static uint8_t registro[CAJA_CABECERA_BLOQUE + CAJA_BLOQUE_CRUDO];
+    size_t en_bloque = 0, crudos = 0, comprimidos = 0, bloques_crudos = 0;
+    double ns_compresion = 0, ns_peor = 0;
+
+    for (size_t pos = 0; pos < total || en_bloque > 0;) {
+        size_t n = total - pos < LECTURA_UART ? total - pos : LECTURA_UART;
+        // cada lectura del UART se reparte entre el bloque actual y el siguiente
+        while (n > 0) {
+            size_t c = CAJA_BLOQUE_CRUDO - en_bloque < n ? CAJA_BLOQUE_CRUDO - en_bloque : n;
+            memcpy(bloque + en_bloque, flujo + pos, c);
+            en_bloque += c;
+            pos += c;
+            n -= c;
+            if (en_bloque == CAJA_BLOQUE_CRUDO) break;
+        }
+        if (en_bloque < CAJA_BLOQUE_CRUDO && pos < total) continue;
+
+        double t0 = ahora_ns();
+        size_t largo = caja_comprimir(&compresor, bloque, en_bloque, registro + CAJA_CABECERA_BLOQUE, en_bloque);
+        double dt = ahora_ns() - t0;
+        ns_compresion += dt;
+        if (dt > ns_peor) ns_peor = dt;
+
+        caja_bloque_t b = { .crudo = (uint16_t)en_bloque, .t_ms = (uint32_t)(pos / 100) };
+        if (largo) {
+            b.flags = CAJA_FLAG_COMPRIMIDO;
+            b.largo = (uint16_t)largo;
+        } else {
+            memcpy(registro + CAJA_CABECERA_BLOQUE, bloque, en_bloque);
+            b.largo = (uint16_t)en_bloque;
+            bloques_crudos++;
+        }
+        if (!caja_escritor_agregar(&escritor, &b, registro)) {
+            fprintf(stderr, "error escribiendo la imagen\n");
+            return 1;
+        }
+        crudos += en_bloque;
+        comprimidos += b.largo;
+        en_bloque = 0;
+    }
+
+    size_t fixes = contar_fixes(flujo, total);
+    uint32_t bloques = escritor.bloques_escritos;
+    double bytes_flash = escritor.bytes_escritos;          // incluye cabeceras y sectores
+    double por_fix = fixes ? bytes_flash / fixes : 0;
+    double mb_dia = por_fix * 5 * 86400 / (1024.0 * 1024.0);
+
+    printf("%zu bytes crudos, %zu fixes, %u bloques (%zu guardados crudos)\n", crudos, fixes, (unsigned)bloques,
+           bloques_crudos);
+    printf("payload comprimido: %zu bytes (%.1fx); en flash con cabeceras: %.0f bytes (%.1fx)\n",
+           comprimidos, (double)crudos / comprimidos, bytes_flash, crudos / bytes_flash);
+    printf("compresión: %.1f µs/bloque (peor %.1f), %.0f MB/s en este host\n", ns_compresion / bloques / 1e3,
+           ns_peor / 1e3, crudos / (ns_compresion / 1e9) / 1e6);
+    printf("flash: %.1f bytes/fix, %u sectores borrados\n", por_fix, (unsigned)escritor.sectores_borrados);
+    if (fixes)
+        printf("a 5 Hz con este contenido: %.1f MB/día → %.1f días en %.1f MB\n", mb_dia, mb / mb_dia, mb);
+
+    // verificación: la extracción debe terminar exactamente en lo último que entró
+    extraccion_t x = { .salida = tmpfile() };
+    extraer_imagen(im.datos, im.largo, &x);
+    bool ok = x.errores == 0 && x.bytes <= total;
+    if (ok) {
+        uint8_t *rec = malloc(x.bytes ? x.bytes : 1);
+        rewind(x.salida);
+        ok = fread(rec, 1, x.bytes, x.salida) == x.bytes && memcmp(rec, flujo + total - x.bytes, x.bytes) == 0;
+        free(rec);
+    }
+    fclose(x.salida);
+    printf("extracción: %llu bytes (%s)\n", (unsigned long long)x.bytes, ok ? "idénticos al final del flujo" : "DIFIEREN");
+
+    if (ruta_imagen) {
+        FILE *f = fopen(ruta_imagen, "wb");
+        if (f == NULL || fwrite(im.datos, 1, im.largo, f) != im.largo) { perror(ruta_imagen); return 1; }
+        fclose(f);
+    }
+    free(im.datos);
+    free(flujo);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 2 && strcmp(argv[1], "extraer") == 0) return cmd_extraer(argc - 2, argv + 2);
+    if (argc >= 2 && strcmp(argv[1], "medir") == 0) return cmd_medir(argc - 1, argv + 1);
+    fprintf(stderr, "uso: caja_negra extraer volcado.bin > crudo.nmea\n"
+                    "     caja_negra medir [-p MB=8] [-o imagen.bin] captura.nmea...\n");
+    return 2;
+}
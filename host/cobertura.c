@@ -0,0 +1,384 @@
+// Mapa de cobertura (main/modules/cobertura_codec.c) en host:
+//
+//   cobertura simular [-c celda_m=50] [-p KB=256] [-t tiles_ram=8] [-m max_tiles=1024]
+//                     [-v vaciar_s=300] [-o imagen.bin] captura.nmea...
+//       Pasa los fixes RMC válidos por el mismo camino que el firmware (celda, tiles
+//       en RAM, registro en una partición en RAM de -p KB), reporta celdas, tiles
+//       densos/RLE, RAM, bytes escritos en flash y costo por fix, y verifica que la
+//       imagen resultante tenga exactamente las celdas recorridas.
+//
+//   cobertura exportar [-f geojson|pbm] imagen.bin > salida
+//       Exporta un volcado de la partición "cobertura"
+//       (parttool.py read_partition --partition-name cobertura --output imagen.bin):
+//       GeoJSON con un rectángulo por tramo de celdas contiguas de cada fila, o una
+//       imagen PBM (una celda por pixel, norte arriba).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "modules/nmea_parser.h"
+#include "modules/cobertura_codec.h"
+#include "modules/varint.h"
+
+// ===========================================================
+//  PARTICIÓN EN RAM
+// ===========================================================
+typedef struct {
+    uint8_t *datos;
+    size_t largo;
+} imagen_t;
+
+static bool ram_leer(void *ctx, uint32_t offset, void *dst, size_t len)
+{
+    imagen_t *im = ctx;
+    if (offset + len > im->largo) return false;
+    memcpy(dst, im->datos + offset, len);
+    return true;
+}
+
+static bool ram_escribir(void *ctx, uint32_t offset, const void *src, size_t len)
+{
+    imagen_t *im = ctx;
+    if (offset + len > im->largo) return false;
+    // como la flash NOR: solo se pueden bajar bits
+    const uint8_t *s = src;
+    for (size_t i = 0; i < len; i++) im->datos[offset + i] &= s[i];
+    return true;
+}
+
+static bool ram_borrar(void *ctx, uint32_t offset)
+{
+    imagen_t *im = ctx;
+    memset(im->datos + offset, 0xFF, COBERTURA_SECTOR);
+    return true;
+}
+
+static cobertura_almacen_t almacen_ram(imagen_t *im)
+{
+    return (cobertura_almacen_t){
+        .ctx = im, .n_sectores = (uint32_t)(im->largo / COBERTURA_SECTOR),
+        .leer = ram_leer, .escribir = ram_escribir, .borrar_sector = ram_borrar,
+    };
+}
+
+static double ahora_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// ===========================================================
+//  CONJUNTO DE CELDAS (referencia y exportación)
+// ===========================================================
+typedef struct {
+    uint64_t *v;
+    size_t n, cap;
+} celdas_t;
+
+static void agregar_celda(celdas_t *c, uint32_t x, uint32_t y)
+{
+    if (c->n == c->cap) {
+        c->cap = c->cap ? c->cap * 2 : 4096;
+        c->v = realloc(c->v, c->cap * sizeof(uint64_t));
+        if (c->v == NULL) { perror("realloc"); exit(1); }
+    }
+    c->v[c->n++] = ((uint64_t)y << 32) | x;
+}
+
+static int comparar_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+// Ordena por fila y columna y elimina repetidas
+static void normalizar(celdas_t *c)
+{
+    if (c->n == 0) return;
+    qsort(c->v, c->n, sizeof(uint64_t), comparar_u64);
+    size_t k = 1;
+    for (size_t i = 1; i < c->n; i++)
+        if (c->v[i] != c->v[k - 1]) c->v[k++] = c->v[i];
+    c->n = k;
+}
+
+// Todas las celdas marcadas en la imagen, según el índice que arma el firmware al arrancar
+static void celdas_de_imagen(cobertura_log_t *log, celdas_t *c, size_t *densos, size_t *bytes_tiles)
+{
+    static uint8_t bits[COBERTURA_TILE_BYTES];
+    static uint8_t tmp[COBERTURA_TILE_BYTES];
+    for (uint32_t i = 0; i < log->n_indice; i++) {
+        uint32_t clave = log->indice[i].clave;
+        if (!cobertura_log_cargar(log, clave, bits)) {
+            fprintf(stderr, "tile %08x ilegible\n", (unsigned)clave);
+            continue;
+        }
+        if (densos && bytes_tiles) {
+            uint8_t tipo;
+            *bytes_tiles += cobertura_codificar_tile(bits, tmp, &tipo) + COBERTURA_CABECERA_REGISTRO;
+            *densos += tipo == COBERTURA_TIPO_DENSO;
+        }
+        uint32_t x0 = (clave & 0xFFFF) * COBERTURA_TILE_LADO, y0 = (clave >> 16) * COBERTURA_TILE_LADO;
+        for (uint32_t b = 0; b < COBERTURA_TILE_BITS; b++)
+            if (bits[b >> 3] & (1 << (b & 7)))
+                agregar_celda(c, x0 + b % COBERTURA_TILE_LADO, y0 + b / COBERTURA_TILE_LADO);
+    }
+    normalizar(c);
+}
+
+// ===========================================================
+//  SIMULACIÓN
+// ===========================================================
+static uint32_t segundos_del_dia(const char *hora)
+{
+    if (strlen(hora) < 6) return 0;
+    return (uint32_t)(((hora[0] - '0') * 10 + hora[1] - '0') * 3600 +
+                      ((hora[2] - '0') * 10 + hora[3] - '0') * 60 +
+                      (hora[4] - '0') * 10 + hora[5] - '0');
+}
+
+static int cmd_simular(int argc, char **argv)
+{
+    int celda_m = 50, kb = 256, tiles_ram = 8, max_tiles = 1024, vaciar_s = 300;
+    const char *ruta_imagen = NULL;
+    int opt;
+    optind = 1;
+    while ((opt = getopt(argc, argv, "c:p:t:m:v:o:")) != -1) {
+        switch (opt) {
+            case 'c': celda_m = atoi(optarg); break;
+            case 'p': kb = atoi(optarg); break;
+            case 't': tiles_ram = atoi(optarg); break;
+            case 'm': max_tiles = atoi(optarg); break;
+            case 'v': vaciar_s = atoi(optarg); break;
+            case 'o': ruta_imagen = optarg; break;
+            default: optind = argc + 1;
+        }
+    }
+    if (optind >= argc || celda_m < COBERTURA_CELDA_MIN_M || celda_m > 65535 || kb < 8 || tiles_ram < 1 || tiles_ram > 255) {
+        fprintf(stderr, "uso: cobertura simular [-c celda_m=50] [-p KB=256] [-t tiles_ram=8] [-m max_tiles=1024] "
+                        "[-v vaciar_s=300] [-o imagen.bin] captura.nmea...\n"
+                        "     celda_m desde %d (la clave de tile tiene 16 bits por eje)\n", COBERTURA_CELDA_MIN_M);
+        return 2;
+    }
+
+    imagen_t im = { .largo = (size_t)kb * 1024 / COBERTURA_SECTOR * COBERTURA_SECTOR };
+    im.datos = malloc(im.largo);
+    memset(im.datos, 0xFF, im.largo);
+    cobertura_almacen_t almacen = almacen_ram(&im);
+
+    static cobertura_log_t log;
+    static cobertura_mapa_t mapa;
+    cobertura_indice_t *indice = calloc(max_tiles, sizeof(cobertura_indice_t));
+    cobertura_tile_t *tiles = calloc(tiles_ram, sizeof(cobertura_tile_t));
+    cobertura_log_init(&log, &almacen, (uint16_t)celda_m, indice, max_tiles);
+    cobertura_mapa_init(&mapa, &log, tiles, (uint8_t)tiles_ram);
+
+    celdas_t referencia = {0};
+    size_t fixes = 0, marcados = 0;
+    double ns = 0, ns_peor = 0;
+    uint32_t ultimo_vaciado = 0, t_anterior = 0, t = 0;
+    cobertura_celda_t anterior = { UINT32_MAX, UINT32_MAX };
+
+    for (int i = optind; i < argc; i++) {
+        FILE *f = fopen(argv[i], "r");
+        if (f == NULL) { perror(argv[i]); return 1; }
+        char linea[256];
+        gps_data_t gps = {0};
+        while (fgets(linea, sizeof(linea), f)) {
+            linea[strcspn(linea, "\r\n")] = 0;
+            if (strncmp(linea + 3, "RMC", 3) != 0 || !nmea_verify_checksum(linea)) continue;
+            if (!gps_parse_gprmc(linea, &gps) || !gps.valid) continue;
+            fixes++;
+
+            // reloj continuo a través de medianoche y entre capturas
+            uint32_t s = segundos_del_dia(gps.time);
+            t += (s >= t_anterior) ? s - t_anterior : s + 86400 - t_anterior;
+            if (fixes == 1) t = 0;
+            t_anterior = s;
+
+            // como en el firmware: el lector solo encola cuando cambia la celda
+            cobertura_celda_t c;
+            if (!cobertura_celda(gps.latitude, gps.longitude, (uint16_t)celda_m, &c)) continue;
+            if (c.x == anterior.x && c.y == anterior.y) continue;
+            anterior = c;
+            agregar_celda(&referencia, c.x, c.y);
+
+            double t0 = ahora_ns();
+            cobertura_marcar(&mapa, &c);
+            double dt = ahora_ns() - t0;
+            ns += dt;
+            if (dt > ns_peor) ns_peor = dt;
+            marcados++;
+
+            if (t - ultimo_vaciado >= (uint32_t)vaciar_s) {
+                cobertura_vaciar(&mapa);
+                ultimo_vaciado = t;
+            }
+        }
+        fclose(f);
+    }
+    cobertura_vaciar(&mapa);
+    normalizar(&referencia);
+
+    size_t ram = tiles_ram * sizeof(cobertura_tile_t) + max_tiles * sizeof(cobertura_indice_t) + sizeof(log);
+    printf("%zu fixes, %zu cambios de celda, %zu celdas distintas de %d m (%.2f km²)\n", fixes, marcados,
+           referencia.n, celda_m, referencia.n * (double)celda_m * celda_m / 1e6);
+    printf("marcar: %.0f ns/cambio de celda (peor %.0f ns, incluye cargas y desalojos)\n",
+           marcados ? ns / marcados : 0.0, ns_peor);
+    printf("RAM: %d tiles × %zu B + índice %d × %zu B + registro %zu B = %zu B\n", tiles_ram,
+           sizeof(cobertura_tile_t), max_tiles, sizeof(cobertura_indice_t), sizeof(log), ram);
+    printf("mapa: %u cargas desde flash, %u desalojos, %u errores\n",
+           (unsigned)mapa.cargas, (unsigned)mapa.desalojos, (unsigned)mapa.errores);
+    printf("flash: %u registros (%u copiados al recolectar), %u bytes escritos, %u sectores borrados%s\n",
+           (unsigned)log.registros_escritos, (unsigned)log.registros_copiados,
+           (unsigned)log.bytes_escritos, (unsigned)log.sectores_borrados,
+           log.lleno ? ", PARTICIÓN LLENA" : "");
+
+    // lo que vería el firmware al arrancar de nuevo
+    static cobertura_log_t relectura;
+    cobertura_indice_t *indice2 = calloc(max_tiles, sizeof(cobertura_indice_t));
+    if (!cobertura_log_init(&relectura, &almacen, (uint16_t)celda_m, indice2, max_tiles)) {
+        fprintf(stderr, "la imagen no es de %d m\n", celda_m);
+        return 1;
+    }
+    celdas_t leidas = {0};
+    size_t densos = 0, bytes_tiles = 0;
+    celdas_de_imagen(&relectura, &leidas, &densos, &bytes_tiles);
+    printf("vigente: %u tiles (%zu densos, %zu RLE), %zu bytes (%.1f B/celda; denso serían %u B/tile)\n",
+           (unsigned)relectura.n_indice, densos, relectura.n_indice - densos, bytes_tiles,
+           leidas.n ? (double)bytes_tiles / leidas.n : 0.0, (unsigned)COBERTURA_REGISTRO_MAX);
+    printf("partición: %u sectores, %u en uso\n", almacen.n_sectores, (unsigned)relectura.usados);
+
+    bool iguales = leidas.n == referencia.n && memcmp(leidas.v, referencia.v, leidas.n * sizeof(uint64_t)) == 0;
+    printf("verificación: %zu celdas en la imagen, %s\n", leidas.n, iguales ? "idénticas a las recorridas" : "DIFIEREN");
+
+    if (ruta_imagen) {
+        FILE *f = fopen(ruta_imagen, "wb");
+        if (f == NULL || fwrite(im.datos, 1, im.largo, f) != im.largo) { perror(ruta_imagen); return 1; }
+        fclose(f);
+    }
+    return iguales ? 0 : 1;
+}
+
+// ===========================================================
+//  EXPORTACIÓN
+// ===========================================================
+// celda_m del sector más reciente
+static bool celda_de_imagen(const imagen_t *im, uint16_t *celda_m)
+{
+    bool hay = false;
+    uint32_t mejor = 0;
+    for (size_t s = 0; s + COBERTURA_SECTOR <= im->largo; s += COBERTURA_SECTOR) {
+        const uint8_t *cab = im->datos + s;
+        if (get_u32(cab) != COBERTURA_MAGIC || get_u16(cab + 10) != crc16_ccitt(cab, 10)) continue;
+        uint32_t seq = get_u32(cab + 4);
+        if (!hay || (int32_t)(seq - mejor) > 0) {
+            hay = true;
+            mejor = seq;
+            *celda_m = get_u16(cab + 8);
+        }
+    }
+    return hay;
+}
+
+static void exportar_geojson(const celdas_t *c, uint16_t celda_m)
+{
+    printf("{\"type\":\"FeatureCollection\",\"properties\":{\"celda_m\":%u,\"celdas\":%zu},\"features\":[",
+           celda_m, c->n);
+    bool primero = true;
+    for (size_t i = 0; i < c->n;) {
+        // tramo de celdas contiguas en la misma fila → un rectángulo
+        size_t j = i + 1;
+        while (j < c->n && c->v[j] == c->v[j - 1] + 1 && (c->v[j] >> 32) == (c->v[i] >> 32)) j++;
+        cobertura_celda_t a = { (uint32_t)c->v[i], (uint32_t)(c->v[i] >> 32) };
+        cobertura_celda_t b = { (uint32_t)c->v[j - 1], a.y };
+        double la0, la1, lo0, lo1, lb0, lb1, ob0, ob1;
+        cobertura_celda_limites(&a, celda_m, &la0, &la1, &lo0, &lo1);
+        cobertura_celda_limites(&b, celda_m, &lb0, &lb1, &ob0, &ob1);
+        printf("%s\n{\"type\":\"Feature\",\"properties\":{\"celdas\":%zu},\"geometry\":{\"type\":\"Polygon\","
+               "\"coordinates\":[[[%.7f,%.7f],[%.7f,%.7f],[%.7f,%.7f],[%.7f,%.7f],[%.7f,%.7f]]]}}",
+               primero ? "" : ",", j - i, lo0, la0, ob1, la0, ob1, la1, lo0, la1, lo0, la0);
+        primero = false;
+        i = j;
+    }
+    printf("\n]}\n");
+}
+
+static void exportar_pbm(const celdas_t *c)
+{
+    uint32_t x0 = UINT32_MAX, x1 = 0, y0 = UINT32_MAX, y1 = 0;
+    for (size_t i = 0; i < c->n; i++) {
+        uint32_t x = (uint32_t)c->v[i], y = (uint32_t)(c->v[i] >> 32);
+        if (x < x0) x0 = x;
+        if (x > x1) x1 = x;
+        if (y < y0) y0 = y;
+        if (y > y1) y1 = y;
+    }
+    if (c->n == 0) x0 = x1 = y0 = y1 = 0;
+    uint32_t ancho = x1 - x0 + 1, alto = y1 - y0 + 1;
+    size_t por_fila = (ancho + 7) / 8;
+    uint8_t *img = calloc(alto, por_fila);
+    for (size_t i = 0; i < c->n; i++) {
+        uint32_t x = (uint32_t)c->v[i] - x0, y = y1 - (uint32_t)(c->v[i] >> 32);
+        img[y * por_fila + x / 8] |= (uint8_t)(0x80 >> (x % 8));
+    }
+    printf("P4\n# cobertura: columnas %u..%u, filas %u..%u\n%u %u\n", x0, x1, y0, y1, ancho, alto);
+    fwrite(img, por_fila, alto, stdout);
+    free(img);
+}
+
+static int cmd_exportar(int argc, char **argv)
+{
+    const char *formato = "geojson";
+    int opt;
+    optind = 1;
+    while ((opt = getopt(argc, argv, "f:")) != -1) {
+        if (opt == 'f') formato = optarg;
+        else optind = argc + 1;
+    }
+    if (optind != argc - 1 || (strcmp(formato, "geojson") != 0 && strcmp(formato, "pbm") != 0)) {
+        fprintf(stderr, "uso: cobertura exportar [-f geojson|pbm] imagen.bin > salida\n");
+        return 2;
+    }
+
+    FILE *f = fopen(argv[optind], "rb");
+    if (f == NULL) { perror(argv[optind]); return 1; }
+    fseek(f, 0, SEEK_END);
+    imagen_t im = { .largo = (size_t)ftell(f) / COBERTURA_SECTOR * COBERTURA_SECTOR };
+    rewind(f);
+    im.datos = malloc(im.largo ? im.largo : 1);
+    if (fread(im.datos, 1, im.largo, f) != im.largo) { perror(argv[optind]); return 1; }
+    fclose(f);
+
+    uint16_t celda_m;
+    if (!celda_de_imagen(&im, &celda_m)) {
+        fprintf(stderr, "%s: no hay sectores de cobertura\n", argv[optind]);
+        return 1;
+    }
+    // el índice nunca supera un tile por registro que entra en la partición
+    cobertura_almacen_t almacen = almacen_ram(&im);
+    uint32_t max = (uint32_t)(im.largo / (COBERTURA_CABECERA_REGISTRO + 1)) + 1;
+    static cobertura_log_t log;
+    cobertura_log_init(&log, &almacen, celda_m, calloc(max, sizeof(cobertura_indice_t)), max);
+
+    celdas_t c = {0};
+    celdas_de_imagen(&log, &c, NULL, NULL);
+    fprintf(stderr, "%u tiles, %zu celdas de %u m\n", (unsigned)log.n_indice, c.n, celda_m);
+    if (strcmp(formato, "pbm") == 0) exportar_pbm(&c);
+    else exportar_geojson(&c, celda_m);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 2 && strcmp(argv[1], "simular") == 0) return cmd_simular(argc - 1, argv + 1);
+    if (argc >= 2 && strcmp(argv[1], "exportar") == 0) return cmd_exportar(argc - 1, argv + 1);
+    fprintf(stderr, "uso: cobertura simular [-c celda_m] [-p KB] [-t tiles_ram] [-m max_tiles] [-v vaciar_s] "
+                    "[-o imagen.bin] captura.nmea...\n"
+                    "     cobertura exportar [-f geojson|pbm] imagen.bin > salida\n");
+    return 2;
+}
@@ -0,0 +1,311 @@
+// Compara los dos backends del receptor GNSS sobre capturas grabadas: bytes por fix
+// y costo de decodificación por fix (ciclos del TSC en x86, ns en otras
+// arquitecturas) con los mismos módulos que el firmware:
+//   L80-R:  nmea_acumular + checksum + RMC/GGA (lo que hace procesar_sentencia_nmea)
+//   u-blox: framer UBX con Fletcher + NAV-PVT (lo que hace gps_ubx.c)
+// Los bytes se entregan en lecturas de -b bytes, como el UART en task_gps_read_and_parse.
+//
+//   comparar_receptores [-r repeticiones] [-b bloque] captura.nmea [captura.ubx]
+//   comparar_receptores -g salida.ubx captura.nmea
+//
+// Sin captura UBX se arma en memoria un NAV-PVT por cada RMC de la captura NMEA
+// (misma trayectoria) y se verifica además que los dos backends dejan el mismo
+// registro de fix. -g guarda esa captura UBX sintética.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "modules/nmea_parser.h"
+#include "modules/ubx_parser.h"
+
+#define BLOQUE_UART 127     // rx_temp de task_gps_read_and_parse
+
+// ===========================================================
+//  RELOJ
+// ===========================================================
+#if defined(__x86_64__) || defined(__i386__)
+#define UNIDAD "ciclos"
+static inline uint64_t reloj(void) { return __rdtsc(); }
+#else
+#define UNIDAD "ns"
+static inline uint64_t reloj(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+#endif
+
+// ===========================================================
+//  REGISTROS DECODIFICADOS
+// ===========================================================
+typedef struct {
+    gps_data_t gps;
+    gps_quality_t q;
+} registro_t;
+
+typedef struct {
+    gps_data_t gps;         // registro de fix como el del front end
+    gps_quality_t q;
+    uint32_t tramas;        // líneas o tramas UBX recibidas
+    uint32_t soluciones;    // RMC / NAV-PVT decodificados
+    uint32_t validos;
+    registro_t *r;          // copia de cada solución (solo si guardar)
+    size_t n, cap;
+    bool guardar;
+} decodificado_t;
+
+static void guardar(decodificado_t *d)
+{
+    d->soluciones++;
+    d->validos += d->gps.valid;
+    if (!d->guardar) return;
+    if (d->n == d->cap) {
+        d->cap = d->cap ? d->cap * 2 : 4096;
+        d->r = realloc(d->r, d->cap * sizeof(registro_t));
+        if (d->r == NULL) { perror("realloc"); exit(1); }
+    }
+    d->r[d->n++] = (registro_t){ d->gps, d->q };
+}
+
+// Los registros guardados sobreviven a las pasadas que solo miden
+static void reiniciar(decodificado_t *d, bool guardar_registros)
+{
+    registro_t *r = d->r;
+    size_t n = guardar_registros ? 0 : d->n, cap = d->cap;
+    memset(d, 0, sizeof(*d));
+    d->r = r;
+    d->n = n;
+    d->cap = cap;
+    d->guardar = guardar_registros;
+}
+
+// ===========================================================
+//  BACKEND L80-R (NMEA)
+// ===========================================================
+static void por_linea(char *linea, void *ctx)
+{
+    decodificado_t *d = ctx;
+    d->tramas++;
+    if (!nmea_verify_checksum(linea)) return;
+    if (strncmp(linea, "$GPGGA", 6) == 0) {
+        gps_parse_gpgga(linea, &d->q);
+        return;
+    }
+    if (strncmp(linea, "$GPRMC", 6) == 0 && gps_parse_gprmc(linea, &d->gps)) guardar(d);
+}
+
+static void decodificar_nmea(const uint8_t *datos, size_t largo, size_t bloque, decodificado_t *d)
+{
+    static nmea_acumulador_t acc;
+    acc.largo = 0;
+    for (size_t i = 0; i < largo; i += bloque)
+        nmea_acumular(&acc, datos + i, largo - i < bloque ? largo - i : bloque, por_linea, d);
+}
+
+// ===========================================================
+//  BACKEND U-BLOX (UBX)
+// ===========================================================
+static void decodificar_ubx(const uint8_t *datos, size_t largo, size_t bloque, decodificado_t *d)
+{
+    ubx_framer_t f;
+    ubx_framer_init(&f);
+    for (size_t i = 0; i < largo; i += bloque) {
+        const uint8_t *p = datos + i;
+        size_t resta = largo - i < bloque ? largo - i : bloque;
+        while (resta > 0) {
+            size_t usados;
+            ubx_resultado_t r = ubx_framer_alimentar(&f, p, resta, &usados);
+            p += usados;
+            resta -= usados;
+            if (r == UBX_SIN_TRAMA) continue;
+            d->tramas++;
+            if (r == UBX_TRAMA_OK && f.clase == UBX_CLASE_NAV && f.id == UBX_ID_NAV_PVT &&
+                ubx_nav_pvt_a_fix(f.payload, f.largo, &d->gps, &d->q))
+                guardar(d);
+        }
+    }
+}
+
+// ===========================================================
+//  CAPTURA UBX EQUIVALENTE A UNA NMEA
+// ===========================================================
+static int digitos(const char *p, int n)
+{
+    int v = 0;
+    for (int i = 0; i < n; i++) v = v * 10 + (p[i] - '0');
+    return v;
+}
+
+static uint32_t ms_del_dia(const char *hora)
+{
+    if (strlen(hora) < 6) return 0;
+    return (uint32_t)((digitos(hora, 2) * 3600 + digitos(hora + 2, 2) * 60 + digitos(hora + 4, 2)) * 1000 +
+                      (hora[6] == '.' ? lround(atof(hora + 6) * 1000.0) : 0));
+}
+
+static size_t nav_pvt_desde_registro(const registro_t *r, uint8_t *salida)
+{
+    ubx_nav_pvt_t p = {0};
+    uint32_t ms = ms_del_dia(r->gps.time);
+    p.hora = ms / 3600000;
+    p.min = ms / 60000 % 60;
+    p.seg = ms / 1000 % 60;
+    p.nano = (int32_t)(ms % 1000) * 1000000;
+    if (strlen(r->gps.date) >= 6) {
+        p.dia = digitos(r->gps.date, 2);
+        p.mes = digitos(r->gps.date + 2, 2);
+        p.anio = 2000 + digitos(r->gps.date + 4, 2);
+        p.validez = 0x03;
+    }
+    p.tipo_fix = r->gps.valid ? 3 : 0;
+    p.flags = r->gps.valid ? UBX_PVT_FLAG_FIX_OK : 0;
+    p.satelites = r->q.satellites;
+    p.lat_e7 = lround(r->gps.latitude * 1e7);
+    p.lon_e7 = lround(r->gps.longitude * 1e7);
+    p.h_msl_mm = lround(r->q.altitude * 1000.0);
+    p.altura_mm = p.h_msl_mm;
+    p.vel_suelo_mms = lround(r->gps.speed_kmh / 0.0036);
+    p.rumbo_e5 = lround(r->gps.course_deg * 1e5);
+    p.pdop_cent = lround(r->q.hdop * 100.0);
+    return ubx_armar_trama(UBX_CLASE_NAV, UBX_ID_NAV_PVT, &p, sizeof(p), salida);
+}
+
+// ===========================================================
+//  UTILIDADES
+// ===========================================================
+static uint8_t *leer_archivo(const char *ruta, size_t *largo)
+{
+    FILE *f = fopen(ruta, "rb");
+    if (f == NULL) { perror(ruta); exit(1); }
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *datos = malloc(n > 0 ? n : 1);
+    if (datos == NULL || fread(datos, 1, n, f) != (size_t)n) { perror(ruta); exit(1); }
+    fclose(f);
+    *largo = n;
+    return datos;
+}
+
+typedef void (*decodificador_t)(const uint8_t *, size_t, size_t, decodificado_t *);
+
+// Mejor tiempo de varias pasadas (la primera guarda los registros)
+static uint64_t medir(decodificador_t dec, const uint8_t *datos, size_t largo, size_t bloque,
+                      int repeticiones, decodificado_t *d)
+{
+    uint64_t mejor = UINT64_MAX;
+    for (int r = 0; r < repeticiones; r++) {
+        reiniciar(d, r == 0);
+        uint64_t t0 = reloj();
+        dec(datos, largo, bloque, d);
+        uint64_t t = reloj() - t0;
+        if (t < mejor) mejor = t;
+    }
+    return mejor;
+}
+
+static void reportar(const char *nombre, size_t bytes, const decodificado_t *d, uint64_t costo)
+{
+    double fixes = d->validos ? d->validos : 1;
+    printf("%-12s %10zu %8u %8u %10.1f %10.2f %12.0f %12.2f\n", nombre, bytes, d->tramas, d->validos,
+           bytes / fixes, d->tramas / fixes, costo / fixes, bytes ? (double)costo / bytes : 0.0);
+}
+
+// Mismo registro de fix desde los dos backends (captura UBX sintética)
+static void verificar(const decodificado_t *a, const decodificado_t *b)
+{
+    size_t n = a->n < b->n ? a->n : b->n;
+    size_t distintos = 0, fuera_de_rango = 0;
+    double d_pos = 0, d_vel = 0, d_rumbo = 0, d_alt = 0;
+    uint32_t d_ms = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const registro_t *x = &a->r[i], *y = &b->r[i];
+        if (x->gps.valid != y->gps.valid) { distintos++; continue; }
+        if (!x->gps.valid) continue;
+        // RMC truncadas dejan en el registro coordenadas que NAV-PVT no representa
+        if (fabs(x->gps.latitude) > 90 || fabs(x->gps.longitude) > 180) { fuera_de_rango++; continue; }
+        d_pos = fmax(d_pos, fmax(fabs(x->gps.latitude - y->gps.latitude), fabs(x->gps.longitude - y->gps.longitude)));
+        d_vel = fmax(d_vel, fabs(x->gps.speed_kmh - y->gps.speed_kmh));
+        d_rumbo = fmax(d_rumbo, fabs(x->gps.course_deg - y->gps.course_deg));
+        d_alt = fmax(d_alt, fabs(x->q.altitude - y->q.altitude));
+        uint32_t mx = ms_del_dia(x->gps.time), my = ms_del_dia(y->gps.time);
+        uint32_t dm = mx > my ? mx - my : my - mx;
+        if (dm > d_ms) d_ms = dm;
+        if (strcmp(x->gps.date, y->gps.date) != 0) distintos++;
+    }
+    printf("\nregistro de fix NMEA vs UBX: %zu soluciones (%zu / %zu), %zu distintas\n",
+           n, a->n, b->n, distintos + (a->n > b->n ? a->n - b->n : b->n - a->n));
+    if (fuera_de_rango) printf("  %zu con coordenadas fuera de rango (no comparadas)\n", fuera_de_rango);
+    printf("  diferencia máxima: posición %.1e°, velocidad %.4f km/h, rumbo %.5f°, altitud %.3f m, hora %u ms\n",
+           d_pos, d_vel, d_rumbo, d_alt, d_ms);
+}
+
+// ===========================================================
+//  MAIN
+// ===========================================================
+int main(int argc, char **argv)
+{
+    int repeticiones = 20;
+    size_t bloque = BLOQUE_UART;
+    const char *generar = NULL;
+    const char *capturas[2] = {0};
+    int n_capturas = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-r") && i + 1 < argc) repeticiones = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-b") && i + 1 < argc) bloque = (size_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-g") && i + 1 < argc) generar = argv[++i];
+        else if (argv[i][0] != '-' && n_capturas < 2) capturas[n_capturas++] = argv[i];
+        else n_capturas = -1;
+    }
+    if (n_capturas < 1 || repeticiones < 1 || bloque < 1) {
+        fprintf(stderr, "uso: %s [-r repeticiones] [-b bloque] captura.nmea [captura.ubx]\n"
+                        "     %s -g salida.ubx captura.nmea\n", argv[0], argv[0]);
+        return 2;
+    }
+
+    size_t largo_nmea;
+    uint8_t *nmea = leer_archivo(capturas[0], &largo_nmea);
+    decodificado_t dn = {0}, du = {0};
+    uint64_t costo_nmea = medir(decodificar_nmea, nmea, largo_nmea, bloque, repeticiones, &dn);
+
+    size_t largo_ubx = 0;
+    uint8_t *ubx;
+    bool sintetica = n_capturas < 2;
+    if (sintetica) {
+        ubx = malloc(dn.n * (UBX_LARGO_NAV_PVT + UBX_SOBRECARGA) + 1);
+        for (size_t i = 0; i < dn.n; i++) largo_ubx += nav_pvt_desde_registro(&dn.r[i], ubx + largo_ubx);
+        if (generar) {
+            FILE *f = fopen(generar, "wb");
+            if (f == NULL || fwrite(ubx, 1, largo_ubx, f) != largo_ubx) { perror(generar); return 1; }
+            fclose(f);
+            fprintf(stderr, "%zu NAV-PVT (%zu bytes) → %s\n", dn.n, largo_ubx, generar);
+            return 0;
+        }
+    } else {
+        ubx = leer_archivo(capturas[1], &largo_ubx);
+    }
+    uint64_t costo_ubx = medir(decodificar_ubx, ubx, largo_ubx, bloque, repeticiones, &du);
+
+    printf("lecturas de %zu bytes, mejor de %d pasadas, costo en %s%s\n\n",
+           bloque, repeticiones, UNIDAD, sintetica ? ", UBX generado desde la captura NMEA" : "");
+    printf("%-12s %10s %8s %8s %10s %10s %12s %12s\n",
+           "receptor", "bytes", "tramas", "fixes", "bytes/fix", "tramas/fix", UNIDAD "/fix", UNIDAD "/byte");
+    reportar("L80-R NMEA", largo_nmea, &dn, costo_nmea);
+    reportar("u-blox UBX", largo_ubx, &du, costo_ubx);
+    if (sintetica) verificar(&dn, &du);
+
+    free(dn.r);
+    free(du.r);
+    free(nmea);
+    free(ubx);
+    return 0;
+}
@@ -0,0 +1,251 @@
+// Compila un archivo de reglas (main/modules/reglas.h) a la tabla binaria que se
+// graba en la partición "reglas", y opcionalmente la evalúa sobre capturas NMEA:
+// eventos por regla y costo de la pasada por fix.
+//
+//   compilar_reglas [-u huso_min] [-o tabla.bin] reglas.txt
+//   compilar_reglas [-s n_sinteticas] [-r repeticiones] [-m umbral_movimiento_kmh]
+//                   [-k] [-Q q] [-R r] reglas.txt captura.nmea...
+//
+// -s agrega reglas sintéticas variadas (umbrales, duraciones, franjas, aceleración)
+// hasta completar n, para medir el costo con decenas de reglas activas.
+//
+// La velocidad que llega a reglas_evaluar es la de gnss_publicar_fix: Kalman (-k,
+// con Q/R del sdkconfig o -Q/-R) y luego el umbral de movimiento, igual que en
+// auditor_nmea. Cada captura es un arranque (Kalman desde cero).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "modules/nmea_parser.h"
+#include "modules/reglas.h"
+
+typedef struct {
+    float vel;
+    uint32_t t_ms;
+    uint16_t minuto_utc;
+} fix_t;
+
+static fix_t *fixes = NULL;
+static size_t n_fixes = 0, cap_fixes = 0;
+
+// Filtrado de gnss_publicar_fix
+static struct {
+    bool kalman;
+    double q, r;
+    double umbral_movimiento;
+} filtro = {
+    .kalman = false,
+    .q = CONFIG_GPS_KALMAN_Q_MILI / 1000.0,
+    .r = CONFIG_GPS_KALMAN_R_MILI / 1000.0,
+    .umbral_movimiento = CONFIG_GPS_UMBRAL_MOVIMIENTO_KMH,
+};
+
+// ===========================================================
+//  LECTURA
+// ===========================================================
+static char *leer_archivo(const char *ruta)
+{
+    FILE *f = fopen(ruta, "rb");
+    if (f == NULL) { perror(ruta); exit(1); }
+    fseek(f, 0, SEEK_END);
+    long largo = ftell(f);
+    rewind(f);
+    char *texto = malloc(largo + 1);
+    if (texto == NULL || fread(texto, 1, largo, f) != (size_t)largo) { perror(ruta); exit(1); }
+    texto[largo] = '\0';
+    fclose(f);
+    return texto;
+}
+
+static void leer_captura(const char *ruta)
+{
+    FILE *f = fopen(ruta, "r");
+    if (f == NULL) { perror(ruta); exit(1); }
+
+    char linea[256];
+    gps_data_t gps = {0};
+    uint32_t ultimo = 0, dias = 0;
+    kalman_t kf;
+    bool kalman_listo = false;
+
+    while (fgets(linea, sizeof(linea), f)) {
+        linea[strcspn(linea, "\r\n")] = 0;
+        if (strncmp(linea + 3, "RMC", 3) != 0 || !nmea_verify_checksum(linea)) continue;
+        if (!gps_parse_gprmc(linea, &gps) || !gps.valid) continue;
+
+        // sobre el mismo registro, como el firmware: una RMC sin velocidad arrastra la filtrada
+        if (filtro.kalman) {
+            if (!kalman_listo) {
+                kalman_init(&kf, filtro.q, filtro.r);
+                kf.estimate = gps.speed_kmh;
+                kalman_listo = true;
+            }
+            gps.speed_kmh = kalman_update(&kf, gps.speed_kmh);
+        }
+        if (gps.speed_kmh < filtro.umbral_movimiento) gps.speed_kmh = 0.0;
+        if (strlen(gps.time) < 6) continue;
+
+        uint32_t t = (uint32_t)(((gps.time[0] - '0') * 10 + gps.time[1] - '0') * 3600000 +
+                                ((gps.time[2] - '0') * 10 + gps.time[3] - '0') * 60000 +
+                                lround(atof(gps.time + 4) * 1000.0));
+        if (t < ultimo) dias++;             // cruce de medianoche
+        ultimo = t;
+
+        if (n_fixes == cap_fixes) {
+            cap_fixes = cap_fixes ? cap_fixes * 2 : 4096;
+            fixes = realloc(fixes, cap_fixes * sizeof(fix_t));
+            if (fixes == NULL) { perror("realloc"); exit(1); }
+        }
+        fixes[n_fixes++] = (fix_t){
+            .vel = (float)gps.speed_kmh,
+            .t_ms = t + dias * 86400000u,
+            .minuto_utc = (uint16_t)(t / 60000),
+        };
+    }
+    fclose(f);
+}
+
+// ===========================================================
+//  REGLAS SINTÉTICAS
+// ===========================================================
+static void completar_sinteticas(reglas_tabla_t *t, int n)
+{
+    char texto[REGLAS_MAX * 96] = "";
+    size_t pos = 0;
+    for (int i = t->n; i < n && i < REGLAS_MAX; i++) {
+        char regla[160];
+        switch (i % 4) {
+            case 0: snprintf(regla, sizeof(regla), "s%d: vel > %d durante %d histeresis 2", i, 20 + i * 3, i % 3 * 5); break;
+            case 1: snprintf(regla, sizeof(regla), "s%d: acel > %d alerta largo", i, 6 + i % 5); break;
+            case 2: snprintf(regla, sizeof(regla), "s%d: vel > %d franja %02d:00-%02d:30", i, 30 + i, i % 24, (i + 6) % 24); break;
+            default: snprintf(regla, sizeof(regla), "s%d: vel < %d durante %d alerta ninguna", i, 2 + i % 4, 60 + i); break;
+        }
+        pos += snprintf(texto + pos, sizeof(texto) - pos, "%s\n", regla);
+    }
+
+    // recompilar lo existente junto con las sintéticas conserva el CRC coherente
+    char base[REGLAS_MAX * 128] = "";
+    size_t b = snprintf(base, sizeof(base), "huso %d\n", t->huso_min);
+    for (int i = 0; i < t->n; i++) {
+        b += reglas_describir(t, i, base + b, sizeof(base) - b);
+        b += snprintf(base + b, sizeof(base) - b, "\n");
+    }
+    snprintf(base + b, sizeof(base) - b, "%s", texto);
+
+    char error[128];
+    if (reglas_compilar(base, t->huso_min, t, error, sizeof(error)) != 0) {
+        fprintf(stderr, "reglas sintéticas: %s\n", error);
+        exit(1);
+    }
+}
+
+// ===========================================================
+//  EVALUACIÓN
+// ===========================================================
+static double ahora_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint32_t pasada(const reglas_tabla_t *t, reglas_estado_t *e)
+{
+    uint32_t eventos = 0;
+    reglas_estado_init(e);
+    for (size_t i = 0; i < n_fixes; i++) {
+        reglas_entrada_t in = {
+            .vel_kmh = fixes[i].vel,
+            .t_ms = fixes[i].t_ms,
+            .minuto_dia = (uint16_t)((fixes[i].minuto_utc + t->huso_min + 2 * 1440) % 1440),
+        };
+        eventos |= reglas_evaluar(t, e, &in);
+    }
+    return eventos;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "uso: %s [-u huso_min] [-o tabla.bin] [-s n_sinteticas] [-r repeticiones]\n"
+            "          [-m umbral_movimiento_kmh] [-k] [-Q q] [-R r] reglas.txt [captura.nmea...]\n",
+            prog);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    int huso = -240, sinteticas = 0, repeticiones = 20;
+    const char *salida = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "u:o:s:r:m:kQ:R:")) != -1) {
+        switch (opt) {
+            case 'u': huso = atoi(optarg); break;
+            case 'o': salida = optarg; break;
+            case 's': sinteticas = atoi(optarg); break;
+            case 'r': repeticiones = atoi(optarg); break;
+            case 'm': filtro.umbral_movimiento = atof(optarg); break;
+            case 'k': filtro.kalman = true; break;
+            case 'Q': filtro.q = atof(optarg); break;
+            case 'R': filtro.r = atof(optarg); break;
+            default: usage(argv[0]);
+        }
+    }
+    if (optind >= argc) usage(argv[0]);
+
+    static reglas_tabla_t tabla;
+    char error[128];
+    char *texto = leer_archivo(argv[optind]);
+    if (reglas_compilar(texto, (int16_t)huso, &tabla, error, sizeof(error)) != 0) {
+        fprintf(stderr, "%s: %s\n", argv[optind], error);
+        return 1;
+    }
+    free(texto);
+    if (sinteticas > tabla.n) completar_sinteticas(&tabla, sinteticas);
+
+    printf("%d reglas, huso %+d min, tabla de %zu bytes (crc %08x)\n",
+           tabla.n, tabla.huso_min, sizeof(tabla), (unsigned)tabla.crc);
+    for (int i = 0; i < tabla.n; i++) {
+        char desc[160];
+        reglas_describir(&tabla, i, desc, sizeof(desc));
+        printf("  %2d  %s\n", i, desc);
+    }
+
+    if (salida) {
+        FILE *f = fopen(salida, "wb");
+        if (f == NULL || fwrite(&tabla, sizeof(tabla), 1, f) != 1) { perror(salida); return 1; }
+        fclose(f);
+        printf("tabla escrita en %s\n", salida);
+    }
+
+    for (int i = optind + 1; i < argc; i++) leer_captura(argv[i]);
+    if (n_fixes == 0) return 0;
+
+    static reglas_estado_t estado;
+    pasada(&tabla, &estado);
+    printf("\n%zu fixes (%.1f min a la frecuencia grabada), umbral de movimiento %.1f km/h, ", n_fixes,
+           (fixes[n_fixes - 1].t_ms - fixes[0].t_ms) / 60000.0, filtro.umbral_movimiento);
+    if (filtro.kalman) printf("Kalman Q=%.3f R=%.3f\n", filtro.q, filtro.r);
+    else printf("sin Kalman\n");
+    printf("  regla         eventos\n");
+    for (int i = 0; i < tabla.n; i++)
+        printf("  %-12s  %7u\n", tabla.nombre[i], (unsigned)estado.contador[i]);
+
+    double mejor = INFINITY;
+    volatile uint32_t sumidero = 0;
+    for (int r = 0; r < repeticiones; r++) {
+        double t0 = ahora_ns();
+        sumidero ^= pasada(&tabla, &estado);
+        double dt = ahora_ns() - t0;
+        if (dt < mejor) mejor = dt;
+    }
+    (void)sumidero;
+    double por_fix = mejor / n_fixes;
+    printf("\nevaluación: %.1f ns/fix, %.2f ns/regla (mejor de %d pasadas); a 10 Hz: %.2f µs por segundo\n",
+           por_fix, tabla.n ? por_fix / tabla.n : 0.0, repeticiones, por_fix * 10 / 1e3);
+    return 0;
+}
@@ -0,0 +1,5 @@
+#pragma once
+// En host no hay IRAM/RTC: los atributos de ubicación no tienen efecto.
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_NOINIT_ATTR
@@ -0,0 +1,21 @@
+#pragma once
+// Configuración de las herramientas de host: mismos valores por defecto que
+// main/Kconfig.projbuild para los módulos que se compilan fuera del ESP32.
+
+#define CONFIG_GPS_PARSE_GGA 1
+#define CONFIG_GPS_KALMAN 1
+#define CONFIG_GPS_KALMAN_Q_MILI 50
+#define CONFIG_GPS_KALMAN_R_MILI 1000
+#define CONFIG_GPS_UMBRAL_MOVIMIENTO_KMH 5
+#define CONFIG_GPS_UPDATE_RATE_HZ 5
+#define CONFIG_GPS_TASA_MARGEN_ALERTA_KMH 8
+#define CONFIG_GPS_TASA_MARGEN_REPOSO_KMH 15
+#define CONFIG_GPS_TASA_ACEL_ALTA_KMH_S 6
+#define CONFIG_GPS_TASA_HISTERESIS_KMH 3
+#define CONFIG_GPS_TASA_PERMANENCIA_S 5
+#define CONFIG_MONITOR_UMBRAL_VELOCIDAD_KMH 30
+#define CONFIG_TRAZA 1
+#define CONFIG_TRAZA_EVENTOS 4096
+#define CONFIG_TRAYECTO_TOLERANCIA_M 5
+#define CONFIG_TRAYECTO_MAX_INTERVALO_S 120
+#define CONFIG_TRAYECTO_PUNTOS_POR_CHUNK 8
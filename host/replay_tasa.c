@@ -0,0 +1,263 @@
+// Compara la frecuencia de fix fija contra la adaptativa (main/modules/tasa_adaptativa.c)
+// sobre un log NMEA grabado a 10 Hz, que se toma como verdad: cada política ve solo
+// los fixes que el receptor habría enviado a su frecuencia. Reporta tramas y bytes
+// por segundo, cambios de modo, eventos de exceso detectados y la latencia de
+// detección frente al cruce real del umbral.
+//
+//   replay_tasa [-u umbral_kmh] [-a margen_alerta] [-r margen_reposo] [-c acel_kmh_s]
+//               [-H histeresis] [-p permanencia_s] [-l latencia_cambio_ms] log_10hz.nmea...
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "modules/nmea_parser.h"
+#include "modules/tasa_adaptativa.h"
+
+#define BYTES_GGA_ESTIMADOS 72  // si el log no trae GGA
+
+// ===========================================================
+//  LECTURA DEL LOG
+// ===========================================================
+typedef struct {
+    uint32_t t_ms;      // desde el primer fix
+    float vel;
+    uint16_t bytes_rmc;
+    uint16_t bytes_gga; // GGA de la misma época (0 si no hubo)
+} epoca_t;
+
+typedef struct {
+    epoca_t *e;
+    size_t n, cap;
+} epocas_t;
+
+static uint32_t ms_del_dia(const char *hora)
+{
+    if (strlen(hora) < 6) return UINT32_MAX;
+    int hh = (hora[0] - '0') * 10 + (hora[1] - '0');
+    int mm = (hora[2] - '0') * 10 + (hora[3] - '0');
+    double ss = atof(hora + 4);
+    return (uint32_t)(hh * 3600000 + mm * 60000 + lround(ss * 1000.0));
+}
+
+static void leer_log(const char *ruta, epocas_t *v, double umbral_movimiento)
+{
+    FILE *f = fopen(ruta, "r");
+    if (f == NULL) { perror(ruta); exit(1); }
+
+    char linea[256];
+    gps_data_t gps = {0};
+    uint16_t gga_pendiente = 0;
+    uint32_t base = 0, ultimo = 0, dias = 0;
+    bool primero = v->n == 0;
+
+    while (fgets(linea, sizeof(linea), f)) {
+        uint16_t largo = strlen(linea);
+        linea[strcspn(linea, "\r\n")] = 0;
+        if (!nmea_verify_checksum(linea)) continue;
+        if (strncmp(linea, "$GPGGA", 6) == 0) {
+            gga_pendiente = largo;
+            continue;
+        }
+        if (!gps_parse_gprmc(linea, &gps) || !gps.valid) continue;
+
+        uint32_t t = ms_del_dia(gps.time);
+        if (t == UINT32_MAX) continue;
+        if (primero) { base = t; primero = false; }
+        if (t < ultimo) dias++;            // cruce de medianoche
+        ultimo = t;
+
+        if (v->n == v->cap) {
+            v->cap = v->cap ? v->cap * 2 : 4096;
+            v->e = realloc(v->e, v->cap * sizeof(epoca_t));
+            if (v->e == NULL) { perror("realloc"); exit(1); }
+        }
+        double vel = gps.speed_kmh < umbral_movimiento ? 0.0 : gps.speed_kmh;
+        v->e[v->n++] = (epoca_t){
+            .t_ms = t + dias * 86400000u - base,
+            .vel = (float)vel,
+            .bytes_rmc = largo,
+            .bytes_gga = gga_pendiente,
+        };
+        gga_pendiente = 0;
+    }
+    fclose(f);
+}
+
+// ===========================================================
+//  SIMULACIÓN DE UNA POLÍTICA
+// ===========================================================
+typedef struct {
+    const char *nombre;
+    int hz_fijo;                // 0 = adaptativa
+    bool con_gga;               // solo para las fijas
+} politica_t;
+
+typedef struct {
+    double tramas, bytes;
+    uint32_t cambios;
+    uint32_t detectados, perdidos;
+    double latencia_media_ms, latencia_max_ms;
+    double segundos_por_modo[3];
+} resultado_t;
+
+// Cruces reales del umbral (flanco de subida a 10 Hz)
+static size_t cruces_reales(const epocas_t *v, double umbral, uint32_t *t)
+{
+    size_t n = 0;
+    for (size_t i = 1; i < v->n; i++)
+        if (v->e[i].vel > umbral && v->e[i - 1].vel <= umbral) t[n++] = v->e[i].t_ms;
+    return n;
+}
+
+static resultado_t simular(const epocas_t *v, const politica_t *pol, const tasa_parametros_t *param,
+                           double umbral, uint32_t latencia_cambio_ms,
+                           const uint32_t *reales, size_t n_reales)
+{
+    resultado_t r = {0};
+    tasa_controlador_t c;
+    tasa_init(&c, param, TASA_NORMAL);
+
+    int hz = pol->hz_fijo ? pol->hz_fijo : tasa_frecuencia_hz(TASA_NORMAL, CONFIG_GPS_UPDATE_RATE_HZ, 10);
+    bool gga = pol->hz_fijo ? pol->con_gga : tasa_con_gga(TASA_NORMAL);
+    int hz_pendiente = hz;
+    bool gga_pendiente = gga;
+    uint32_t t_aplicar = 0;
+    uint32_t proximo = 0;
+    bool hay_anterior = false, sobre_umbral = false;
+    uint32_t t_muestra_anterior = 0;
+    size_t siguiente_real = 0;
+    bool *asignado = calloc(n_reales + 1, sizeof(bool));
+    double suma_latencia = 0;
+
+    for (size_t i = 0; i < v->n; i++) {
+        const epoca_t *e = &v->e[i];
+        if (hz_pendiente != hz && e->t_ms >= t_aplicar) {
+            hz = hz_pendiente;
+            gga = gga_pendiente;
+        }
+        // el receptor solo emite en múltiplos de su intervalo (±50 ms de la grabación a 10 Hz)
+        if (e->t_ms + 50 < proximo) continue;
+        proximo = e->t_ms + 1000 / hz;
+
+        r.tramas += 1 + (gga ? 1 : 0);
+        r.bytes += e->bytes_rmc + (gga ? (e->bytes_gga ? e->bytes_gga : BYTES_GGA_ESTIMADOS) : 0);
+
+        if (hay_anterior && !pol->hz_fijo)
+            r.segundos_por_modo[c.modo] += (e->t_ms - t_muestra_anterior) / 1000.0;
+
+        // detección como en el monitor: flanco de subida sobre el umbral
+        bool sobre = e->vel > umbral;
+        if (sobre && !sobre_umbral && hay_anterior) {
+            while (siguiente_real < n_reales && reales[siguiente_real] <= e->t_ms) siguiente_real++;
+            if (siguiente_real > 0 && !asignado[siguiente_real - 1]) {
+                asignado[siguiente_real - 1] = true;
+                double lat = e->t_ms - reales[siguiente_real - 1];
+                suma_latencia += lat;
+                if (lat > r.latencia_max_ms) r.latencia_max_ms = lat;
+                r.detectados++;
+            }
+        }
+        sobre_umbral = sobre;
+        hay_anterior = true;
+        t_muestra_anterior = e->t_ms;
+
+        if (!pol->hz_fijo) {
+            tasa_modo_t previo = c.modo;
+            tasa_modo_t modo = tasa_evaluar(&c, e->vel, e->t_ms, umbral);
+            if (modo != previo) {
+                r.cambios++;
+                hz_pendiente = tasa_frecuencia_hz(modo, CONFIG_GPS_UPDATE_RATE_HZ, 10);
+                gga_pendiente = tasa_con_gga(modo);
+                t_aplicar = e->t_ms + latencia_cambio_ms;
+                if (hz_pendiente > hz && proximo > t_aplicar + 1000 / hz_pendiente)
+                    proximo = t_aplicar + 1000 / hz_pendiente;
+            }
+        }
+    }
+
+    double duracion = v->n ? (v->e[v->n - 1].t_ms - v->e[0].t_ms) / 1000.0 : 0;
+    if (duracion > 0) {
+        r.tramas /= duracion;
+        r.bytes /= duracion;
+    }
+    r.perdidos = n_reales - r.detectados;
+    r.latencia_media_ms = r.detectados ? suma_latencia / r.detectados : 0;
+    free(asignado);
+    return r;
+}
+
+// ===========================================================
+//  MAIN
+// ===========================================================
+int main(int argc, char **argv)
+{
+    double umbral = CONFIG_MONITOR_UMBRAL_VELOCIDAD_KMH;
+    uint32_t latencia_cambio = 200;
+    tasa_parametros_t p = {
+        .margen_alerta_kmh     = CONFIG_GPS_TASA_MARGEN_ALERTA_KMH,
+        .margen_reposo_kmh     = CONFIG_GPS_TASA_MARGEN_REPOSO_KMH,
+        .umbral_movimiento_kmh = CONFIG_GPS_UMBRAL_MOVIMIENTO_KMH,
+        .acel_alta_kmh_s       = CONFIG_GPS_TASA_ACEL_ALTA_KMH_S,
+        .histeresis_kmh        = CONFIG_GPS_TASA_HISTERESIS_KMH,
+        .permanencia_ms        = CONFIG_GPS_TASA_PERMANENCIA_S * 1000,
+    };
+    const char *logs[64];
+    int n_logs = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-u") && i + 1 < argc) umbral = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-a") && i + 1 < argc) p.margen_alerta_kmh = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc) p.margen_reposo_kmh = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-c") && i + 1 < argc) p.acel_alta_kmh_s = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-H") && i + 1 < argc) p.histeresis_kmh = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-p") && i + 1 < argc) p.permanencia_ms = atof(argv[++i]) * 1000;
+        else if (!strcmp(argv[i], "-l") && i + 1 < argc) latencia_cambio = atoi(argv[++i]);
+        else if (argv[i][0] != '-' && n_logs < 64) logs[n_logs++] = argv[i];
+        else {
+            fprintf(stderr, "uso: %s [-u umbral] [-a margen_alerta] [-r margen_reposo] [-c acel_kmh_s]\n"
+                            "          [-H histeresis] [-p permanencia_s] [-l latencia_cambio_ms] log_10hz.nmea...\n", argv[0]);
+            return 2;
+        }
+    }
+    if (n_logs == 0) {
+        fprintf(stderr, "falta al menos un log NMEA grabado a 10 Hz\n");
+        return 2;
+    }
+
+    epocas_t v = {0};
+    for (int i = 0; i < n_logs; i++) leer_log(logs[i], &v, p.umbral_movimiento_kmh);
+    if (v.n < 2) {
+        fprintf(stderr, "no hay fixes válidos\n");
+        return 1;
+    }
+
+    uint32_t *reales = malloc(v.n * sizeof(uint32_t));
+    size_t n_reales = cruces_reales(&v, umbral, reales);
+
+    const politica_t politicas[] = {
+        { "fija 1 Hz RMC+GGA",  1, true },
+        { "fija 5 Hz RMC+GGA",  5, true },
+        { "fija 10 Hz RMC",    10, false },
+        { "adaptativa",         0, false },
+    };
+
+    printf("fixes: %zu (%.0f s), umbral %.0f km/h, cruces reales: %zu\n\n",
+           v.n, (v.e[v.n - 1].t_ms - v.e[0].t_ms) / 1000.0, umbral, n_reales);
+    printf("%-20s %8s %8s %8s %10s %8s %12s %12s\n",
+           "política", "tramas/s", "bytes/s", "cambios", "detectados", "perdidos", "lat_media_ms", "lat_max_ms");
+    for (size_t i = 0; i < sizeof(politicas) / sizeof(politicas[0]); i++) {
+        resultado_t r = simular(&v, &politicas[i], &p, umbral, latencia_cambio, reales, n_reales);
+        printf("%-20s %8.2f %8.1f %8u %10u %8u %12.0f %12.0f\n",
+               politicas[i].nombre, r.tramas, r.bytes, r.cambios, r.detectados, r.perdidos,
+               r.latencia_media_ms, r.latencia_max_ms);
+        if (!politicas[i].hz_fijo)
+            printf("  tiempo por modo: REPOSO %.0f s, NORMAL %.0f s, ALERTA %.0f s\n",
+                   r.segundos_por_modo[TASA_REPOSO], r.segundos_por_modo[TASA_NORMAL], r.segundos_por_modo[TASA_ALERTA]);
+    }
+
+    free(reales);
+    free(v.e);
+    return 0;
+}
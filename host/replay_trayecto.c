@@ -0,0 +1,319 @@
+// Reproduce logs NMEA a través del simplificador y el codificador del trayecto
+// (main/modules/trayecto_codec.c) y reporta compresión y error frente al
+// recorrido crudo. También extrae un volcado de la partición "trayecto".
+//
+//   replay_trayecto [-t tolerancia_m] [-i max_intervalo_s] [-c puntos_por_chunk]
+//                   [-o puntos.csv] [-p particion.bin] log.nmea...
+//   replay_trayecto --volcado trayecto.bin [-o puntos.csv]
+//
+// El volcado se obtiene con: parttool.py read_partition --partition-name trayecto --output trayecto.bin
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "modules/nmea_parser.h"
+#include "modules/trayecto_codec.h"
+
+// ===========================================================
+//  ALMACÉN EN MEMORIA (simula la partición)
+// ===========================================================
+typedef struct {
+    uint8_t *datos;
+    size_t tam;
+} memoria_t;
+
+static bool mem_leer(void *ctx, uint32_t offset, void *dst, size_t len)
+{
+    memoria_t *m = ctx;
+    if (offset + len > m->tam) return false;
+    memcpy(dst, m->datos + offset, len);
+    return true;
+}
+
+static bool mem_escribir(void *ctx, uint32_t offset, const void *src, size_t len)
+{
+    memoria_t *m = ctx;
+    if (offset + len > m->tam) return false;
+    // como en NOR flash: solo se pueden bajar bits
+    const uint8_t *s = src;
+    for (size_t i = 0; i < len; i++) m->datos[offset + i] &= s[i];
+    return true;
+}
+
+static bool mem_borrar_sector(void *ctx, uint32_t offset)
+{
+    memoria_t *m = ctx;
+    if (offset + TRAYECTO_SECTOR > m->tam) return false;
+    memset(m->datos + offset, 0xFF, TRAYECTO_SECTOR);
+    return true;
+}
+
+// ===========================================================
+//  ARREGLO DINÁMICO DE PUNTOS
+// ===========================================================
+typedef struct {
+    trayecto_punto_t *p;
+    size_t n, cap;
+} puntos_t;
+
+static void puntos_agregar(puntos_t *v, const trayecto_punto_t *p)
+{
+    if (v->n == v->cap) {
+        v->cap = v->cap ? v->cap * 2 : 1024;
+        v->p = realloc(v->p, v->cap * sizeof(*v->p));
+        if (v->p == NULL) { perror("realloc"); exit(1); }
+    }
+    v->p[v->n++] = *p;
+}
+
+static void cb_agregar(void *ctx, const trayecto_punto_t *p)
+{
+    puntos_agregar(ctx, p);
+}
+
+// ===========================================================
+//  LECTURA DE LOGS NMEA
+// ===========================================================
+static size_t leer_log(const char *ruta, puntos_t *crudos)
+{
+    FILE *f = fopen(ruta, "r");
+    if (f == NULL) { perror(ruta); exit(1); }
+
+    char linea[256];
+    gps_data_t gps = {0};
+    size_t bytes = 0;
+    while (fgets(linea, sizeof(linea), f)) {
+        bytes += strlen(linea);
+        linea[strcspn(linea, "\r\n")] = 0;
+        if (!nmea_verify_checksum(linea)) continue;
+        if (gps_parse_gprmc(linea, &gps) && gps.valid) {
+            trayecto_punto_t p;
+            trayecto_punto_desde_gps(&gps, &p);
+            if (p.t != 0) puntos_agregar(crudos, &p);
+        }
+    }
+    fclose(f);
+    return bytes;
+}
+
+static void escribir_csv(const char *ruta, const puntos_t *v)
+{
+    FILE *f = fopen(ruta, "w");
+    if (f == NULL) { perror(ruta); exit(1); }
+    fprintf(f, "t_2000_s,lat,lon\n");
+    for (size_t i = 0; i < v->n; i++)
+        fprintf(f, "%u,%.6f,%.6f\n", v->p[i].t, v->p[i].lat_e6 / 1e6, v->p[i].lon_e6 / 1e6);
+    fclose(f);
+}
+
+// ===========================================================
+//  ERROR: distancia de cada punto crudo a la polilínea simplificada
+// ===========================================================
+static int comparar_float(const void *a, const void *b)
+{
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+static void medir_error(const puntos_t *crudos, const puntos_t *simpl, float *max, float *media, float *p95)
+{
+    float *err = malloc(crudos->n * sizeof(float));
+    double suma = 0;
+    size_t k = 0;
+
+    for (size_t i = 0; i < crudos->n; i++) {
+        const trayecto_punto_t *p = &crudos->p[i];
+        // segmento cuyo intervalo de tiempo contiene al punto (se prueban los vecinos
+        // porque a 5-10 Hz varios fixes comparten el mismo segundo)
+        while (k + 1 < simpl->n && simpl->p[k + 1].t < p->t) k++;
+        float d = INFINITY;
+        for (size_t j = (k > 0 ? k - 1 : 0); j + 1 < simpl->n && j <= k + 1; j++) {
+            float dj = trayecto_distancia_segmento_m(p, &simpl->p[j], &simpl->p[j + 1]);
+            if (dj < d) d = dj;
+        }
+        if (simpl->n == 1) d = trayecto_distancia_m(p, &simpl->p[0]);
+        err[i] = d;
+        suma += d;
+    }
+
+    qsort(err, crudos->n, sizeof(float), comparar_float);
+    *max = crudos->n ? err[crudos->n - 1] : 0;
+    *media = crudos->n ? (float)(suma / crudos->n) : 0;
+    *p95 = crudos->n ? err[(size_t)(crudos->n * 0.95)] : 0;
+    free(err);
+}
+
+// ===========================================================
+//  EXTRACCIÓN DE UN VOLCADO DE LA PARTICIÓN
+// ===========================================================
+typedef struct {
+    uint32_t seq;
+    uint32_t indice;
+} sector_t;
+
+static int comparar_sector(const void *a, const void *b)
+{
+    const sector_t *x = a, *y = b;
+    int32_t d = (int32_t)(x->seq - y->seq);
+    return (d > 0) - (d < 0);
+}
+
+static int extraer_volcado(const char *ruta, const char *salida)
+{
+    FILE *f = fopen(ruta, "rb");
+    if (f == NULL) { perror(ruta); return 1; }
+    fseek(f, 0, SEEK_END);
+    size_t tam = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *datos = malloc(tam);
+    if (fread(datos, 1, tam, f) != tam) { perror(ruta); return 1; }
+    fclose(f);
+
+    size_t n_sect = tam / TRAYECTO_SECTOR;
+    sector_t *orden = malloc(n_sect * sizeof(sector_t));
+    size_t validos = 0;
+    for (size_t s = 0; s < n_sect; s++) {
+        uint32_t seq;
+        if (trayecto_decodificar_sector(datos + s * TRAYECTO_SECTOR, &seq, NULL, NULL, NULL, NULL) > 0)
+            orden[validos++] = (sector_t){ .seq = seq, .indice = s };
+    }
+    qsort(orden, validos, sizeof(sector_t), comparar_sector);
+
+    puntos_t pts = {0};
+    for (size_t i = 0; i < validos; i++)
+        trayecto_decodificar_sector(datos + orden[i].indice * TRAYECTO_SECTOR, NULL, NULL, NULL, cb_agregar, &pts);
+
+    printf("sectores válidos: %zu de %zu, puntos: %zu\n", validos, n_sect, pts.n);
+    if (salida) escribir_csv(salida, &pts);
+    free(datos);
+    free(orden);
+    free(pts.p);
+    return 0;
+}
+
+// ===========================================================
+//  MAIN
+// ===========================================================
+int main(int argc, char **argv)
+{
+    float tolerancia = CONFIG_TRAYECTO_TOLERANCIA_M;
+    uint32_t max_intervalo = CONFIG_TRAYECTO_MAX_INTERVALO_S;
+    int por_chunk = CONFIG_TRAYECTO_PUNTOS_POR_CHUNK;
+    const char *salida = NULL;
+    const char *volcado = NULL;
+    const char *particion = NULL;
+    const char *logs[64];
+    int n_logs = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-t") && i + 1 < argc) tolerancia = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-i") && i + 1 < argc) max_intervalo = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-c") && i + 1 < argc) por_chunk = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc) salida = argv[++i];
+        else if (!strcmp(argv[i], "-p") && i + 1 < argc) particion = argv[++i];
+        else if (!strcmp(argv[i], "--volcado") && i + 1 < argc) volcado = argv[++i];
+        else if (argv[i][0] != '-' && n_logs < 64) logs[n_logs++] = argv[i];
+        else {
+            fprintf(stderr, "uso: %s [-t tol_m] [-i max_intervalo_s] [-c pts_chunk] [-o puntos.csv] [-p particion.bin] log.nmea...\n"
+                            "     %s --volcado trayecto.bin [-o puntos.csv]\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+    if (volcado) return extraer_volcado(volcado, salida);
+    if (n_logs == 0) {
+        fprintf(stderr, "falta al menos un log NMEA\n");
+        return 2;
+    }
+
+    puntos_t crudos = {0};
+    size_t bytes_nmea = 0;
+    for (int i = 0; i < n_logs; i++) bytes_nmea += leer_log(logs[i], &crudos);
+    if (crudos.n == 0) {
+        fprintf(stderr, "no hay fixes válidos\n");
+        return 1;
+    }
+
+    // partición simulada con el mismo tamaño que partitions.csv (512 KB)
+    memoria_t mem = { .tam = 512 * 1024 };
+    mem.datos = malloc(mem.tam);
+    memset(mem.datos, 0xFF, mem.tam);
+    trayecto_almacen_t almacen = {
+        .ctx = &mem, .n_sectores = mem.tam / TRAYECTO_SECTOR,
+        .leer = mem_leer, .escribir = mem_escribir, .borrar_sector = mem_borrar_sector,
+    };
+    trayecto_escritor_t w;
+    trayecto_simplificador_t s;
+    trayecto_escritor_init(&w, &almacen, por_chunk);
+    trayecto_simplificador_init(&s, tolerancia, max_intervalo);
+
+    struct timespec t0, t1;
+    size_t conservados = 0, sectores_usados = 0;
+    uint32_t sector_anterior = UINT32_MAX;
+    trayecto_punto_t q;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (size_t i = 0; i < crudos.n; i++) {
+        if (trayecto_simplificar(&s, &crudos.p[i], &q)) {
+            trayecto_escritor_agregar(&w, &q);
+            conservados++;
+            if (w.sector != sector_anterior) { sectores_usados++; sector_anterior = w.sector; }
+        }
+    }
+    if (trayecto_simplificador_vaciar(&s, &q)) {
+        trayecto_escritor_agregar(&w, &q);
+        conservados++;
+    }
+    trayecto_escritor_vaciar(&w);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ns_por_fix = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / crudos.n;
+
+    // releer lo escrito como lo haría la extracción del volcado
+    puntos_t simpl = {0};
+    sector_t *orden = malloc(almacen.n_sectores * sizeof(sector_t));
+    size_t validos = 0;
+    for (uint32_t i = 0; i < almacen.n_sectores; i++) {
+        uint32_t seq;
+        if (trayecto_decodificar_sector(mem.datos + i * TRAYECTO_SECTOR, &seq, NULL, NULL, NULL, NULL) > 0)
+            orden[validos++] = (sector_t){ .seq = seq, .indice = i };
+    }
+    qsort(orden, validos, sizeof(sector_t), comparar_sector);
+    for (size_t i = 0; i < validos; i++)
+        trayecto_decodificar_sector(mem.datos + orden[i].indice * TRAYECTO_SECTOR, NULL, NULL, NULL, cb_agregar, &simpl);
+
+    float e_max, e_media, e_p95;
+    medir_error(&crudos, &simpl, &e_max, &e_media, &e_p95);
+
+    double horas = (crudos.p[crudos.n - 1].t - crudos.p[0].t) / 3600.0;
+    size_t bytes_crudos = crudos.n * sizeof(trayecto_punto_t);
+
+    printf("fixes crudos:        %zu (%.2f h)\n", crudos.n, horas);
+    printf("puntos conservados:  %zu (%.1f%%)%s\n", conservados, 100.0 * conservados / crudos.n,
+           simpl.n != conservados ? "  ¡decodificados distintos!" : "");
+    printf("bytes NMEA:          %zu\n", bytes_nmea);
+    printf("bytes binario crudo: %zu (12 B/fix)\n", bytes_crudos);
+    printf("bytes en flash:      %u en %zu sectores (%.2f B/punto)\n", w.bytes_escritos, sectores_usados,
+           (double)w.bytes_escritos / conservados);
+    printf("compresión:          %.1fx vs NMEA, %.1fx vs binario crudo\n",
+           (double)bytes_nmea / w.bytes_escritos, (double)bytes_crudos / w.bytes_escritos);
+    if (horas > 0)
+        printf("autonomía 512 KB:    %.1f h de este recorrido\n", horas * (512.0 * 1024) / w.bytes_escritos);
+    printf("error (m):           max %.2f  media %.2f  p95 %.2f  (tolerancia %.1f)\n", e_max, e_media, e_p95, tolerancia);
+    printf("CPU por fix:         %.0f ns (host)\n", ns_por_fix);
+
+    if (salida) escribir_csv(salida, &simpl);
+    if (particion) {
+        // imagen de la partición simulada, legible con --volcado
+        FILE *f = fopen(particion, "wb");
+        if (f == NULL) { perror(particion); return 1; }
+        fwrite(mem.datos, 1, mem.tam, f);
+        fclose(f);
+    }
+    free(orden);
+    free(simpl.p);
+    free(crudos.p);
+    free(mem.datos);
+    return 0;
+}
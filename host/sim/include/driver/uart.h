@@ -0,0 +1,40 @@
+#pragma once
+// UART simulado. El puerto del GPS recibe la captura NMEA con los tiempos de un
+// receptor real (época por época, a los baudios de la captura) y entrega al
+// driver como el hardware: de a rxfifo_full_thrhd bytes o tras el timeout de
+// línea ociosa. Los demás puertos solo transmiten (a archivo con simulador -x).
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+typedef int uart_port_t;
+
+typedef enum { UART_DATA_5_BITS, UART_DATA_6_BITS, UART_DATA_7_BITS, UART_DATA_8_BITS } uart_word_length_t;
+typedef enum { UART_PARITY_DISABLE, UART_PARITY_EVEN = 2, UART_PARITY_ODD } uart_parity_t;
+typedef enum { UART_STOP_BITS_1 = 1, UART_STOP_BITS_1_5, UART_STOP_BITS_2 } uart_stop_bits_t;
+typedef enum { UART_HW_FLOWCTRL_DISABLE, UART_HW_FLOWCTRL_RTS, UART_HW_FLOWCTRL_CTS, UART_HW_FLOWCTRL_CTS_RTS } uart_hw_flowcontrol_t;
+
+typedef struct {
+    int baud_rate;
+    uart_word_length_t data_bits;
+    uart_parity_t parity;
+    uart_stop_bits_t stop_bits;
+    uart_hw_flowcontrol_t flow_ctrl;
+    uint8_t rx_flow_ctrl_thresh;
+    int source_clk;
+} uart_config_t;
+
+#define UART_PIN_NO_CHANGE (-1)
+
+esp_err_t uart_param_config(uart_port_t puerto, const uart_config_t *config);
+esp_err_t uart_set_pin(uart_port_t puerto, int tx, int rx, int rts, int cts);
+esp_err_t uart_driver_install(uart_port_t puerto, int rx_buffer, int tx_buffer, int cola, void *handle_cola, int flags);
+esp_err_t uart_set_baudrate(uart_port_t puerto, uint32_t baudios);
+int uart_read_bytes(uart_port_t puerto, void *buf, uint32_t largo, TickType_t espera);
+int uart_write_bytes(uart_port_t puerto, const void *src, size_t largo);
+esp_err_t uart_flush(uart_port_t puerto);
+esp_err_t uart_flush_input(uart_port_t puerto);
+esp_err_t uart_wait_tx_done(uart_port_t puerto, TickType_t espera);
+esp_err_t uart_get_tx_buffer_free_size(uart_port_t puerto, size_t *libre);
+esp_err_t uart_get_buffered_data_len(uart_port_t puerto, size_t *largo);
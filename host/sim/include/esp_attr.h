@@ -0,0 +1,7 @@
+#pragma once
+// En la simulación no hay IRAM/RTC: los atributos de ubicación no tienen efecto
+// (la memoria RTC arranca en cero, como después de un encendido).
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_NOINIT_ATTR
+#define RTC_DATA_ATTR
@@ -0,0 +1,12 @@
+#pragma once
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "esp_timer.h"
+
+// El código corre en tiempo virtual cero: los ciclos solo reflejan las esperas
+static inline uint32_t esp_cpu_get_cycle_count(void)
+{
+    return (uint32_t)(esp_timer_get_time() * CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ);
+}
+
+static inline int esp_cpu_get_core_id(void) { return 0; }
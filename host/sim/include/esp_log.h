@@ -0,0 +1,17 @@
+#pragma once
+// Log del firmware con la marca de tiempo virtual, en el formato del monitor serie
+#include "sdkconfig.h"
+#include "esp_err.h"
+
+typedef enum {
+    ESP_LOG_NONE, ESP_LOG_ERROR, ESP_LOG_WARN, ESP_LOG_INFO, ESP_LOG_DEBUG, ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+void sim_log(esp_log_level_t nivel, const char *tag, const char *formato, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define ESP_LOGE(tag, ...) sim_log(ESP_LOG_ERROR, (tag), __VA_ARGS__)
+#define ESP_LOGW(tag, ...) sim_log(ESP_LOG_WARN, (tag), __VA_ARGS__)
+#define ESP_LOGI(tag, ...) sim_log(ESP_LOG_INFO, (tag), __VA_ARGS__)
+#define ESP_LOGD(tag, ...) sim_log(ESP_LOG_DEBUG, (tag), __VA_ARGS__)
+#define ESP_LOGV(tag, ...) sim_log(ESP_LOG_VERBOSE, (tag), __VA_ARGS__)
@@ -0,0 +1,23 @@
+#pragma once
+// Sin tabla de particiones: esp_partition_find_first devuelve NULL y los módulos
+// que guardan en flash (trayecto, cobertura, caja negra) quedan deshabilitados.
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+typedef enum { ESP_PARTITION_TYPE_APP = 0, ESP_PARTITION_TYPE_DATA = 1 } esp_partition_type_t;
+typedef int esp_partition_subtype_t;
+
+typedef struct {
+    esp_partition_type_t type;
+    esp_partition_subtype_t subtype;
+    uint32_t address;
+    uint32_t size;
+    char label[17];
+} esp_partition_t;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t tipo, esp_partition_subtype_t subtipo,
+                                                const char *etiqueta);
+esp_err_t esp_partition_read(const esp_partition_t *p, size_t offset, void *dst, size_t largo);
+esp_err_t esp_partition_write(const esp_partition_t *p, size_t offset, const void *src, size_t largo);
+esp_err_t esp_partition_erase_range(const esp_partition_t *p, size_t offset, size_t largo);
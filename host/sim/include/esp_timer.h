@@ -0,0 +1,5 @@
+#pragma once
+#include <stdint.h>
+
+// Microsegundos de tiempo virtual desde el arranque
+int64_t esp_timer_get_time(void);
@@ -0,0 +1,35 @@
+#pragma once
+// FreeRTOS simulado (host/sim): un solo núcleo, planificación cooperativa por
+// prioridad y tiempo virtual. Solo lo que usa el firmware.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE              1
+#define pdFALSE             0
+#define pdPASS              pdTRUE
+#define pdFAIL              pdFALSE
+#define portMAX_DELAY       ((TickType_t)0xffffffffUL)
+
+#define configTICK_RATE_HZ  CONFIG_FREERTOS_HZ
+#define configMAX_PRIORITIES 25
+#define portTICK_PERIOD_MS  ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define pdTICKS_TO_MS(t)    ((uint32_t)(((uint64_t)(t) * 1000) / configTICK_RATE_HZ))
+#define tskNO_AFFINITY      0x7FFFFFFF
+
+// Sin concurrencia real: las secciones críticas no hacen nada
+typedef struct { int nada; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED            { 0 }
+#define portENTER_CRITICAL(mux)                 ((void)(mux))
+#define portEXIT_CRITICAL(mux)                  ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux)             ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux)              ((void)(mux))
+#define portSET_INTERRUPT_MASK_FROM_ISR()       0
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(e)    ((void)(e))
@@ -0,0 +1,12 @@
+#pragma once
+#include "freertos/FreeRTOS.h"
+
+typedef struct sim_cola *QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t largo, UBaseType_t tam_item);
+BaseType_t xQueueSend(QueueHandle_t cola, const void *item, TickType_t espera);
+#define xQueueSendToBack(cola, item, espera) xQueueSend((cola), (item), (espera))
+BaseType_t xQueueReceive(QueueHandle_t cola, void *item, TickType_t espera);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t cola);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t cola);
+void vQueueDelete(QueueHandle_t cola);
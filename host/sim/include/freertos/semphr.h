@@ -0,0 +1,9 @@
+#pragma once
+#include "freertos/queue.h"
+
+// Como en FreeRTOS, un mutex es una cola de un item vacío (aquí sin herencia de prioridad)
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaforo, TickType_t espera);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaforo);
@@ -0,0 +1,21 @@
+#pragma once
+#include "freertos/FreeRTOS.h"
+
+typedef struct sim_tarea *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *nombre, uint32_t pila,
+                                   void *arg, UBaseType_t prioridad, TaskHandle_t *handle, BaseType_t nucleo);
+#define xTaskCreate(fn, nombre, pila, arg, prioridad, handle) \
+    xTaskCreatePinnedToCore((fn), (nombre), (pila), (arg), (prioridad), (handle), tskNO_AFFINITY)
+
+void vTaskDelete(TaskHandle_t tarea);
+void vTaskDelay(TickType_t ticks);
+BaseType_t xTaskDelayUntil(TickType_t *previo, TickType_t incremento);
+#define vTaskDelayUntil(previo, incremento) ((void)xTaskDelayUntil((previo), (incremento)))
+TickType_t xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+TaskHandle_t xTaskGetCurrentTaskHandleForCore(BaseType_t nucleo);
+char *pcTaskGetName(TaskHandle_t tarea);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t tarea);
+void taskYIELD(void);
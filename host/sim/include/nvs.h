@@ -0,0 +1,24 @@
+#pragma once
+// NVS en memoria, respaldada por un archivo de texto (simulador -n)
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+typedef uint32_t nvs_handle_t;
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode_t;
+
+esp_err_t nvs_open(const char *espacio, nvs_open_mode_t modo, nvs_handle_t *handle);
+void nvs_close(nvs_handle_t handle);
+esp_err_t nvs_commit(nvs_handle_t handle);
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *clave);
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char *clave, uint8_t valor);
+esp_err_t nvs_set_u16(nvs_handle_t handle, const char *clave, uint16_t valor);
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char *clave, uint32_t valor);
+esp_err_t nvs_set_i32(nvs_handle_t handle, const char *clave, int32_t valor);
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *clave, const void *valor, size_t largo);
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char *clave, uint8_t *valor);
+esp_err_t nvs_get_u16(nvs_handle_t handle, const char *clave, uint16_t *valor);
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char *clave, uint32_t *valor);
+esp_err_t nvs_get_i32(nvs_handle_t handle, const char *clave, int32_t *valor);
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *clave, void *valor, size_t *largo);
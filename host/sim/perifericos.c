@@ -0,0 +1,762 @@
+// Periféricos simulados: UART (captura NMEA con tiempos reales), GPIO interpretado
+// como display/buzzer/LED, NVS respaldada en archivo, log y restos de ESP-IDF.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/uart.h"
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_rom_crc.h"
+#include "esp_partition.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+
+#include "screens/display_7seg.h"
+#include "drivers/buzzer_driver.h"
+#include "drivers/led_driver.h"
+#include "modules/gnss.h"
+#include "sim.h"
+
+sim_config_t sim_config = { 0 };
+
+// ===========================================================
+//  EVENTOS Y LOG
+// ===========================================================
+void sim_evento(const char *formato, ...)
+{
+    if (sim_config.eventos == NULL) return;
+    uint64_t t = sim_ahora_us();
+    fprintf(sim_config.eventos, "%6llu.%03llu ", (unsigned long long)(t / 1000000),
+            (unsigned long long)(t / 1000 % 1000));
+    va_list ap;
+    va_start(ap, formato);
+    vfprintf(sim_config.eventos, formato, ap);
+    va_end(ap);
+    fputc('\n', sim_config.eventos);
+}
+
+void sim_log(esp_log_level_t nivel, const char *tag, const char *formato, ...)
+{
+    static const char letra[] = "NEWIDV";
+    if (sim_config.log == NULL || nivel > CONFIG_LOG_DEFAULT_LEVEL) return;
+
+    fprintf(sim_config.log, "%c (%llu) %s: ", letra[nivel], (unsigned long long)(sim_ahora_us() / 1000), tag);
+    va_list ap;
+    va_start(ap, formato);
+    vfprintf(sim_config.log, formato, ap);
+    va_end(ap);
+    fputc('\n', sim_config.log);
+}
+
+// ===========================================================
+//  GPIO
+// ===========================================================
+#define SIM_GPIO_MAX 40
+
+static int8_t nivel_pin[SIM_GPIO_MAX];
+static bool gpio_listo = false;
+
+// Display multiplexado: se arma el valor con un barrido completo (dígito 3, 2 y 1,
+// en ese orden como en task_display_7seg) y se registra cuando cambia
+static uint8_t bcd = 0;
+static int8_t digito_barrido[4];
+static int ultimo_mostrado = -1;
+
+static void gpio_iniciar(void)
+{
+    memset(nivel_pin, -1, sizeof(nivel_pin));
+    memset(digito_barrido, -1, sizeof(digito_barrido));
+    gpio_listo = true;
+}
+
+static void display_digito(int digito)
+{
+    if (digito == 3) {
+        digito_barrido[2] = digito_barrido[1] = -1;
+    } else if (digito_barrido[digito + 1] < 0) {
+        return;                 // barrido empezado a la mitad
+    }
+    digito_barrido[digito] = (int8_t)bcd;
+    if (digito != 1) return;
+
+    int valor = digito_barrido[3] * 100 + digito_barrido[2] * 10 + digito_barrido[1];
+    if (valor != ultimo_mostrado) {
+        sim_evento("display %03d", valor);
+        ultimo_mostrado = valor;
+    }
+}
+
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    if (!gpio_listo) gpio_iniciar();
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t nivel)
+{
+    if (!gpio_listo) gpio_iniciar();
+    if (pin < 0 || pin >= SIM_GPIO_MAX) return ESP_ERR_INVALID_ARG;
+    nivel = nivel ? 1 : 0;
+
+    if (pin == BIT_0_GPIO || pin == BIT_1_GPIO || pin == BIT_2_GPIO || pin == BIT_3_GPIO) {
+        int bit = pin == BIT_0_GPIO ? 0 : pin == BIT_1_GPIO ? 1 : pin == BIT_2_GPIO ? 2 : 3;
+        bcd = (uint8_t)((bcd & ~(1u << bit)) | (nivel << bit));
+    } else if (pin == DIGITO_1_GPIO || pin == DIGITO_2_GPIO || pin == DIGITO_3_GPIO) {
+        if (nivel) display_digito(pin == DIGITO_1_GPIO ? 1 : pin == DIGITO_2_GPIO ? 2 : 3);
+    } else if (nivel_pin[pin] != (int8_t)nivel) {
+        if (pin == BUZZER_GPIO) {
+            sim_evento("buzzer %s", nivel ? "off" : "on");      // activo en bajo
+        } else if (pin == LED_GPIO) {
+            sim_evento("led %s", nivel ? "on" : "off");
+        } else if (pin == GPS_RST_PIN) {
+            sim_evento("gps reset %s", nivel ? "liberado" : "activo");
+        } else {
+            sim_evento("gpio %d %u", pin, (unsigned)nivel);
+        }
+    }
+    nivel_pin[pin] = (int8_t)nivel;
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t pin)
+{
+    return (pin >= 0 && pin < SIM_GPIO_MAX && nivel_pin[pin] > 0) ? 1 : 0;
+}
+
+// ===========================================================
+//  CAPTURA NMEA → FLUJO DEL UART DEL GPS
+// ===========================================================
+// Ráfaga: bytes que salen seguidos desde t_us (una o más épocas)
+typedef struct {
+    uint64_t t_us;
+    uint32_t primero;
+    uint32_t n;
+} rafaga_t;
+
+static uint8_t *flujo = NULL;
+static uint32_t flujo_n = 0;
+static rafaga_t *rafagas = NULL;
+static uint32_t n_rafagas = 0;
+static int baudios_captura = 9600;
+
+// Hora hhmmss.sss del campo 1 de RMC/GGA en ms; -1 si no tiene
+static int32_t hora_linea_ms(const char *l)
+{
+    if (l[0] != '$' || strlen(l) < 8 || (strncmp(l + 3, "RMC,", 4) && strncmp(l + 3, "GGA,", 4))) return -1;
+    const char *h = l + 7;
+    for (int i = 0; i < 6; i++) if (!isdigit((unsigned char)h[i])) return -1;
+    int32_t ms = (((h[0] - '0') * 10 + (h[1] - '0')) * 3600 + ((h[2] - '0') * 10 + (h[3] - '0')) * 60 +
+                  (h[4] - '0') * 10 + (h[5] - '0')) * 1000;
+    if (h[6] == '.') ms += (int32_t)(atof(h + 6) * 1000.0 + 0.5);
+    return ms;
+}
+
+static uint64_t fin_rafaga_us(const rafaga_t *r, uint32_t bytes)
+{
+    return r->t_us + (uint64_t)bytes * 10000000ull / (uint64_t)baudios_captura;
+}
+
+static void agregar_bytes(const char *datos, size_t largo, uint64_t t_us)
+{
+    static size_t capacidad = 0, capacidad_rafagas = 0;
+    if (flujo_n + largo > capacidad) {
+        capacidad = (capacidad + largo) * 2;
+        flujo = realloc(flujo, capacidad);
+    }
+    memcpy(flujo + flujo_n, datos, largo);
+
+    rafaga_t *r = n_rafagas ? &rafagas[n_rafagas - 1] : NULL;
+    if (r == NULL || t_us > fin_rafaga_us(r, r->n)) {
+        if (n_rafagas == capacidad_rafagas) {
+            capacidad_rafagas = capacidad_rafagas ? capacidad_rafagas * 2 : 1024;
+            rafagas = realloc(rafagas, capacidad_rafagas * sizeof(rafaga_t));
+        }
+        r = &rafagas[n_rafagas++];
+        r->t_us = t_us;
+        r->primero = flujo_n;
+        r->n = 0;
+    }
+    r->n += (uint32_t)largo;        // el receptor saturado encadena épocas
+    flujo_n += (uint32_t)largo;
+}
+
+bool sim_captura_cargar(const char *ruta, int baudios, uint64_t retardo_us)
+{
+    FILE *f = fopen(ruta, "r");
+    if (f == NULL) return false;
+    baudios_captura = baudios;
+
+    char linea[512];
+    uint64_t epoca_us = retardo_us;
+    int32_t hora_epoca = -1;
+    int32_t intervalo_ms = 1000;
+    bool vista_rmc = false, vista_gga = false;
+
+    while (fgets(linea, sizeof(linea), f)) {
+        linea[strcspn(linea, "\r\n")] = '\0';
+        if (linea[0] == '\0') continue;
+
+        // nueva época: cambia la hora, o se repite RMC/GGA (receptor sin hora)
+        int32_t hora = hora_linea_ms(linea);
+        bool es_rmc = linea[0] == '$' && strncmp(linea + 3, "RMC,", 4) == 0;
+        bool es_gga = linea[0] == '$' && strncmp(linea + 3, "GGA,", 4) == 0;
+        bool nueva = (es_rmc && vista_rmc) || (es_gga && vista_gga) ||
+                     (hora >= 0 && hora_epoca >= 0 && hora != hora_epoca);
+        if (nueva) {
+            if (hora >= 0 && hora_epoca >= 0 && hora != hora_epoca) {
+                int32_t d = hora - hora_epoca;
+                if (d < -12 * 3600 * 1000) d += 24 * 3600 * 1000;     // medianoche UTC
+                if (d > 0) intervalo_ms = d;
+            }
+            epoca_us += (uint64_t)intervalo_ms * 1000;
+            vista_rmc = vista_gga = false;
+        }
+        if (hora >= 0) hora_epoca = hora;
+        vista_rmc |= es_rmc;
+        vista_gga |= es_gga;
+
+        size_t n = strlen(linea);
+        linea[n++] = '\r';
+        linea[n++] = '\n';
+        agregar_bytes(linea, n, epoca_us);
+    }
+    fclose(f);
+    return flujo_n > 0;
+}
+
+uint32_t sim_captura_bytes(void) { return flujo_n; }
+
+uint64_t sim_captura_fin_us(void)
+{
+    return n_rafagas ? fin_rafaga_us(&rafagas[n_rafagas - 1], rafagas[n_rafagas - 1].n) : 0;
+}
+
+// ===========================================================
+//  UART
+// ===========================================================
+// Umbrales por defecto del driver: interrupción con 120 bytes en la FIFO o tras
+// 10 símbolos de línea ociosa; FIFO de hardware de 128 bytes
+#define UART_UMBRAL_FIFO    120
+#define UART_TOUT_SIMBOLOS  10
+#define UART_FIFO_HW        128
+#define SIM_UART_MAX        3
+
+typedef struct {
+    bool instalado;
+    int baudios;
+    uint8_t *rx;                // buffer del driver (anillo)
+    uint32_t rx_cap, rx_cabeza, rx_n;
+    uint32_t tx_cap;
+    uint64_t tx_fin_us;         // cuándo termina de salir lo ya escrito
+    char linea_tx[128];         // puerto del GPS: comandos al receptor como eventos
+    size_t largo_linea_tx;
+    FILE *archivo_tx;
+} sim_uart_t;
+
+static sim_uart_t uarts[SIM_UART_MAX];
+static uint32_t siguiente = 0;      // próximo byte del flujo que llega al driver
+static uint32_t rafaga_siguiente = 0;
+static uint32_t entregados = 0;
+static uint32_t perdidos = 0;
+
+uint32_t sim_uart_bytes_entregados(void) { return entregados; }
+uint32_t sim_uart_bytes_perdidos(void) { return perdidos; }
+
+static uint64_t simbolo_ns(int baudios) { return 10000000000ull / (uint64_t)baudios; }
+
+// Cuándo el driver ve el byte i del flujo (las consultas son casi siempre
+// crecientes: se mueve un cursor en vez de buscar)
+static uint64_t visible_us(uint32_t i)
+{
+    while (rafaga_siguiente > 0 && rafagas[rafaga_siguiente].primero > i) rafaga_siguiente--;
+    while (rafaga_siguiente + 1 < n_rafagas && rafagas[rafaga_siguiente + 1].primero <= i) rafaga_siguiente++;
+    const rafaga_t *r = &rafagas[rafaga_siguiente];
+    uint32_t k = i - r->primero;
+    uint32_t fin_bloque = (k / UART_UMBRAL_FIFO + 1) * UART_UMBRAL_FIFO;
+    if (fin_bloque <= r->n) return fin_rafaga_us(r, fin_bloque);
+    return fin_rafaga_us(r, r->n + UART_TOUT_SIMBOLOS);
+}
+
+// ===========================================================
+//  DISPOSITIVO SERIE (tiempo real)
+// ===========================================================
+static int dispositivo = -1;
+static bool dispositivo_tty = false;
+static uint32_t dispositivo_bytes = 0;
+
+uint32_t sim_dispositivo_bytes(void) { return dispositivo_bytes; }
+
+// En un pty los baudios no cambian el ritmo, pero el otro extremo los lee del
+// termios (emulador_l80r.py --baudios-receptor auto) y remuestrea si no coinciden
+static void dispositivo_baudios(int baudios)
+{
+    static const struct { int baudios; speed_t velocidad; } tabla[] = {
+        { 4800, B4800 }, { 9600, B9600 }, { 19200, B19200 }, { 38400, B38400 },
+        { 57600, B57600 }, { 115200, B115200 }, { 230400, B230400 }, { 460800, B460800 },
+        { 921600, B921600 },
+    };
+    struct termios t;
+    if (!dispositivo_tty || tcgetattr(dispositivo, &t) != 0) return;
+    for (size_t i = 0; i < sizeof(tabla) / sizeof(tabla[0]); i++) {
+        if (tabla[i].baudios == baudios) {
+            cfsetspeed(&t, tabla[i].velocidad);
+            tcsetattr(dispositivo, TCSANOW, &t);
+            return;
+        }
+    }
+}
+
+// Pasa del dispositivo al buffer del driver lo que entra; el resto queda en el
+// dispositivo (el emisor ve la contrapresión). false si no entró nada.
+static bool dispositivo_leer(sim_uart_t *u)
+{
+    uint8_t buf[512];
+    bool recibio = false;
+    while (1) {
+        size_t lugar = u->instalado ? u->rx_cap - u->rx_n : sizeof(buf);
+        if (lugar == 0) break;
+        ssize_t n = read(dispositivo, buf, lugar < sizeof(buf) ? lugar : sizeof(buf));
+        if (n <= 0) break;
+        dispositivo_bytes += (uint32_t)n;
+        recibio = true;
+        if (!u->instalado) continue;        // sin driver, el UART los descarta
+        for (ssize_t i = 0; i < n; i++) u->rx[(u->rx_cabeza + u->rx_n++) % u->rx_cap] = buf[i];
+    }
+    return recibio;
+}
+
+static bool dispositivo_listo(void)
+{
+    sim_uart_t *u = &uarts[GPS_UART_NUM];
+    if (!dispositivo_leer(u)) return false;
+    sim_despertar(u);
+    return true;
+}
+
+bool sim_dispositivo_abrir(const char *ruta)
+{
+    dispositivo = open(ruta, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (dispositivo < 0) return false;
+
+    struct termios t;
+    if (tcgetattr(dispositivo, &t) == 0) {
+        cfmakeraw(&t);              // sin eco ni edición de línea
+        tcsetattr(dispositivo, TCSANOW, &t);
+        dispositivo_tty = true;
+    }
+    dispositivo_baudios(CONFIG_GPS_BAUD_RATE);
+    sim_tiempo_real(dispositivo, dispositivo_listo);
+    return true;
+}
+
+// Pasa al buffer del driver lo que llegó hasta ahora; sin lugar, se pierde
+static void recibir(sim_uart_t *u)
+{
+    if (dispositivo >= 0) {
+        dispositivo_leer(u);
+        return;
+    }
+    uint64_t ahora = sim_ahora_us();
+    while (siguiente < flujo_n && visible_us(siguiente) <= ahora) {
+        uint8_t b = flujo[siguiente++];
+        if (u->baudios != baudios_captura) b ^= 0x5A;    // baudios equivocados: basura
+        if (u->rx_n < u->rx_cap) {
+            u->rx[(u->rx_cabeza + u->rx_n++) % u->rx_cap] = b;
+        } else {
+            perdidos++;
+        }
+    }
+}
+
+static sim_uart_t *uart(uart_port_t puerto)
+{
+    return (puerto >= 0 && puerto < SIM_UART_MAX) ? &uarts[puerto] : NULL;
+}
+
+esp_err_t uart_param_config(uart_port_t puerto, const uart_config_t *config)
+{
+    sim_uart_t *u = uart(puerto);
+    if (u == NULL) return ESP_ERR_INVALID_ARG;
+    u->baudios = config->baud_rate;
+    if (puerto == GPS_UART_NUM) dispositivo_baudios(u->baudios);
+    return ESP_OK;
+}
+
+esp_err_t uart_set_pin(uart_port_t puerto, int tx, int rx, int rts, int cts) { return ESP_OK; }
+
+esp_err_t uart_driver_install(uart_port_t puerto, int rx_buffer, int tx_buffer, int cola, void *handle_cola, int flags)
+{
+    sim_uart_t *u = uart(puerto);
+    if (u == NULL || u->instalado) return ESP_ERR_INVALID_STATE;
+    u->instalado = true;
+    u->rx_cap = (uint32_t)rx_buffer;
+    u->rx = malloc(u->rx_cap);
+    u->tx_cap = (uint32_t)tx_buffer;
+    u->tx_fin_us = sim_ahora_us();
+
+    if (puerto != GPS_UART_NUM && sim_config.dir_tx) {
+        char ruta[512];
+        snprintf(ruta, sizeof(ruta), "%s/uart%d.bin", sim_config.dir_tx, puerto);
+        u->archivo_tx = fopen(ruta, "wb");
+    }
+    return ESP_OK;
+}
+
+esp_err_t uart_set_baudrate(uart_port_t puerto, uint32_t baudios)
+{
+    sim_uart_t *u = uart(puerto);
+    if (u == NULL) return ESP_ERR_INVALID_ARG;
+    if (puerto == GPS_UART_NUM) recibir(u);     // lo ya recibido fue con los baudios anteriores
+    u->baudios = (int)baudios;
+    if (puerto == GPS_UART_NUM) dispositivo_baudios(u->baudios);
+    return ESP_OK;
+}
+
+int uart_read_bytes(uart_port_t puerto, void *buf, uint32_t largo, TickType_t espera)
+{
+    sim_uart_t *u = uart(puerto);
+    if (u == NULL || !u->instalado) return -1;
+
+    uint64_t limite = espera == portMAX_DELAY ? SIM_SIN_LIMITE
+                                              : ((uint64_t)xTaskGetTickCount() + espera) * sim_tick_us();
+    while (1) {
+        if (puerto == GPS_UART_NUM) recibir(u);
+        if (u->rx_n >= largo || sim_ahora_us() >= limite) break;
+
+        // despertar cuando el driver tenga los bytes que faltan (o al vencer)
+        uint64_t t = limite;
+        uint32_t falta = largo - u->rx_n;
+        if (puerto == GPS_UART_NUM && siguiente + falta - 1 < flujo_n) {
+            uint64_t v = visible_us(siguiente + falta - 1);
+            if (v < t) t = v;
+        }
+        sim_esperar_hasta(t, u);
+    }
+
+    uint32_t n = u->rx_n < largo ? u->rx_n : largo;
+    for (uint32_t i = 0; i < n; i++) ((uint8_t *)buf)[i] = u->rx[(u->rx_cabeza + i) % u->rx_cap];
+    u->rx_cabeza = (u->rx_cabeza + n) % (u->rx_cap ? u->rx_cap : 1);
+    u->rx_n -= n;
+    if (puerto == GPS_UART_NUM) entregados += n;
+    return (int)n;
+}
+
+static void registrar_tx(uart_port_t puerto, sim_uart_t *u, const uint8_t *src, size_t largo)
+{
+    if (u->archivo_tx) fwrite(src, 1, largo, u->archivo_tx);
+    if (puerto != GPS_UART_NUM) return;
+    // EAGAIN: el otro extremo no lee; EIO: ya se cerró (el planificador lo ve y termina)
+    if (dispositivo >= 0 && write(dispositivo, src, largo) < 0 && errno != EAGAIN && errno != EIO)
+        perror("sim: dispositivo");
+
+    for (size_t i = 0; i < largo; i++) {
+        char c = (char)src[i];
+        if (c == '\n' || u->largo_linea_tx == sizeof(u->linea_tx) - 1) {
+            u->linea_tx[u->largo_linea_tx] = '\0';
+            if (u->largo_linea_tx) sim_evento("uart%d tx %s", puerto, u->linea_tx);
+            u->largo_linea_tx = 0;
+        } else if (c != '\r') {
+            u->linea_tx[u->largo_linea_tx++] = c;
+        }
+    }
+}
+
+int uart_write_bytes(uart_port_t puerto, const void *src, size_t largo)
+{
+    sim_uart_t *u = uart(puerto);
+    if (u == NULL || !u->instalado) return -1;
+    registrar_tx(puerto, u, src, largo);
+
+    // sale a los baudios del puerto; la llamada vuelve cuando lo que queda entra
+    // en el buffer TX más la FIFO de hardware
+    uint64_t ahora = sim_ahora_us();
+    uint64_t ns = simbolo_ns(u->baudios);
+    if (u->tx_fin_us < ahora) u->tx_fin_us = ahora;
+    u->tx_fin_us += largo * ns / 1000;
+    uint64_t en_cola_us = (uint64_t)(u->tx_cap + UART_FIFO_HW) * ns / 1000;
+    if (u->tx_fin_us > ahora + en_cola_us) sim_esperar_hasta(u->tx_fin_us - en_cola_us, NULL);
+    return (int)largo;
+}
+
+esp_err_t uart_get_tx_buffer_free_size(uart_port_t puerto, size_t *libre)
+{
+    sim_uart_t *u = uart(puerto);
+    if (u == NULL || !u->instalado) return ESP_ERR_INVALID_ARG;
+    uint64_t ahora = sim_ahora_us();
+    uint64_t pendientes = u->tx_fin_us > ahora ? ((u->tx_fin_us - ahora) * 1000 + simbolo_ns(u->baudios) - 1) / simbolo_ns(u->baudios) : 0;
+    uint64_t en_buffer = pendientes > UART_FIFO_HW ? pendientes - UART_FIFO_HW : 0;
+    *libre = en_buffer < u->tx_cap ? u->tx_cap - (size_t)en_buffer : 0;
+    return ESP_OK;
+}
+
+esp_err_t uart_wait_tx_done(uart_port_t puerto, TickType_t espera)
+{
+    sim_uart_t *u = uart(puerto);
+    if (u == NULL || !u->instalado) return ESP_ERR_INVALID_ARG;
+    if (u->tx_fin_us <= sim_ahora_us()) return ESP_OK;
+
+    uint64_t limite = espera == portMAX_DELAY ? SIM_SIN_LIMITE
+                                              : ((uint64_t)xTaskGetTickCount() + espera) * sim_tick_us();
+    if (limite < u->tx_fin_us) {
+        sim_esperar_hasta(limite, NULL);
+        return ESP_ERR_TIMEOUT;
+    }
+    sim_esperar_hasta(u->tx_fin_us, NULL);
+    return ESP_OK;
+}
+
+esp_err_t uart_flush_input(uart_port_t puerto)
+{
+    sim_uart_t *u = uart(puerto);
+    if (u == NULL || !u->instalado) return ESP_ERR_INVALID_ARG;
+    if (puerto == GPS_UART_NUM) recibir(u);
+    u->rx_n = 0;
+    sim_despertar(u);           // un lector esperando recalcula cuándo tendrá datos
+    return ESP_OK;
+}
+
+esp_err_t uart_flush(uart_port_t puerto) { return uart_flush_input(puerto); }
+
+esp_err_t uart_get_buffered_data_len(uart_port_t puerto, size_t *largo)
+{
+    sim_uart_t *u = uart(puerto);
+    if (u == NULL || !u->instalado) return ESP_ERR_INVALID_ARG;
+    if (puerto == GPS_UART_NUM) recibir(u);
+    *largo = u->rx_n;
+    return ESP_OK;
+}
+
+// ===========================================================
+//  NVS
+// ===========================================================
+// Archivo de respaldo: una línea por clave, "espacio clave tipo hex"
+#define NVS_ESPACIOS_MAX    8
+#define NVS_CLAVES_MAX      64
+#define NVS_VALOR_MAX       512
+
+typedef enum { NVS_U8, NVS_U16, NVS_U32, NVS_I32, NVS_BLOB } tipo_nvs_t;
+static const char *nombre_tipo[] = { "u8", "u16", "u32", "i32", "blob" };
+
+typedef struct {
+    uint8_t espacio;
+    char clave[16];
+    tipo_nvs_t tipo;
+    uint16_t largo;
+    uint8_t valor[NVS_VALOR_MAX];
+} entrada_nvs_t;
+
+static char espacios[NVS_ESPACIOS_MAX][16];
+static int n_espacios = 0;
+static entrada_nvs_t entradas[NVS_CLAVES_MAX];
+static int n_entradas = 0;
+static bool nvs_iniciada = false;
+static bool nvs_sucia = false;
+
+static int buscar_espacio(const char *nombre, bool crear)
+{
+    for (int i = 0; i < n_espacios; i++) if (strcmp(espacios[i], nombre) == 0) return i;
+    if (!crear || n_espacios == NVS_ESPACIOS_MAX) return -1;
+    snprintf(espacios[n_espacios], sizeof(espacios[0]), "%s", nombre);
+    return n_espacios++;
+}
+
+static entrada_nvs_t *buscar_entrada(int espacio, const char *clave)
+{
+    for (int i = 0; i < n_entradas; i++) {
+        if (entradas[i].espacio == espacio && strcmp(entradas[i].clave, clave) == 0) return &entradas[i];
+    }
+    return NULL;
+}
+
+static void cargar_nvs(void)
+{
+    FILE *f = sim_config.nvs ? fopen(sim_config.nvs, "r") : NULL;
+    if (f == NULL) return;
+
+    char espacio[16], clave[16], tipo[8], hex[2 * NVS_VALOR_MAX + 1];
+    while (n_entradas < NVS_CLAVES_MAX && fscanf(f, "%15s %15s %7s %1024s", espacio, clave, tipo, hex) == 4) {
+        entrada_nvs_t *e = &entradas[n_entradas];
+        int t = 0;
+        while (t <= NVS_BLOB && strcmp(nombre_tipo[t], tipo) != 0) t++;
+        if (t > NVS_BLOB) continue;
+        e->espacio = (uint8_t)buscar_espacio(espacio, true);
+        snprintf(e->clave, sizeof(e->clave), "%s", clave);
+        e->tipo = (tipo_nvs_t)t;
+        e->largo = (uint16_t)(strlen(hex) / 2);
+        for (int i = 0; i < e->largo; i++) sscanf(hex + 2 * i, "%2hhx", &e->valor[i]);
+        n_entradas++;
+    }
+    fclose(f);
+}
+
+static void guardar_nvs(void)
+{
+    FILE *f = sim_config.nvs ? fopen(sim_config.nvs, "w") : NULL;
+    if (f == NULL) return;
+    for (int i = 0; i < n_entradas; i++) {
+        const entrada_nvs_t *e = &entradas[i];
+        fprintf(f, "%s %s %s ", espacios[e->espacio], e->clave, nombre_tipo[e->tipo]);
+        for (int k = 0; k < e->largo; k++) fprintf(f, "%02x", e->valor[k]);
+        fputc('\n', f);
+    }
+    fclose(f);
+}
+
+esp_err_t nvs_flash_init(void)
+{
+    if (!nvs_iniciada) cargar_nvs();
+    nvs_iniciada = true;
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    n_entradas = 0;
+    n_espacios = 0;
+    nvs_sucia = true;
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *espacio, nvs_open_mode_t modo, nvs_handle_t *handle)
+{
+    if (!nvs_iniciada) return ESP_ERR_NVS_NOT_INITIALIZED;
+    int i = buscar_espacio(espacio, modo == NVS_READWRITE);
+    if (i < 0) return ESP_ERR_NVS_NOT_FOUND;
+    *handle = (nvs_handle_t)(i + 1) | (modo == NVS_READONLY ? 0x100 : 0);
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle) { }
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    if (nvs_sucia) guardar_nvs();
+    nvs_sucia = false;
+    return ESP_OK;
+}
+
+static esp_err_t poner(nvs_handle_t handle, const char *clave, tipo_nvs_t tipo, const void *valor, size_t largo)
+{
+    if (handle & 0x100) return ESP_ERR_NVS_READ_ONLY;
+    if (largo > NVS_VALOR_MAX) return ESP_ERR_NVS_INVALID_LENGTH;
+    int espacio = (int)(handle & 0xff) - 1;
+
+    entrada_nvs_t *e = buscar_entrada(espacio, clave);
+    if (e && e->tipo == tipo && e->largo == largo && memcmp(e->valor, valor, largo) == 0)
+        return ESP_OK;          // como la NVS real: sin cambios no se escribe
+    if (e == NULL) {
+        if (n_entradas == NVS_CLAVES_MAX) return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        e = &entradas[n_entradas++];
+        e->espacio = (uint8_t)espacio;
+        snprintf(e->clave, sizeof(e->clave), "%s", clave);
+    }
+    e->tipo = tipo;
+    e->largo = (uint16_t)largo;
+    memcpy(e->valor, valor, largo);
+    nvs_sucia = true;
+
+    if (tipo == NVS_BLOB) {
+        sim_evento("nvs %s.%s blob %zu bytes", espacios[espacio], clave, largo);
+    } else {
+        int64_t v = 0;
+        switch (tipo) {
+            case NVS_U8:  v = *(const uint8_t *)valor; break;
+            case NVS_U16: v = *(const uint16_t *)valor; break;
+            case NVS_U32: v = *(const uint32_t *)valor; break;
+            default:      v = *(const int32_t *)valor; break;
+        }
+        sim_evento("nvs %s.%s = %lld", espacios[espacio], clave, (long long)v);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t leer(nvs_handle_t handle, const char *clave, tipo_nvs_t tipo, void *valor, size_t *largo)
+{
+    entrada_nvs_t *e = buscar_entrada((int)(handle & 0xff) - 1, clave);
+    if (e == NULL) return ESP_ERR_NVS_NOT_FOUND;
+    if (e->tipo != tipo) return ESP_ERR_NVS_TYPE_MISMATCH;
+    if (valor == NULL) {
+        *largo = e->largo;
+        return ESP_OK;
+    }
+    if (*largo < e->largo) return ESP_ERR_NVS_INVALID_LENGTH;
+    memcpy(valor, e->valor, e->largo);
+    *largo = e->largo;
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *clave)
+{
+    entrada_nvs_t *e = buscar_entrada((int)(handle & 0xff) - 1, clave);
+    if (e == NULL) return ESP_ERR_NVS_NOT_FOUND;
+    *e = entradas[--n_entradas];
+    nvs_sucia = true;
+    return ESP_OK;
+}
+
+#define NVS_ESCALAR(sufijo, tipo_c, tipo_nvs)                                           \
+    esp_err_t nvs_set_##sufijo(nvs_handle_t h, const char *clave, tipo_c valor)         \
+    {                                                                                   \
+        return poner(h, clave, tipo_nvs, &valor, sizeof(valor));                        \
+    }                                                                                   \
+    esp_err_t nvs_get_##sufijo(nvs_handle_t h, const char *clave, tipo_c *valor)        \
+    {                                                                                   \
+        size_t largo = sizeof(*valor);                                                  \
+        return leer(h, clave, tipo_nvs, valor, &largo);                                 \
+    }
+
+NVS_ESCALAR(u8, uint8_t, NVS_U8)
+NVS_ESCALAR(u16, uint16_t, NVS_U16)
+NVS_ESCALAR(u32, uint32_t, NVS_U32)
+NVS_ESCALAR(i32, int32_t, NVS_I32)
+
+esp_err_t nvs_set_blob(nvs_handle_t h, const char *clave, const void *valor, size_t largo)
+{
+    return poner(h, clave, NVS_BLOB, valor, largo);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t h, const char *clave, void *valor, size_t *largo)
+{
+    return leer(h, clave, NVS_BLOB, valor, largo);
+}
+
+// ===========================================================
+//  PARTICIONES, SISTEMA Y ROM
+// ===========================================================
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t tipo, esp_partition_subtype_t subtipo,
+                                                const char *etiqueta)
+{
+    return NULL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *p, size_t offset, void *dst, size_t largo) { return ESP_ERR_NOT_FOUND; }
+esp_err_t esp_partition_write(const esp_partition_t *p, size_t offset, const void *src, size_t largo) { return ESP_ERR_NOT_FOUND; }
+esp_err_t esp_partition_erase_range(const esp_partition_t *p, size_t offset, size_t largo) { return ESP_ERR_NOT_FOUND; }
+
+esp_reset_reason_t esp_reset_reason(void) { return ESP_RST_POWERON; }
+
+void esp_restart(void)
+{
+    sim_evento("esp_restart");
+    sim_detener();
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+    crc = ~crc;
+    while (len--) {
+        crc ^= *buf++;
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1u));
+    }
+    return ~crc;
+}
@@ -0,0 +1,419 @@
+// FreeRTOS simulado: tareas en ucontext, colas y reloj virtual (ver sim.h)
+#define _GNU_SOURCE             // ppoll
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "modules/traza_freertos.h"
+#include "sim.h"
+
+// Mismos hooks que el kernel real: con CONFIG_TRAZA la traza sale en tiempo virtual
+#ifndef traceTASK_SWITCHED_IN
+#define traceTASK_SWITCHED_IN()
+#define traceTASK_SWITCHED_OUT()
+#define traceQUEUE_SEND(cola)
+#define traceQUEUE_RECEIVE(cola)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(cola)
+#define traceBLOCKING_ON_QUEUE_SEND(cola)
+#define traceTASK_DELAY()
+#endif
+
+#define SIM_TAREAS_MAX  32
+#define SIM_PILA        (256 * 1024)    // glibc (printf) pide mucho más que las pilas del ESP32
+
+typedef enum { TAREA_LISTA, TAREA_BLOQUEADA, TAREA_ELIMINADA } estado_tarea_t;
+
+struct sim_tarea {
+    ucontext_t ctx;
+    void *pila;
+    char nombre[16];
+    UBaseType_t prioridad;
+    TaskFunction_t fn;
+    void *arg;
+    estado_tarea_t estado;
+    uint64_t despertar_us;      // vencimiento de la espera (SIM_SIN_LIMITE: ninguno)
+    const void *objeto;         // cola o UART por el que espera
+    bool despertada;            // la despertó el objeto, no el vencimiento
+    uint64_t turno;             // orden de llegada entre las listas de igual prioridad
+};
+
+struct sim_cola {
+    uint8_t *datos;
+    UBaseType_t largo;
+    UBaseType_t tam_item;
+    UBaseType_t cabeza;
+    UBaseType_t n;
+};
+
+static struct sim_tarea *tareas[SIM_TAREAS_MAX];
+static int n_tareas = 0;
+static struct sim_tarea *actual = NULL;
+static ucontext_t ctx_planificador;
+
+static uint64_t ahora_us = 0;
+static uint64_t turnos = 0;
+static uint64_t cambios = 0;
+static bool detenido = false;
+
+// Tiempo real (sim_tiempo_real): el reloj sigue al de pared y, cuando todas las
+// tareas esperan, se duerme en el dispositivo hasta el próximo vencimiento
+static int fd_real = -1;
+static bool (*real_listo)(void) = NULL;
+static uint64_t real_origen_us = 0;
+static bool real_sin_lugar = false;     // el driver no recibió lo último: no volver a mirar el fd
+
+// ===========================================================
+//  RELOJ
+// ===========================================================
+uint64_t sim_ahora_us(void) { return ahora_us; }
+uint64_t sim_tick_us(void) { return 1000000ull / configTICK_RATE_HZ; }
+uint64_t sim_cambios_contexto(void) { return cambios; }
+
+int64_t esp_timer_get_time(void) { return (int64_t)ahora_us; }
+
+TickType_t xTaskGetTickCount(void) { return (TickType_t)(ahora_us / sim_tick_us()); }
+
+// Vencimiento de una espera de FreeRTOS: cuenta ticks desde el tick actual
+static uint64_t vencimiento(TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY) return SIM_SIN_LIMITE;
+    return ((uint64_t)xTaskGetTickCount() + ticks) * sim_tick_us();
+}
+
+// ===========================================================
+//  CAMBIO DE CONTEXTO
+// ===========================================================
+static void poner_lista(struct sim_tarea *t)
+{
+    t->estado = TAREA_LISTA;
+    t->turno = ++turnos;
+}
+
+static void ceder(void)
+{
+    swapcontext(&actual->ctx, &ctx_planificador);
+}
+
+// Si quedó lista una tarea de más prioridad, la actual le deja el núcleo
+// (conserva su turno: vuelve antes que otras de su misma prioridad)
+static void quizas_expropiar(void)
+{
+    if (actual == NULL) return;
+    for (int i = 0; i < n_tareas; i++) {
+        if (tareas[i]->estado == TAREA_LISTA && tareas[i]->prioridad > actual->prioridad) {
+            ceder();
+            return;
+        }
+    }
+}
+
+bool sim_esperar_hasta(uint64_t t_us, const void *objeto)
+{
+    actual->estado = TAREA_BLOQUEADA;
+    actual->despertar_us = t_us;
+    actual->objeto = objeto;
+    actual->despertada = false;
+    ceder();
+    return actual->despertada;
+}
+
+void sim_despertar(const void *objeto)
+{
+    for (int i = 0; i < n_tareas; i++) {
+        struct sim_tarea *t = tareas[i];
+        if (t->estado == TAREA_BLOQUEADA && t->objeto == objeto) {
+            t->despertada = true;
+            poner_lista(t);
+        }
+    }
+    quizas_expropiar();
+}
+
+// ===========================================================
+//  TAREAS
+// ===========================================================
+static void entrada(void)
+{
+    actual->fn(actual->arg);
+    // en FreeRTOS una tarea no debe volver; app_main sí (ESP-IDF la elimina)
+    if (strcmp(actual->nombre, "main") != 0)
+        fprintf(stderr, "sim: la tarea '%s' volvió de su función\n", actual->nombre);
+    vTaskDelete(NULL);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *nombre, uint32_t pila,
+                                   void *arg, UBaseType_t prioridad, TaskHandle_t *handle, BaseType_t nucleo)
+{
+    if (n_tareas == SIM_TAREAS_MAX) return pdFAIL;
+
+    struct sim_tarea *t = calloc(1, sizeof(*t));
+    t->pila = malloc(SIM_PILA);
+    snprintf(t->nombre, sizeof(t->nombre), "%s", nombre);
+    t->prioridad = prioridad;
+    t->fn = fn;
+    t->arg = arg;
+    getcontext(&t->ctx);
+    t->ctx.uc_stack.ss_sp = t->pila;
+    t->ctx.uc_stack.ss_size = SIM_PILA;
+    t->ctx.uc_link = NULL;
+    makecontext(&t->ctx, entrada, 0);
+
+    tareas[n_tareas++] = t;
+    poner_lista(t);
+    if (handle) *handle = t;
+
+    quizas_expropiar();
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t tarea)
+{
+    if (tarea == NULL || tarea == actual) {
+        actual->estado = TAREA_ELIMINADA;
+        ceder();
+        abort();    // una tarea eliminada no vuelve a correr
+    }
+    tarea->estado = TAREA_ELIMINADA;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    traceTASK_DELAY();
+    if (ticks == 0) {
+        taskYIELD();
+        return;
+    }
+    sim_esperar_hasta(vencimiento(ticks), NULL);
+}
+
+BaseType_t xTaskDelayUntil(TickType_t *previo, TickType_t incremento)
+{
+    TickType_t objetivo = *previo + incremento;
+    *previo = objetivo;
+    if ((int32_t)(objetivo - xTaskGetTickCount()) <= 0) return pdFALSE;
+    sim_esperar_hasta((uint64_t)objetivo * sim_tick_us(), NULL);
+    return pdTRUE;
+}
+
+void taskYIELD(void)
+{
+    poner_lista(actual);    // detrás de las otras listas de su prioridad
+    ceder();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) { return actual; }
+TaskHandle_t xTaskGetCurrentTaskHandleForCore(BaseType_t nucleo) { return nucleo == 0 ? actual : NULL; }
+UBaseType_t uxTaskPriorityGet(TaskHandle_t tarea) { return (tarea ? tarea : actual)->prioridad; }
+
+// La traza guarda los handles truncados a 32 bits: se buscan por esos bits
+char *pcTaskGetName(TaskHandle_t tarea)
+{
+    if (tarea == NULL) tarea = actual;
+    for (int i = 0; i < n_tareas; i++) {
+        if ((uint32_t)(uintptr_t)tareas[i] == (uint32_t)(uintptr_t)tarea) return tareas[i]->nombre;
+    }
+    return "?";
+}
+
+// ===========================================================
+//  COLAS
+// ===========================================================
+QueueHandle_t xQueueCreate(UBaseType_t largo, UBaseType_t tam_item)
+{
+    struct sim_cola *c = calloc(1, sizeof(*c));
+    c->datos = malloc((size_t)largo * tam_item);
+    c->largo = largo;
+    c->tam_item = tam_item;
+    return c;
+}
+
+void vQueueDelete(QueueHandle_t cola)
+{
+    free(cola->datos);
+    free(cola);
+}
+
+BaseType_t xQueueSend(QueueHandle_t c, const void *item, TickType_t espera)
+{
+    uint64_t limite = vencimiento(espera);
+    while (c->n == c->largo) {
+        if (espera == 0 || ahora_us >= limite) return pdFALSE;
+        traceBLOCKING_ON_QUEUE_SEND(c);
+        sim_esperar_hasta(limite, c);
+    }
+    memcpy(c->datos + (size_t)((c->cabeza + c->n) % c->largo) * c->tam_item, item, c->tam_item);
+    c->n++;
+    traceQUEUE_SEND(c);
+    sim_despertar(c);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t c, void *item, TickType_t espera)
+{
+    uint64_t limite = vencimiento(espera);
+    while (c->n == 0) {
+        if (espera == 0 || ahora_us >= limite) return pdFALSE;
+        traceBLOCKING_ON_QUEUE_RECEIVE(c);
+        sim_esperar_hasta(limite, c);
+    }
+    memcpy(item, c->datos + (size_t)c->cabeza * c->tam_item, c->tam_item);
+    c->cabeza = (c->cabeza + 1) % c->largo;
+    c->n--;
+    traceQUEUE_RECEIVE(c);
+    sim_despertar(c);
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t c) { return c->n; }
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t c) { return c->largo - c->n; }
+
+// ===========================================================
+//  SEMÁFOROS
+// ===========================================================
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    SemaphoreHandle_t s = xQueueCreate(1, 0);
+    s->n = 1;                   // libre
+    return s;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t espera)
+{
+    uint8_t nada;
+    return xQueueReceive(s, &nada, espera);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s) { return xQueueSend(s, "", 0); }
+
+// ===========================================================
+//  PLANIFICADOR
+// ===========================================================
+static struct sim_tarea *elegir(void)
+{
+    struct sim_tarea *mejor = NULL;
+    for (int i = 0; i < n_tareas; i++) {
+        struct sim_tarea *t = tareas[i];
+        if (t->estado != TAREA_LISTA) continue;
+        if (mejor == NULL || t->prioridad > mejor->prioridad ||
+            (t->prioridad == mejor->prioridad && t->turno < mejor->turno))
+            mejor = t;
+    }
+    return mejor;
+}
+
+static uint64_t pared_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+void sim_tiempo_real(int fd, bool (*listo)(void))
+{
+    fd_real = fd;
+    real_listo = listo;
+    real_origen_us = pared_us() - ahora_us;
+}
+
+// Tiempo real: duerme hasta el vencimiento o hasta que lleguen bytes al fd, y el
+// reloj pasa a la hora de pared. false al llegar a fin_us o si se cerró el otro extremo.
+static bool esperar_real(uint64_t hasta_us, uint64_t fin_us)
+{
+    struct pollfd p = { .fd = real_sin_lugar ? -1 : fd_real, .events = POLLIN };
+    struct timespec espera, *pespera = NULL;
+    if (hasta_us != SIM_SIN_LIMITE) {
+        uint64_t t = pared_us() - real_origen_us;
+        uint64_t falta = hasta_us > t ? hasta_us - t : 0;
+        espera.tv_sec = (time_t)(falta / 1000000);
+        espera.tv_nsec = (long)(falta % 1000000) * 1000;
+        pespera = &espera;
+    }
+    int r = ppoll(&p, 1, pespera, NULL);
+
+    uint64_t t = pared_us() - real_origen_us;
+    if (t > ahora_us) ahora_us = t;
+    if (r > 0 && (p.revents & (POLLHUP | POLLERR))) return false;
+    if (r > 0 && (p.revents & POLLIN)) real_sin_lugar = !real_listo();
+    if (ahora_us >= fin_us) {
+        ahora_us = fin_us;
+        return false;
+    }
+    return true;
+}
+
+// Todas esperan: el reloj salta al próximo vencimiento (o llega a él en tiempo
+// real). false si no hay ninguno antes de fin_us.
+static bool avanzar_reloj(uint64_t fin_us)
+{
+    uint64_t proximo = SIM_SIN_LIMITE;
+    for (int i = 0; i < n_tareas; i++) {
+        if (tareas[i]->estado == TAREA_BLOQUEADA && tareas[i]->despertar_us < proximo)
+            proximo = tareas[i]->despertar_us;
+    }
+    if (fd_real >= 0) {
+        if (!esperar_real(proximo < fin_us ? proximo : fin_us, fin_us)) return false;
+    } else {
+        if (proximo >= fin_us) {
+            ahora_us = fin_us;
+            return false;
+        }
+        if (proximo > ahora_us) ahora_us = proximo;
+    }
+    for (int i = 0; i < n_tareas; i++) {
+        if (tareas[i]->estado == TAREA_BLOQUEADA && tareas[i]->despertar_us <= ahora_us)
+            poner_lista(tareas[i]);
+    }
+    return true;
+}
+
+static void liberar_eliminadas(void)
+{
+    for (int i = 0; i < n_tareas; i++) {
+        if (tareas[i]->estado == TAREA_ELIMINADA && tareas[i]->pila) {
+            free(tareas[i]->pila);
+            tareas[i]->pila = NULL;
+        }
+    }
+}
+
+static void tarea_principal(void *arg)
+{
+    ((void (*)(void))arg)();
+}
+
+void sim_ejecutar(void (*principal)(void), uint64_t fin_us)
+{
+    xTaskCreate(tarea_principal, "main", 0, (void *)principal, 1, NULL);
+
+    while (!detenido) {
+        struct sim_tarea *t = elegir();
+        if (t == NULL) {
+            if (!avanzar_reloj(fin_us)) break;
+            continue;
+        }
+
+        actual = t;
+        cambios++;
+        traceTASK_SWITCHED_IN();
+        swapcontext(&ctx_planificador, &t->ctx);
+        traceTASK_SWITCHED_OUT();
+        actual = NULL;
+        real_sin_lugar = false;     // la tarea pudo haber vaciado el driver
+        liberar_eliminadas();
+    }
+}
+
+void sim_detener(void)
+{
+    detenido = true;
+    actual->estado = TAREA_ELIMINADA;
+    ceder();
+    abort();
+}
@@ -0,0 +1,34 @@
+#!/bin/sh
+# Corre el firmware en host (simulador -d) contra tools/emulador_l80r.py en un pty,
+# con el emulador exigiendo '$' y checksum como el L80-R real. Falla si el emulador
+# ignoró algún comando o si no llegó a aplicar la configuración inicial.
+#
+#   pmtk_emulador.sh python3 tools/emulador_l80r.py build_host/simulador_completo
+set -u
+python=$1
+emulador=$2
+simulador=$3
+
+dir=$(mktemp -d)
+trap 'kill $emu 2>/dev/null; rm -rf "$dir"' EXIT
+
+"$python" "$emulador" --enlace "$dir/l80r" --duracion 10 --estadisticas 0 2>"$dir/emulador.log" &
+emu=$!
+i=0
+while [ ! -e "$dir/l80r" ] && [ $i -lt 50 ]; do
+    sleep 0.1
+    i=$((i + 1))
+done
+
+"$simulador" -d "$dir/l80r" -t 6 -q -e "$dir/eventos.txt" || exit 1
+grep "uart1 tx" "$dir/eventos.txt"
+cat "$dir/emulador.log"
+
+if grep -q "ignorado" "$dir/emulador.log"; then
+    echo "el emulador ignoró comandos del firmware (falta '\$' o el checksum es inválido)"
+    exit 1
+fi
+if ! grep -q "intervalo de fix" "$dir/emulador.log" || ! grep -q "salidas:" "$dir/emulador.log"; then
+    echo "el emulador no aplicó la frecuencia o las tramas pedidas por el firmware"
+    exit 1
+fi
@@ -0,0 +1,67 @@
+#ifndef SIM_H
+#define SIM_H
+
+// Simulación del firmware completo en Linux (host/simulador).
+//
+// app_main y todas las tareas corren en un solo hilo, cada una con su contexto
+// (ucontext). El planificador es el de FreeRTOS en un núcleo: corre la tarea lista
+// de mayor prioridad, a igual prioridad por orden de llegada, y cambia solo cuando
+// la tarea se bloquea, cede o despierta a otra de más prioridad. El código corre
+// en tiempo virtual cero: el reloj avanza únicamente cuando todas las tareas
+// esperan, saltando al próximo vencimiento. Con la misma captura y el mismo
+// sdkconfig la ejecución es idéntica byte a byte.
+//
+// Con un dispositivo serie (sim_dispositivo_abrir) el reloj sigue al de pared y el
+// UART del GPS lee y escribe en él: el firmware corre contra un receptor vivo o
+// contra tools/emulador_l80r.py. Ahí la ejecución ya no es reproducible.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define SIM_SIN_LIMITE  UINT64_MAX
+
+// ==================== RELOJ Y PLANIFICADOR (planificador.c) ====================
+uint64_t sim_ahora_us(void);
+uint64_t sim_tick_us(void);
+
+// Bloquea la tarea actual hasta t_us o hasta sim_despertar(objeto).
+// Devuelve true si la despertaron antes del vencimiento.
+bool sim_esperar_hasta(uint64_t t_us, const void *objeto);
+void sim_despertar(const void *objeto);
+
+// Corre principal como tarea "main" (prioridad 1, como en ESP-IDF) hasta fin_us
+void sim_ejecutar(void (*principal)(void), uint64_t fin_us);
+// Termina la simulación desde una tarea (esp_restart); no vuelve
+void sim_detener(void) __attribute__((noreturn));
+uint64_t sim_cambios_contexto(void);
+// Pasa a tiempo real: mientras todas esperan, duerme en fd; cuando tiene datos
+// llama a listo, que devuelve false si no pudo recibir nada (driver lleno)
+void sim_tiempo_real(int fd, bool (*listo)(void));
+
+// ==================== PERIFÉRICOS (perifericos.c) ====================
+typedef struct {
+    FILE *eventos;              // registro de eventos (comparable con una referencia)
+    FILE *log;                  // ESP_LOGx del firmware; NULL para descartar
+    const char *nvs;            // archivo de respaldo de la NVS; NULL = solo memoria
+    const char *dir_tx;         // lo transmitido por los UART que no son el GPS
+} sim_config_t;
+
+extern sim_config_t sim_config;
+
+void sim_evento(const char *formato, ...) __attribute__((format(printf, 1, 2)));
+
+// Arma el flujo del UART del GPS: cada época (cambio de hora en RMC/GGA) empieza
+// retardo_us + (hora - primera hora) y sus líneas salen seguidas a esos baudios
+bool sim_captura_cargar(const char *ruta, int baudios, uint64_t retardo_us);
+uint64_t sim_captura_fin_us(void);
+uint32_t sim_captura_bytes(void);
+// En vez de una captura, el UART del GPS es este dispositivo (pty, /dev/ttyUSB0):
+// sus baudios siguen a los del firmware y lo que no entra en el driver queda en el
+// dispositivo. Pasa la simulación a tiempo real.
+bool sim_dispositivo_abrir(const char *ruta);
+uint32_t sim_dispositivo_bytes(void);
+uint32_t sim_uart_bytes_entregados(void);
+uint32_t sim_uart_bytes_perdidos(void);
+
+#endif // SIM_H
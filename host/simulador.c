@@ -0,0 +1,167 @@
+// Firmware completo en host con tiempo virtual (host/sim):
+//
+//   simulador [-e eventos.txt] [-g referencia.txt] [-l log.txt|-q] [-n nvs.txt]
+//             [-b baudios] [-r retardo_ms=500] [-c cola_s=5] [-t fin_s] [-x dir] captura.nmea
+//   simulador -d dispositivo [-e eventos.txt] [-l log.txt|-q] [-n nvs.txt] [-t fin_s] [-x dir]
+//
+//   Corre app_main y todas las tareas del sdkconfig del proyecto contra la captura,
+//   que llega por el UART del GPS con los tiempos de un receptor real. Un viaje de
+//   8 horas se reproduce en segundos y siempre igual.
+//
+//   Eventos (-e, por defecto stdout) con tiempo virtual en segundos: valores del
+//   display, buzzer, LED, reset del receptor, comandos enviados al receptor y
+//   escrituras en NVS. Con -g se comparan con una salida de referencia guardada
+//   antes: cualquier cambio de tiempos (una demora nueva en una tarea, otra
+//   prioridad) aparece como diferencia y el código de salida es 1.
+//
+//   -l guarda el log del firmware (ESP_LOGx) en un archivo; -q lo descarta; por
+//   defecto va a stdout intercalado con los eventos. -n respalda la NVS en un
+//   archivo de texto (se lee al arrancar: sirve para encadenar viajes). -x guarda
+//   lo transmitido por los demás UART (telemetría, reenvío NMEA) en dir/uartN.bin.
+//   -b son los baudios de la captura (por defecto CONFIG_GPS_BAUD_RATE), -r cuándo
+//   llega el primer byte, -c cuánto se sigue simulando después del último y -t
+//   corta la simulación a esa hora virtual.
+//
+//   -d cambia la captura por un dispositivo serie (el pty de tools/emulador_l80r.py,
+//   un receptor en /dev/ttyUSB0) y corre en tiempo real: task_gps_read_and_parse
+//   lee lo que llega, los comandos al receptor salen por el dispositivo y lo que no
+//   entra en el buffer del driver queda del lado del emisor. Termina con -t o
+//   cuando se cierra el otro extremo.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sdkconfig.h"
+#include "sim/sim.h"
+
+void app_main(void);
+
+static double segundos_reales(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Primera diferencia contra la referencia; devuelve cuántas líneas difieren
+static int comparar(FILE *obtenido, const char *ruta_referencia)
+{
+    FILE *ref = fopen(ruta_referencia, "r");
+    if (ref == NULL) {
+        perror(ruta_referencia);
+        return -1;
+    }
+    rewind(obtenido);
+
+    char a[512], b[512];
+    int linea = 0, diferencias = 0;
+    while (1) {
+        char *ra = fgets(a, sizeof(a), ref);
+        char *rb = fgets(b, sizeof(b), obtenido);
+        if (ra == NULL && rb == NULL) break;
+        linea++;
+        if (ra && rb && strcmp(a, b) == 0) continue;
+        if (diferencias++ == 0) {
+            fprintf(stderr, "primera diferencia en la línea %d:\n", linea);
+            fprintf(stderr, "  referencia: %s", ra ? a : "(fin)\n");
+            fprintf(stderr, "  obtenido:   %s", rb ? b : "(fin)\n");
+        }
+    }
+    fclose(ref);
+    return diferencias;
+}
+
+int main(int argc, char **argv)
+{
+    const char *ruta_eventos = NULL, *referencia = NULL, *ruta_log = NULL, *ruta_dispositivo = NULL;
+    int baudios = CONFIG_GPS_BAUD_RATE;
+    double retardo_ms = 500, cola_s = 5, fin_s = -1;
+    bool silencio = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "e:g:l:qn:b:r:c:t:x:d:")) != -1) {
+        switch (opt) {
+            case 'e': ruta_eventos = optarg; break;
+            case 'g': referencia = optarg; break;
+            case 'l': ruta_log = optarg; break;
+            case 'q': silencio = true; break;
+            case 'n': sim_config.nvs = optarg; break;
+            case 'b': baudios = atoi(optarg); break;
+            case 'r': retardo_ms = atof(optarg); break;
+            case 'c': cola_s = atof(optarg); break;
+            case 't': fin_s = atof(optarg); break;
+            case 'x': sim_config.dir_tx = optarg; break;
+            case 'd': ruta_dispositivo = optarg; break;
+            default: optind = argc + 1; break;
+        }
+    }
+    if (optind != argc - (ruta_dispositivo ? 0 : 1) || baudios <= 0 || (ruta_dispositivo && referencia)) {
+        fprintf(stderr, "uso: simulador [-e eventos.txt] [-g referencia.txt] [-l log.txt|-q] [-n nvs.txt] "
+                        "[-b baudios] [-r retardo_ms] [-c cola_s] [-t fin_s] [-x dir] captura.nmea\n"
+                        "     simulador -d dispositivo [-e eventos.txt] [-l log.txt|-q] [-n nvs.txt] "
+                        "[-t fin_s] [-x dir]\n");
+        return 2;
+    }
+
+    if (ruta_dispositivo) {
+        if (!sim_dispositivo_abrir(ruta_dispositivo)) {
+            perror(ruta_dispositivo);
+            return 2;
+        }
+    } else if (!sim_captura_cargar(argv[optind], baudios, (uint64_t)(retardo_ms * 1000))) {
+        fprintf(stderr, "%s: no se pudo leer o está vacía\n", argv[optind]);
+        return 2;
+    }
+
+    // con -g y sin -e los eventos van a un temporal solo para comparar
+    if (ruta_eventos) {
+        sim_config.eventos = fopen(ruta_eventos, "w+");
+        if (sim_config.eventos == NULL) { perror(ruta_eventos); return 2; }
+    } else {
+        sim_config.eventos = referencia ? tmpfile() : stdout;
+    }
+    if (ruta_log) {
+        sim_config.log = fopen(ruta_log, "w");
+        if (sim_config.log == NULL) { perror(ruta_log); return 2; }
+    } else {
+        sim_config.log = silencio ? NULL : stdout;
+    }
+
+    uint64_t fin_us = fin_s >= 0 ? (uint64_t)(fin_s * 1e6)
+                    : ruta_dispositivo ? SIM_SIN_LIMITE
+                    : sim_captura_fin_us() + (uint64_t)(cola_s * 1e6);
+
+    double t0 = segundos_reales();
+    sim_ejecutar(app_main, fin_us);
+    double real = segundos_reales() - t0;
+
+    fflush(sim_config.eventos);
+    if (sim_config.log) fflush(sim_config.log);
+
+    double virtual_s = sim_ahora_us() / 1e6;
+    if (ruta_dispositivo) {
+        fprintf(stderr, "%.1f s en tiempo real, %llu cambios de contexto, UART GPS: %u bytes del dispositivo, "
+                        "%u entregados a la tarea lectora\n",
+                virtual_s, (unsigned long long)sim_cambios_contexto(), sim_dispositivo_bytes(),
+                sim_uart_bytes_entregados());
+        return 0;
+    }
+    fprintf(stderr, "%.1f s virtuales en %.2f s (x%.0f), %llu cambios de contexto, "
+                    "UART GPS: %u de %u bytes entregados, %u perdidos por buffer lleno\n",
+            virtual_s, real, real > 0 ? virtual_s / real : 0.0, (unsigned long long)sim_cambios_contexto(),
+            sim_uart_bytes_entregados(), sim_captura_bytes(), sim_uart_bytes_perdidos());
+
+    if (referencia) {
+        int diferencias = comparar(sim_config.eventos, referencia);
+        if (diferencias < 0) return 2;
+        if (diferencias > 0) {
+            fprintf(stderr, "%d líneas distintas de %s\n", diferencias, referencia);
+            return 1;
+        }
+        fprintf(stderr, "eventos idénticos a %s\n", referencia);
+    }
+    return 0;
+}
@@ -0,0 +1,342 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_log.h>
+#include <esp_cpu.h>
+
+#include "bench/bench_hotpaths.h"
+#include "modules/gps_l80r.h"
+#include "modules/monitor_velocidad.h"
+#include "screens/display_7seg.h"
+#if CONFIG_MONITOR_REGLAS
+#include "modules/reglas.h"
+#endif
+#if CONFIG_NMEA_REENVIO
+#include <driver/uart.h>
+#include "modules/reenvio_nmea.h"
+#endif
+
+static const char *TAG = "BENCH";
+
+// Captura embebida con EMBED_TXTFILES (main/CMakeLists.txt)
+extern const char captura_nmea_start[] asm("_binary_captura_nmea_txt_start");
+extern const char captura_nmea_end[]   asm("_binary_captura_nmea_txt_end");
+
+#define BENCH_MAX_LINEAS 1024
+
+static char *lineas[BENCH_MAX_LINEAS];
+static int n_lineas = 0;
+static uint32_t *muestras = NULL;
+static int n_muestras = 0;
+static uint32_t overhead = 0;  // costo de leer el contador dos veces
+
+// evita que el compilador descarte resultados no usados
+static volatile double sumidero;
+
+// ===========================================================
+//  PREPARAR CAPTURA: copia a RAM y separa en líneas
+// ===========================================================
+static bool preparar_captura(void)
+{
+    size_t len = captura_nmea_end - captura_nmea_start;
+    char *copia = malloc(len + 1);
+    if (copia == NULL) {
+        ESP_LOGE(TAG, "Sin memoria para la captura (%u bytes)", (unsigned)len);
+        return false;
+    }
+    memcpy(copia, captura_nmea_start, len);
+    copia[len] = '\0';
+
+    char *inicio = copia;
+    char *nl;
+    while ((nl = strchr(inicio, '\n')) != NULL && n_lineas < BENCH_MAX_LINEAS) {
+        *nl = 0;
+        if (nl > inicio && *(nl-1) == '\r') {
+            *(nl-1) = 0;
+        }
+        lineas[n_lineas++] = inicio;
+        inicio = nl + 1;
+    }
+
+    muestras = malloc(sizeof(uint32_t) * n_lineas * CONFIG_BENCHMARK_REPETICIONES);
+    if (muestras == NULL) {
+        ESP_LOGE(TAG, "Sin memoria para las muestras");
+        return false;
+    }
+
+    ESP_LOGI(TAG, "Captura: %u bytes, %d líneas", (unsigned)len, n_lineas);
+    return true;
+}
+
+// ===========================================================
+//  ESTADÍSTICAS
+// ===========================================================
+static int comparar_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static inline void registrar(uint32_t t0, uint32_t t1)
+{
+    uint32_t d = t1 - t0;
+    muestras[n_muestras++] = (d > overhead) ? d - overhead : 0;
+}
+
+static void reportar(const char *nombre)
+{
+    if (n_muestras == 0) return;
+    qsort(muestras, n_muestras, sizeof(uint32_t), comparar_u32);
+    printf("BENCH %-22s n=%-6d min=%-7lu med=%-7lu max=%lu\n", nombre, n_muestras,
+           (unsigned long)muestras[0],
+           (unsigned long)muestras[n_muestras / 2],
+           (unsigned long)muestras[n_muestras - 1]);
+    n_muestras = 0;
+}
+
+static void calibrar_overhead(void)
+{
+    overhead = UINT32_MAX;
+    for (int i = 0; i < 1000; i++) {
+        uint32_t t0 = esp_cpu_get_cycle_count();
+        uint32_t t1 = esp_cpu_get_cycle_count();
+        if (t1 - t0 < overhead) overhead = t1 - t0;
+    }
+}
+
+// ===========================================================
+//  MEDICIONES
+// ===========================================================
+static void bench_checksum(void)
+{
+    for (int r = 0; r < CONFIG_BENCHMARK_REPETICIONES; r++) {
+        for (int i = 0; i < n_lineas; i++) {
+            uint32_t t0 = esp_cpu_get_cycle_count();
+            bool ok = nmea_verify_checksum(lineas[i]);
+            uint32_t t1 = esp_cpu_get_cycle_count();
+            sumidero = ok;
+            registrar(t0, t1);
+        }
+    }
+    reportar("nmea_verify_checksum");
+}
+
+static void bench_parsers(void)
+{
+    gps_data_t d;
+    for (int r = 0; r < CONFIG_BENCHMARK_REPETICIONES; r++) {
+        for (int i = 0; i < n_lineas; i++) {
+            if (strncmp(lineas[i], "$GPRMC", 6) != 0) continue;
+            uint32_t t0 = esp_cpu_get_cycle_count();
+            gps_parse_gprmc(lineas[i], &d);
+            uint32_t t1 = esp_cpu_get_cycle_count();
+            sumidero = d.speed_kmh;
+            registrar(t0, t1);
+        }
+    }
+    reportar("gps_parse_gprmc");
+
+#if CONFIG_GPS_PARSE_GGA
+    gps_quality_t q;
+    for (int r = 0; r < CONFIG_BENCHMARK_REPETICIONES; r++) {
+        for (int i = 0; i < n_lineas; i++) {
+            if (strncmp(lineas[i], "$GPGGA", 6) != 0) continue;
+            uint32_t t0 = esp_cpu_get_cycle_count();
+            gps_parse_gpgga(lineas[i], &q);
+            uint32_t t1 = esp_cpu_get_cycle_count();
+            sumidero = q.hdop;
+            registrar(t0, t1);
+        }
+    }
+    reportar("gps_parse_gpgga");
+#endif
+}
+
+static void bench_nmea_to_decimal(void)
+{
+    for (int r = 0; r < CONFIG_BENCHMARK_REPETICIONES; r++) {
+        for (int i = 0; i < n_lineas; i++) {
+            // valores ddmm.mmmm distintos por línea para no medir siempre el mismo
+            double v = 3326.0 + (i % 6000) / 100.0;
+            uint32_t t0 = esp_cpu_get_cycle_count();
+            double g = nmea_to_decimal(v, (i & 1) ? 'S' : 'W');
+            uint32_t t1 = esp_cpu_get_cycle_count();
+            sumidero = g;
+            registrar(t0, t1);
+        }
+    }
+    reportar("nmea_to_decimal");
+}
+
+#if CONFIG_GPS_KALMAN
+static void bench_kalman(void)
+{
+    kalman_t kf;
+    kalman_init(&kf, CONFIG_GPS_KALMAN_Q_MILI / 1000.0, CONFIG_GPS_KALMAN_R_MILI / 1000.0);
+    for (int r = 0; r < CONFIG_BENCHMARK_REPETICIONES; r++) {
+        for (int i = 0; i < n_lineas; i++) {
+            double medida = 30.0 + (i % 20);
+            uint32_t t0 = esp_cpu_get_cycle_count();
+            double e = kalman_update(&kf, medida);
+            uint32_t t1 = esp_cpu_get_cycle_count();
+            sumidero = e;
+            registrar(t0, t1);
+        }
+    }
+    reportar("kalman_update");
+}
+#endif
+
+static void bench_show_digit(void)
+{
+    for (int r = 0; r < CONFIG_BENCHMARK_REPETICIONES; r++) {
+        for (int i = 0; i < n_lineas; i++) {
+            uint32_t t0 = esp_cpu_get_cycle_count();
+            show_digit(1 + (i % 3), i % 10);
+            uint32_t t1 = esp_cpu_get_cycle_count();
+            registrar(t0, t1);
+        }
+    }
+    reportar("show_digit");
+}
+
+// Trama completa → decisión: lo que hace el lector por línea más la
+// comparación con el umbral que hace el monitor
+static void bench_trama_a_decision(void)
+{
+    double umbral = monitor_velocidad_get_umbral();
+    bool sobre_umbral = false;
+    uint32_t eventos = 0;
+
+    for (int r = 0; r < CONFIG_BENCHMARK_REPETICIONES; r++) {
+        for (int i = 0; i < n_lineas; i++) {
+            uint32_t t0 = esp_cpu_get_cycle_count();
+            procesar_sentencia_nmea(lineas[i]);
+            double vel = gps_get_speed_kmh();
+            if (gps_is_valid() && vel > umbral) {
+                if (!sobre_umbral) eventos++;
+                sobre_umbral = true;
+            } else {
+                sobre_umbral = false;
+            }
+            uint32_t t1 = esp_cpu_get_cycle_count();
+            registrar(t0, t1);
+        }
+    }
+    reportar("trama_a_decision");
+    ESP_LOGI(TAG, "Eventos detectados en la captura: %lu", (unsigned long)eventos);
+}
+
+#if CONFIG_MONITOR_REGLAS
+// Pasada por fix con la tabla llena (REGLAS_MAX reglas de todos los tipos)
+static void bench_reglas(void)
+{
+    static reglas_tabla_t tabla;
+    static reglas_estado_t estado;
+    char texto[REGLAS_MAX * 64];
+    size_t pos = 0;
+    for (int i = 0; i < REGLAS_MAX; i++) {
+        switch (i % 4) {
+            case 0: pos += snprintf(texto + pos, sizeof(texto) - pos, "r%d: vel > %d durante %d histeresis 2\n", i, 20 + i, i % 3 * 5); break;
+            case 1: pos += snprintf(texto + pos, sizeof(texto) - pos, "r%d: acel > %d alerta largo\n", i, 6 + i % 5); break;
+            case 2: pos += snprintf(texto + pos, sizeof(texto) - pos, "r%d: vel > %d franja %02d:00-%02d:30\n", i, 30 + i, i % 24, (i + 6) % 24); break;
+            default: pos += snprintf(texto + pos, sizeof(texto) - pos, "r%d: vel < %d durante 60 alerta ninguna\n", i, 2 + i % 4); break;
+        }
+    }
+    char error[80];
+    if (reglas_compilar(texto, CONFIG_MONITOR_REGLAS_HUSO_MIN, &tabla, error, sizeof(error)) != 0) {
+        ESP_LOGE(TAG, "Tabla de reglas del bench: %s", error);
+        return;
+    }
+
+    gps_data_t d;
+    uint32_t eventos = 0;
+    for (int r = 0; r < CONFIG_BENCHMARK_REPETICIONES; r++) {
+        reglas_estado_init(&estado);
+        for (int i = 0; i < n_lineas; i++) {
+            if (strncmp(lineas[i], "$GPRMC", 6) != 0 || !gps_parse_gprmc(lineas[i], &d)) continue;
+            reglas_entrada_t in = {
+                .vel_kmh = (float)d.speed_kmh,
+                .t_ms = (uint32_t)(i * 100),
+                .minuto_dia = reglas_minuto_dia(d.time, tabla.huso_min),
+            };
+            uint32_t t0 = esp_cpu_get_cycle_count();
+            eventos += __builtin_popcount(reglas_evaluar(&tabla, &estado, &in));
+            uint32_t t1 = esp_cpu_get_cycle_count();
+            registrar(t0, t1);
+        }
+    }
+    reportar("reglas_evaluar_32");
+    ESP_LOGI(TAG, "Eventos de reglas en la captura: %lu", (unsigned long)eventos);
+}
+#endif
+
+#if CONFIG_NMEA_REENVIO
+// Costo agregado al lector por línea reenviada: filtro + un uart_write_bytes al
+// buffer TX. Se espera a que el TX se vacíe entre líneas (fuera de la medición)
+// para medir el camino de envío y no el de descarte.
+static void bench_reenvio(void)
+{
+    for (int r = 0; r < CONFIG_BENCHMARK_REPETICIONES; r++) {
+        for (int i = 0; i < n_lineas; i++) {
+            uart_wait_tx_done(CONFIG_NMEA_REENVIO_UART_PORT_NUM, pdMS_TO_TICKS(200));
+            uint32_t t0 = esp_cpu_get_cycle_count();
+            reenvio_nmea_linea(lineas[i]);
+            uint32_t t1 = esp_cpu_get_cycle_count();
+            registrar(t0, t1);
+        }
+    }
+    reportar("reenvio_nmea_linea");
+    ESP_LOGI(TAG, "Reenvío: %lu enviadas, %lu filtradas, %lu descartadas",
+             (unsigned long)reenvio_nmea_get_lineas_enviadas(),
+             (unsigned long)reenvio_nmea_get_lineas_filtradas(),
+             (unsigned long)reenvio_nmea_get_lineas_descartadas());
+}
+#endif
+
+// ===========================================================
+//  PUNTO DE ENTRADA
+// ===========================================================
+void bench_ejecutar(void)
+{
+    if (!preparar_captura()) return;
+    calibrar_overhead();
+
+#if CONFIG_COMPILER_OPTIMIZATION_PERF
+    const char *opt = "-O2";
+#elif CONFIG_COMPILER_OPTIMIZATION_SIZE
+    const char *opt = "-Os";
+#elif CONFIG_COMPILER_OPTIMIZATION_NONE
+    const char *opt = "-O0";
+#else
+    const char *opt = "-Og";
+#endif
+#if CONFIG_CONTOMETRO_HOT_IRAM
+    const int iram = 1;
+#else
+    const int iram = 0;
+#endif
+    printf("BENCH inicio opt=%s iram=%d cpu_mhz=%d overhead=%lu\n", opt,
+           iram, CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+           (unsigned long)overhead);
+
+    bench_checksum();
+    bench_parsers();
+    bench_nmea_to_decimal();
+#if CONFIG_GPS_KALMAN
+    bench_kalman();
+#endif
+    bench_show_digit();
+    bench_trama_a_decision();
+#if CONFIG_MONITOR_REGLAS
+    bench_reglas();
+#endif
+#if CONFIG_NMEA_REENVIO
+    bench_reenvio();
+#endif
+
+    printf("BENCH fin\n");
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+// Ejecuta todas las mediciones sobre la captura NMEA embebida e imprime
+// una línea "BENCH" por función (ciclos de CPU: min / mediana / max).
+void bench_ejecutar(void);
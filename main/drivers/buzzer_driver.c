@@ -24,10 +24,14 @@ void init_buzzer_gpio(void){
 
 void buzzer_on(void){
     gpio_set_level(BUZZER_GPIO,0); // Activar el buzzer
+#if CONFIG_CONTOMETRO_LOG_VERBOSE
     ESP_LOGI(TAG, "Buzzer ON");
+#endif
 }
 
 void buzzer_off(void){
     gpio_set_level(BUZZER_GPIO,1); // Desactivar el buzzer
+#if CONFIG_CONTOMETRO_LOG_VERBOSE
     ESP_LOGI(TAG, "Buzzer OFF");
+#endif
 }
\ No newline at end of file
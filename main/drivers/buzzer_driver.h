@@ -4,8 +4,9 @@
 #include "freertos/task.h"
 #include "esp_log.h"
 #include "driver/gpio.h"
+#include "sdkconfig.h"
 
-#define BUZZER_GPIO GPIO_NUM_15 
+#define BUZZER_GPIO CONFIG_BUZZER_GPIO
 // control del buzzer
 void init_buzzer_gpio(void);
 void buzzer_on(void);
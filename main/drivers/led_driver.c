@@ -26,24 +26,32 @@ void init_gpio_config_led_state(void){
 void toggle_led_state(void){
     if(state_led == 0){
         gpio_set_level(LED_GPIO,1);
+#if CONFIG_CONTOMETRO_LOG_VERBOSE
         ESP_LOGI(TAG,"LED_STATE_ENCENDIDO");
+#endif
         state_led = 1;
     }else{
         gpio_set_level(LED_GPIO,0);
+#if CONFIG_CONTOMETRO_LOG_VERBOSE
         ESP_LOGI(TAG,"LED_STATE_APAGADO");
+#endif
         state_led = 0;
     }
 }
 
 void led_state_on(void){
     gpio_set_level(LED_GPIO,1);
+#if CONFIG_CONTOMETRO_LOG_VERBOSE
     ESP_LOGI(TAG,"LED_STATE_ENCENDIDO");
+#endif
     state_led = 1;
 }
 
 void led_state_off(void){
     gpio_set_level(LED_GPIO,0);
+#if CONFIG_CONTOMETRO_LOG_VERBOSE
     ESP_LOGI(TAG,"LED_STATE_APAGADO");
+#endif
     state_led = 0;
 }
 
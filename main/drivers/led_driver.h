@@ -4,8 +4,9 @@
 #include <freertos/task.h>
 #include <driver/gpio.h>
 #include <esp_log.h>
+#include "sdkconfig.h"
 
-#define LED_GPIO GPIO_NUM_22
+#define LED_GPIO CONFIG_LED_GPIO
 
 void init_gpio_config_led_state(void);
 
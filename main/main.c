@@ -11,34 +11,117 @@
 
 #include "drivers/led_driver.h"
 #include "drivers/buzzer_driver.h"
-#include "modules/gps_l80r.h"
+#include "modules/gnss.h"
 #include "screens/display_7seg.h"
 #include "modules/monitor_velocidad.h"
+#include "modules/arranque.h"
+#if CONFIG_TELEMETRIA_BINARIA
+#include "modules/telemetria.h"
+#endif
+#if CONFIG_NMEA_REENVIO
+#include "modules/reenvio_nmea.h"
+#endif
+#if CONFIG_TRAYECTO
+#include "modules/trayecto.h"
+#endif
+#if CONFIG_COBERTURA
+#include "modules/cobertura.h"
+#endif
+#if CONFIG_CAJA_NEGRA
+#include "modules/caja_negra.h"
+#endif
+#if CONFIG_GPS_SUPERVISOR
+#include "modules/gps_supervisor.h"
+#endif
+#if CONFIG_CONTOMETRO_BENCHMARK
+#include "bench/bench_hotpaths.h"
+#endif
+#if CONFIG_TRAZA
+#include "modules/traza.h"
+#endif
 
 static const char* TAG = "MAIN";
+
+// -1 en menuconfig significa "sin afinidad de núcleo"
+#define NUCLEO_TAREA(n) ((n) < 0 ? tskNO_AFFINITY : (n))
 void init_nvs(void);
-void config_gps(void);
 
 void app_main(void){
 
-    init_nvs();
+    // Camino crítico: mostrar el contador cuanto antes. Tras un reinicio tibio
+    // sale del bloque RTC y NVS se inicializa después; en frío hay que leer NVS.
+    arranque_inicio();
 
-    init_uart_gps_l80r();
     init_7seg_display_gpio();
     init_buzzer_gpio();
     init_gpio_config_led_state();
-    
-    vTaskDelay(pdMS_TO_TICKS(1000)); // Esperar a que todo se inicialice
     led_state_off();
-    config_gps(); // Configurar GPS
+    arranque_fase("gpio");
+
+    if (!arranque_es_tibio()) {
+        init_nvs();
+        arranque_fase("nvs");
+    }
+    monitor_velocidad_init();
+    xTaskCreatePinnedToCore(task_display_7seg,"task_display_7seg",4096,NULL,CONFIG_TASK_DISPLAY_PRIO,NULL,NUCLEO_TAREA(CONFIG_TASK_DISPLAY_CORE));
+    arranque_fase("contador");
+
+    if (arranque_es_tibio()) {
+        init_nvs();                 // el monitor la necesita para guardar
+        arranque_fase("nvs");
+    }
+
+    init_uart_gnss();
+#if CONFIG_TELEMETRIA_BINARIA
+    init_uart_telemetria();
+#endif
+#if CONFIG_NMEA_REENVIO
+    init_uart_reenvio();
+#endif
+#if CONFIG_TRAYECTO
+    init_trayecto();
+#endif
+#if CONFIG_COBERTURA
+    init_cobertura();
+#endif
+#if CONFIG_CAJA_NEGRA
+    init_caja_negra();
+#endif
+    arranque_fase("uart");
+
+#if CONFIG_CONTOMETRO_BENCHMARK
+    // Solo mediciones: sin GPS real ni tareas
+    bench_ejecutar();
+    while(true){
+        vTaskDelay(pdMS_TO_TICKS(10000));
+    }
+#endif
+
     //gps_restore_default(); // Restaurar configuración default del GPS
 
 
-    // creando tarea en el CPU 1
-    xTaskCreatePinnedToCore(task_display_7seg,"task_display_7seg",4096,NULL,3,NULL,1);
-    // tareas en CPU 0
-    xTaskCreate(task_gps_read_and_parse,"task_gps_read_and_parse",4096,NULL,5,NULL);
-    xTaskCreate(task_monitor_velocidad,"task_monitor_velocidad",4096,NULL,4,NULL);
+    // prioridades y núcleos definidos en menuconfig; la configuración del receptor
+    // (~600 ms de esperas entre comandos) corre en su propia tarea
+    xTaskCreatePinnedToCore(task_gps_read_and_parse,"task_gps_read_and_parse",4096,NULL,CONFIG_TASK_GPS_PRIO,NULL,NUCLEO_TAREA(CONFIG_TASK_GPS_CORE));
+    xTaskCreatePinnedToCore(task_monitor_velocidad,"task_monitor_velocidad",4096,NULL,CONFIG_TASK_MONITOR_PRIO,NULL,NUCLEO_TAREA(CONFIG_TASK_MONITOR_CORE));
+    xTaskCreate(task_config_gps,"task_config_gps",3072,NULL,CONFIG_TASK_CONFIG_GPS_PRIO,NULL);
+#if CONFIG_GPS_SUPERVISOR
+    xTaskCreate(task_gps_supervisor,"task_gps_supervisor",3072,NULL,CONFIG_GPS_SUPERVISOR_TASK_PRIO,NULL);
+#endif
+#if CONFIG_TRAYECTO
+    xTaskCreate(task_trayecto,"task_trayecto",4096,NULL,CONFIG_TRAYECTO_TASK_PRIO,NULL);
+#endif
+#if CONFIG_COBERTURA
+    xTaskCreate(task_cobertura,"task_cobertura",3072,NULL,CONFIG_COBERTURA_TASK_PRIO,NULL);
+#endif
+#if CONFIG_CAJA_NEGRA
+    xTaskCreate(task_caja_negra,"task_caja_negra",4096,NULL,CONFIG_CAJA_NEGRA_TASK_PRIO,NULL);
+#endif
+#if CONFIG_TRAZA
+    xTaskCreate(task_traza,"task_traza",4096,NULL,1,NULL);
+#endif
+    arranque_fase("tareas");
+    arranque_reportar();
 
     //vTaskDelay(pdMS_TO_TICKS(100));
 
@@ -60,6 +143,9 @@ void app_main(void){
         //ESP_LOGI(TAG,"While principal");
         //mostrar_data_NMEA(); // ver data cruda
         vTaskDelay(pdMS_TO_TICKS(10000)); // simular trabajo en el CPU 0
+#if CONFIG_NMEA_REENVIO
+        reenvio_nmea_reportar();
+#endif
         //monitor_velocidad_reset_contador();
     }
 }
@@ -77,17 +163,3 @@ void init_nvs(void){
     ESP_ERROR_CHECK(ret);
     ESP_LOGI(TAG, "NVS inicializado correctamente");
 }
-
-// ===========================================================
-//  CONFIGURAR GPS
-// ===========================================================
-void config_gps(void){
-    gps_set_update_rate_hz(5);        // 5Hz
-    vTaskDelay(pdMS_TO_TICKS(200));
-
-    gps_enable_rmc_gga_only();        // Solo RMC + GGA
-    vTaskDelay(pdMS_TO_TICKS(200));
-
-    uart_flush(GPS_UART_NUM);         //Limpiar todo el buffer
-    vTaskDelay(pdMS_TO_TICKS(200));  //Esperar a que PMTK se aplique
-}
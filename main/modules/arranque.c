@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <esp_rom_crc.h>
+
+#include "modules/arranque.h"
+
+static const char *TAG = "ARRANQUE";
+
+#define ARRANQUE_FASES_MAX 12
+
+// ===========================================================
+//  TIEMPOS POR FASE
+// ===========================================================
+typedef struct {
+    const char *nombre;
+    int64_t fin_us;
+} fase_t;
+
+static fase_t fases[ARRANQUE_FASES_MAX];
+static int n_fases = 0;
+static int64_t inicio_us = 0;
+static esp_reset_reason_t motivo = ESP_RST_UNKNOWN;
+static bool tibio = false;
+
+static const char *nombre_motivo(esp_reset_reason_t m)
+{
+    switch (m) {
+        case ESP_RST_POWERON:   return "encendido";
+        case ESP_RST_SW:        return "esp_restart";
+        case ESP_RST_PANIC:     return "panic";
+        case ESP_RST_INT_WDT:   return "WDT de interrupciones";
+        case ESP_RST_TASK_WDT:  return "WDT de tareas";
+        case ESP_RST_WDT:       return "WDT";
+        case ESP_RST_BROWNOUT:  return "brownout";
+        case ESP_RST_DEEPSLEEP: return "deep sleep";
+        default:                return "otro";
+    }
+}
+
+// ===========================================================
+//  BLOQUE RTC DE REINICIO TIBIO
+// ===========================================================
+#if CONFIG_ARRANQUE_TIBIO
+#define ARRANQUE_MAGIA 0x43544D31   // "CTM1"; cambiar si cambia arranque_rtc_t
+
+// Sobrevive a reinicios por software y watchdog; basura tras encendido o brownout
+static RTC_NOINIT_ATTR arranque_rtc_t rtc;
+static arranque_rtc_t restaurado;
+static portMUX_TYPE rtc_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t crc_bloque(const arranque_rtc_t *b)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)b, offsetof(arranque_rtc_t, crc));
+}
+
+static bool motivo_tibio(esp_reset_reason_t m)
+{
+    return m == ESP_RST_SW || m == ESP_RST_PANIC || m == ESP_RST_INT_WDT ||
+           m == ESP_RST_TASK_WDT || m == ESP_RST_WDT;
+}
+
+const arranque_rtc_t *arranque_estado_tibio(void) { return tibio ? &restaurado : NULL; }
+
+void arranque_guardar_monitor(uint16_t contador, bool sobre_umbral)
+{
+    portENTER_CRITICAL(&rtc_mux);
+    rtc.contador_eventos = contador;
+    rtc.sobre_umbral = sobre_umbral;
+    rtc.crc = crc_bloque(&rtc);
+    portEXIT_CRITICAL(&rtc_mux);
+}
+
+void arranque_guardar_reglas(uint32_t activas)
+{
+    portENTER_CRITICAL(&rtc_mux);
+    rtc.reglas_activas = activas;
+    rtc.crc = crc_bloque(&rtc);
+    portEXIT_CRITICAL(&rtc_mux);
+}
+
+void arranque_guardar_receptor(bool configurado, int frecuencia_hz, int modo_tasa)
+{
+    portENTER_CRITICAL(&rtc_mux);
+    rtc.receptor_configurado = configurado;
+    rtc.frecuencia_hz = (uint8_t)frecuencia_hz;
+    rtc.modo_tasa = (uint8_t)modo_tasa;
+    rtc.crc = crc_bloque(&rtc);
+    portEXIT_CRITICAL(&rtc_mux);
+}
+
+void arranque_guardar_fix(const gps_data_t *fix)
+{
+    portENTER_CRITICAL(&rtc_mux);
+    rtc.fix = *fix;
+    rtc.hay_fix = true;
+    rtc.crc = crc_bloque(&rtc);
+    portEXIT_CRITICAL(&rtc_mux);
+}
+#endif // CONFIG_ARRANQUE_TIBIO
+
+// ===========================================================
+//  INICIO
+// ===========================================================
+void arranque_inicio(void)
+{
+    inicio_us = esp_timer_get_time();
+    motivo = esp_reset_reason();
+
+#if CONFIG_ARRANQUE_TIBIO
+    tibio = motivo_tibio(motivo) && rtc.magia == ARRANQUE_MAGIA && rtc.crc == crc_bloque(&rtc);
+    if (tibio) {
+        rtc.reinicios_tibios++;
+        rtc.crc = crc_bloque(&rtc);
+        restaurado = rtc;
+    } else {
+        memset(&rtc, 0, sizeof(rtc));
+        rtc.magia = ARRANQUE_MAGIA;
+        rtc.crc = crc_bloque(&rtc);
+    }
+#endif
+}
+
+bool arranque_es_tibio(void) { return tibio; }
+
+void arranque_fase(const char *nombre)
+{
+    if (n_fases >= ARRANQUE_FASES_MAX) return;
+    fases[n_fases].nombre = nombre;
+    fases[n_fases].fin_us = esp_timer_get_time();
+    n_fases++;
+}
+
+void arranque_reportar(void)
+{
+    char linea[256];
+    int largo = 0;
+    int64_t previo = inicio_us;
+
+    for (int i = 0; i < n_fases && largo < (int)sizeof(linea); i++) {
+        largo += snprintf(linea + largo, sizeof(linea) - largo, "%s%s %.1f",
+                          i ? " | " : "", fases[i].nombre, (fases[i].fin_us - previo) / 1000.0);
+        previo = fases[i].fin_us;
+    }
+
+    ESP_LOGI(TAG, "⏱️ Arranque %s (%s): %s ms", tibio ? "tibio" : "en frío", nombre_motivo(motivo), linea);
+    ESP_LOGI(TAG, "⏱️ Total %.1f ms desde app_main, %.1f ms desde el reset",
+             (previo - inicio_us) / 1000.0, previo / 1000.0);
+#if CONFIG_ARRANQUE_TIBIO
+    if (tibio) {
+        ESP_LOGI(TAG, "♻️ Estado restaurado de RTC: contador %u, sobre umbral %s, receptor %s (reinicio tibio #%lu)",
+                 restaurado.contador_eventos, restaurado.sobre_umbral ? "sí" : "no",
+                 restaurado.receptor_configurado ? "configurado" : "sin configurar",
+                 (unsigned long)restaurado.reinicios_tibios);
+    }
+#endif
+}
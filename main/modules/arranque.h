@@ -0,0 +1,50 @@
+#ifndef ARRANQUE_H
+#define ARRANQUE_H
+
+// Secuencia de arranque: tiempos por fase y estado de reinicio tibio.
+// Tras un reinicio por software o watchdog la memoria RTC conserva un bloque
+// con checksum (contador, estado sobre el umbral, último fix y configuración
+// del receptor) que evita leer NVS y reenviar la configuración al receptor.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "modules/nmea_parser.h"
+
+#if CONFIG_ARRANQUE_TIBIO
+typedef struct {
+    uint32_t magia;
+    uint32_t reinicios_tibios;
+    uint16_t contador_eventos;
+    uint8_t sobre_umbral;
+    uint8_t receptor_configurado;
+    uint8_t frecuencia_hz;          // frecuencia vigente en el receptor
+    uint8_t modo_tasa;              // tasa_modo_t (tasa adaptativa)
+    uint8_t hay_fix;
+    uint8_t reservado;
+    uint32_t reglas_activas;        // máscara de reglas en evento (motor de reglas)
+    gps_data_t fix;                 // último fix válido
+    uint32_t crc;                   // CRC32 de todo lo anterior
+} arranque_rtc_t;
+#endif
+
+// Primera llamada de app_main: motivo del reset y validación del bloque RTC
+void arranque_inicio(void);
+bool arranque_es_tibio(void);
+
+// Marca el fin de una fase (nombre estático) y reporta el desglose por log
+void arranque_fase(const char *nombre);
+void arranque_reportar(void);
+
+#if CONFIG_ARRANQUE_TIBIO
+// Copia del bloque tal como estaba al arrancar; NULL en arranque en frío
+const arranque_rtc_t *arranque_estado_tibio(void);
+
+// Actualizan el bloque vivo (y su CRC)
+void arranque_guardar_monitor(uint16_t contador, bool sobre_umbral);
+void arranque_guardar_reglas(uint32_t activas);
+void arranque_guardar_receptor(bool configurado, int frecuencia_hz, int modo_tasa);
+void arranque_guardar_fix(const gps_data_t *fix);
+#endif
+
+#endif // ARRANQUE_H
@@ -0,0 +1,17 @@
+#ifndef ATRIBUTOS_H
+#define ATRIBUTOS_H
+
+// Atributos de ubicación compartidos por módulos, pantallas y herramientas de host,
+// sin arrastrar dependencias del stack GNSS.
+
+#include "sdkconfig.h"
+#include "esp_attr.h"
+
+// Atributo para las funciones del camino crítico (parseo por trama, refresco del display)
+#if CONFIG_CONTOMETRO_HOT_IRAM
+#define GPS_HOT_ATTR      IRAM_ATTR
+#else
+#define GPS_HOT_ATTR
+#endif
+
+#endif // ATRIBUTOS_H
@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <esp_log.h>
+#include <esp_cpu.h>
+#include <esp_timer.h>
+#include <esp_partition.h>
+
+#include "modules/caja_negra.h"
+#include "modules/caja_negra_codec.h"
+
+static const char *TAG = "CAJA_NEGRA";
+
+#define CAJA_SUBTIPO_PARTICION  0x42
+#define CAJA_REPORTE_S          300
+
+// Buffers de preparación: los llena el lector GPS y los devuelve task_caja_negra.
+// Circulan por índice entre dos colas; el lector nunca espera en ninguna.
+typedef struct {
+    uint16_t largo;
+    uint32_t t_ms;
+    uint32_t perdidos;
+    uint8_t datos[CAJA_BLOQUE_CRUDO];
+} caja_buffer_t;
+
+static const esp_partition_t *particion = NULL;
+static caja_buffer_t buffers[CONFIG_CAJA_NEGRA_BLOQUES];
+static QueueHandle_t cola_libres = NULL;
+static QueueHandle_t cola_llenos = NULL;
+
+static caja_almacen_t almacen;
+static caja_escritor_t escritor;
+static caja_compresor_t compresor;
+static uint8_t registro[CAJA_CABECERA_BLOQUE + CAJA_BLOQUE_CRUDO];
+
+// del lado del lector
+static caja_buffer_t *actual = NULL;
+static uint32_t perdidos_pendientes = 0;
+static uint32_t bytes_recibidos = 0;
+static uint32_t bytes_descartados = 0;
+static uint32_t bloques_descartados = 0;
+
+// del lado de la tarea
+static uint32_t bytes_crudos = 0;
+static uint64_t ciclos_compresion = 0;
+static uint64_t us_flash = 0;
+static uint32_t us_flash_peor = 0;
+
+static inline uint32_t ahora_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+// ===========================================================
+//  ACCESO A LA PARTICIÓN
+// ===========================================================
+static bool flash_leer(void *ctx, uint32_t offset, void *dst, size_t len)
+{
+    return esp_partition_read(particion, offset, dst, len) == ESP_OK;
+}
+
+static bool flash_escribir(void *ctx, uint32_t offset, const void *src, size_t len)
+{
+    return esp_partition_write(particion, offset, src, len) == ESP_OK;
+}
+
+static bool flash_borrar_sector(void *ctx, uint32_t offset)
+{
+    return esp_partition_erase_range(particion, offset, CAJA_SECTOR) == ESP_OK;
+}
+
+// ===========================================================
+//  INICIALIZACIÓN
+// ===========================================================
+void init_caja_negra(void)
+{
+    particion = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, CAJA_SUBTIPO_PARTICION, "caja_negra");
+    if (particion == NULL) {
+        ESP_LOGE(TAG, "No existe la partición 'caja_negra' (revisar partitions.csv)");
+        return;
+    }
+
+    almacen.ctx = NULL;
+    almacen.n_sectores = particion->size / CAJA_SECTOR;
+    almacen.leer = flash_leer;
+    almacen.escribir = flash_escribir;
+    almacen.borrar_sector = flash_borrar_sector;
+    caja_escritor_init(&escritor, &almacen);
+
+    cola_llenos = xQueueCreate(CONFIG_CAJA_NEGRA_BLOQUES, sizeof(uint8_t));
+    cola_libres = xQueueCreate(CONFIG_CAJA_NEGRA_BLOQUES, sizeof(uint8_t));
+    for (uint8_t i = 0; i < CONFIG_CAJA_NEGRA_BLOQUES; i++) xQueueSend(cola_libres, &i, 0);
+
+    ESP_LOGI(TAG, "Partición caja_negra: %lu sectores, sector actual %lu (seq %lu, %lu bytes), %d buffers de %d bytes",
+             (unsigned long)almacen.n_sectores, (unsigned long)escritor.sector,
+             (unsigned long)escritor.seq, (unsigned long)escritor.usado,
+             CONFIG_CAJA_NEGRA_BLOQUES, CAJA_BLOQUE_CRUDO);
+}
+
+// ===========================================================
+//  ENTRADA DESDE EL LECTOR GPS
+// ===========================================================
+static void entregar_actual(void)
+{
+    uint8_t i = (uint8_t)(actual - buffers);
+    xQueueSend(cola_llenos, &i, 0);     // entra siempre: hay tantos lugares como buffers
+    actual = NULL;
+}
+
+void caja_negra_registrar(const uint8_t *datos, size_t largo)
+{
+    if (cola_libres == NULL) return;
+    bytes_recibidos += largo;
+
+    while (largo > 0) {
+        if (actual == NULL) {
+            uint8_t i;
+            if (xQueueReceive(cola_libres, &i, 0) != pdTRUE) {
+                // la flash va atrasada: se pierde esta lectura, no se espera
+                bytes_descartados += largo;
+                perdidos_pendientes += largo;
+                return;
+            }
+            if (perdidos_pendientes) {
+                bloques_descartados += (perdidos_pendientes + CAJA_BLOQUE_CRUDO - 1) / CAJA_BLOQUE_CRUDO;
+            }
+            actual = &buffers[i];
+            actual->largo = 0;
+            actual->t_ms = ahora_ms();
+            actual->perdidos = perdidos_pendientes;
+            perdidos_pendientes = 0;
+        }
+
+        size_t n = CAJA_BLOQUE_CRUDO - actual->largo;
+        if (n > largo) n = largo;
+        memcpy(actual->datos + actual->largo, datos, n);
+        actual->largo += n;
+        datos += n;
+        largo -= n;
+        if (actual->largo == CAJA_BLOQUE_CRUDO) entregar_actual();
+    }
+
+    // limitar lo que se pierde ante un corte de energía
+    if (actual && ahora_ms() - actual->t_ms > CONFIG_CAJA_NEGRA_VACIAR_S * 1000u) entregar_actual();
+}
+
+// ===========================================================
+//  TAREA: COMPRIMIR Y ESCRIBIR
+// ===========================================================
+static void reportar(void)
+{
+    uint32_t bloques = escritor.bloques_escritos;
+    if (bloques == 0) return;
+    ESP_LOGI(TAG, "📼 %lu bloques, %lu KB → %lu KB (%.1fx), compresión %lu ciclos/bloque, flash %lu µs/bloque (peor %lu), descartados %lu bytes",
+             (unsigned long)bloques, (unsigned long)(bytes_crudos / 1024),
+             (unsigned long)(escritor.bytes_escritos / 1024),
+             escritor.bytes_escritos ? (double)bytes_crudos / escritor.bytes_escritos : 0.0,
+             (unsigned long)caja_negra_get_ciclos_por_bloque(),
+             (unsigned long)caja_negra_get_us_flash_por_bloque(), (unsigned long)us_flash_peor,
+             (unsigned long)bytes_descartados);
+}
+
+void task_caja_negra(void *pvParameters)
+{
+    TickType_t ultimo_reporte = xTaskGetTickCount();
+
+    while (1) {
+        uint8_t i;
+        if (cola_llenos == NULL) {
+            vTaskDelay(pdMS_TO_TICKS(10000));
+            continue;
+        }
+
+        if (xQueueReceive(cola_llenos, &i, pdMS_TO_TICKS(1000)) == pdTRUE) {
+            caja_buffer_t *buf = &buffers[i];
+            caja_bloque_t b = { .crudo = buf->largo, .t_ms = buf->t_ms, .perdidos = buf->perdidos };
+
+            uint32_t c0 = esp_cpu_get_cycle_count();
+            size_t largo = caja_comprimir(&compresor, buf->datos, buf->largo, registro + CAJA_CABECERA_BLOQUE, buf->largo);
+            ciclos_compresion += esp_cpu_get_cycle_count() - c0;
+
+            if (largo) {
+                b.flags = CAJA_FLAG_COMPRIMIDO;
+                b.largo = (uint16_t)largo;
+            } else {
+                memcpy(registro + CAJA_CABECERA_BLOQUE, buf->datos, buf->largo);
+                b.largo = buf->largo;
+            }
+            // el buffer vuelve al lector antes de la espera de flash
+            bytes_crudos += buf->largo;
+            xQueueSend(cola_libres, &i, 0);
+
+            int64_t t0 = esp_timer_get_time();
+            if (!caja_escritor_agregar(&escritor, &b, registro)) {
+                ESP_LOGE(TAG, "Error escribiendo en la partición caja_negra");
+            }
+            uint32_t dt = (uint32_t)(esp_timer_get_time() - t0);
+            us_flash += dt;
+            if (dt > us_flash_peor) us_flash_peor = dt;
+        }
+
+        if (xTaskGetTickCount() - ultimo_reporte > pdMS_TO_TICKS(CAJA_REPORTE_S * 1000)) {
+            reportar();
+            ultimo_reporte = xTaskGetTickCount();
+        }
+    }
+}
+
+// ===========================================================
+//  GETTERS DE DIAGNÓSTICO
+// ===========================================================
+uint32_t caja_negra_get_bytes_recibidos(void) { return bytes_recibidos; }
+uint32_t caja_negra_get_bytes_descartados(void) { return bytes_descartados; }
+uint32_t caja_negra_get_bloques_descartados(void) { return bloques_descartados; }
+uint32_t caja_negra_get_bloques_escritos(void) { return escritor.bloques_escritos; }
+uint32_t caja_negra_get_bytes_escritos(void) { return escritor.bytes_escritos; }
+
+uint32_t caja_negra_get_ciclos_por_bloque(void)
+{
+    return escritor.bloques_escritos ? (uint32_t)(ciclos_compresion / escritor.bloques_escritos) : 0;
+}
+
+uint32_t caja_negra_get_us_flash_por_bloque(void)
+{
+    return escritor.bloques_escritos ? (uint32_t)(us_flash / escritor.bloques_escritos) : 0;
+}
@@ -0,0 +1,29 @@
+#ifndef CAJA_NEGRA_H
+#define CAJA_NEGRA_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Caja negra del receptor: copia de cada byte leído del UART del GPS, comprimida
+// por bloques en la partición circular "caja_negra" (formato en caja_negra_codec.h).
+// El lector solo copia a un buffer de RAM; la compresión y la escritura en flash
+// ocurren en task_caja_negra (prioridad baja). Extraer con host/caja_negra extraer.
+
+void init_caja_negra(void);
+// Llamado por cada lectura del UART, también las vacías (largo 0: solo vacía por
+// antigüedad el bloque a medias); nunca bloquea. Si no hay buffer libre porque
+// la flash no da abasto, descarta y cuenta (el hueco queda marcado en el bloque siguiente).
+void caja_negra_registrar(const uint8_t *datos, size_t largo);
+
+void task_caja_negra(void *pvParameters);
+
+// GETTERS DE DIAGNÓSTICO
+uint32_t caja_negra_get_bytes_recibidos(void);
+uint32_t caja_negra_get_bytes_descartados(void);
+uint32_t caja_negra_get_bloques_descartados(void);
+uint32_t caja_negra_get_bloques_escritos(void);
+uint32_t caja_negra_get_bytes_escritos(void);
+uint32_t caja_negra_get_ciclos_por_bloque(void);   // compresión, promedio
+uint32_t caja_negra_get_us_flash_por_bloque(void); // escritura (+ borrado), promedio
+
+#endif // CAJA_NEGRA_H
@@ -0,0 +1,634 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "modules/caja_negra_codec.h"
+#include "modules/varint.h"
+
+// Prefijos del flujo transformado. Línea: T_LITERAL / T_DELTA + slot, con +1 / +CAJA_TIPOS
+// si el checksum "*HH" era correcto y se omitió (el decodificador lo recalcula).
+// Campos de una línea delta, cada uno autodelimitado y la línea termina en '\n':
+//   T_CAMPO_DIF | k   k caracteres iguales a la referencia y el resto en diferencias de
+//                     dígito (0x00..0x09); k = largo es el campo repetido (1 byte)
+//   T_EXACTO          número igual a la extrapolación lineal de las dos líneas anteriores
+//   T_PREDICHO v      extrapolación + v (svarint)
+//   otro              literal terminado en ',' (con T_ESCAPE delante si empieza con un
+//                     byte que se confundiría con los prefijos)
+#define T_CAMPO_DIF     0x80
+#define T_PREDICHO      0x7F
+#define T_EXACTO        0x7E
+#define T_ESCAPE        0x0C
+#define T_LITERAL       0x0E
+#define T_LITERAL_CS    0x0F
+#define T_DELTA         0x10
+#define T_DELTA_CS      (T_DELTA + CAJA_TIPOS)
+
+#define NUMERO_DIGITOS  18
+#define RESIDUO_MAX     (1 << 26)
+
+#define LZ_MIN          4
+#define LZ_OFFSET_MAX   65535
+
+static inline bool es_digito(uint8_t c)
+{
+    return (uint8_t)(c - '0') <= 9;
+}
+
+// ===========================================================
+//  REFERENCIAS: dos últimas líneas de cada tipo ("$GPRMC", "$GPGGA"...)
+// ===========================================================
+static int buscar_referencia(const caja_referencias_t *r, const uint8_t *linea, size_t largo)
+{
+    if (largo < 6 || linea[0] != '$') return -1;
+    for (int i = 0; i < CAJA_TIPOS; i++)
+        if (r->ref[i].largo >= 6 && memcmp(r->ref[i].linea, linea, 6) == 0) return i;
+    return -1;
+}
+
+static void guardar_referencia(caja_referencias_t *r, const uint8_t *linea, size_t largo)
+{
+    if (largo < 6 || largo > CAJA_LINEA_MAX || linea[0] != '$') return;
+    int i = buscar_referencia(r, linea, largo);
+    caja_referencia_t *ref;
+    if (i < 0) {
+        ref = &r->ref[r->proxima];
+        r->proxima = (uint8_t)((r->proxima + 1) % CAJA_TIPOS);
+        ref->largo_anterior = 0;
+    } else {
+        ref = &r->ref[i];
+        memcpy(ref->anterior, ref->linea, ref->largo);
+        ref->largo_anterior = ref->largo;
+    }
+    memcpy(ref->linea, linea, largo);
+    ref->largo = (uint8_t)largo;
+}
+
+// Recorre los campos de una línea de referencia; sin campos = largo 0 y false
+typedef struct {
+    const char *linea;
+    size_t largo;
+    size_t q;
+} cursor_t;
+
+static bool siguiente_campo(cursor_t *c, const char **campo, size_t *largo)
+{
+    *largo = 0;
+    if (c->linea == NULL || c->q > c->largo) return false;
+    const char *coma = memchr(c->linea + c->q, ',', c->largo - c->q);
+    *campo = c->linea + c->q;
+    *largo = coma ? (size_t)(coma - *campo) : c->largo - c->q;
+    c->q += *largo + 1;     // pasa la coma; más allá del final = sin campos
+    return true;
+}
+
+// ===========================================================
+//  PREDICCIÓN NUMÉRICA
+// ===========================================================
+// Campo "ddd.ddd" (un punto como mucho): valor sin el punto y posición del punto
+typedef struct {
+    int64_t v;
+    uint8_t largo;
+    int8_t punto;
+} numero_t;
+
+static bool leer_numero(const char *s, size_t largo, numero_t *n)
+{
+    if (largo == 0 || largo > NUMERO_DIGITOS) return false;
+    n->v = 0;
+    n->largo = (uint8_t)largo;
+    n->punto = -1;
+    for (size_t i = 0; i < largo; i++) {
+        if (s[i] == '.' && n->punto < 0) n->punto = (int8_t)i;
+        else if (es_digito((uint8_t)s[i])) n->v = n->v * 10 + (s[i] - '0');
+        else return false;
+    }
+    return largo > (n->punto >= 0 ? 1u : 0u);
+}
+
+static bool mismo_formato(const numero_t *a, const numero_t *b)
+{
+    return a->largo == b->largo && a->punto == b->punto;
+}
+
+// Extrapolación lineal desde a (último) y b (anterior) si tienen el mismo formato
+static bool predecir(const char *ca, size_t la, const char *cb, size_t lb, bool hay_b, numero_t *pred)
+{
+    numero_t b;
+    if (!leer_numero(ca, la, pred)) return false;
+    if (hay_b && leer_numero(cb, lb, &b) && mismo_formato(pred, &b)) pred->v = 2 * pred->v - b.v;
+    return true;
+}
+
+// Escribe v con el formato de fmt (ceros a la izquierda); false si no entra
+static bool escribir_numero(const numero_t *fmt, int64_t v, uint8_t *out)
+{
+    if (v < 0) return false;
+    for (int i = fmt->largo - 1; i >= 0; i--) {
+        if (i == fmt->punto) {
+            out[i] = '.';
+            continue;
+        }
+        out[i] = (uint8_t)('0' + v % 10);
+        v /= 10;
+    }
+    return v == 0;
+}
+
+// ===========================================================
+//  CHECKSUM NMEA
+// ===========================================================
+static const char HEX[] = "0123456789ABCDEF";
+
+static uint8_t xor_nmea(const uint8_t *desde, const uint8_t *hasta)
+{
+    uint8_t x = 0;
+    while (desde < hasta) x ^= *desde++;
+    return x;
+}
+
+// Copia la línea sin los dos dígitos del checksum si es "$...*HH[\r]" con HH correcto
+// en mayúsculas. Devuelve el largo resultante o 0 si no corresponde.
+static size_t quitar_checksum(const uint8_t *l, size_t n, uint8_t *sin_cs)
+{
+    if (n < 4 || n > CAJA_LINEA_MAX || l[0] != '$') return 0;
+    size_t fin = l[n - 1] == '\r' ? n - 1 : n;
+    if (fin < 4 || l[fin - 3] != '*') return 0;
+    uint8_t x = xor_nmea(l + 1, l + fin - 3);
+    if (l[fin - 2] != HEX[x >> 4] || l[fin - 1] != HEX[x & 0x0F]) return 0;
+    memcpy(sin_cs, l, fin - 2);
+    memcpy(sin_cs + fin - 2, l + fin, n - fin);
+    return n - 2;
+}
+
+// ===========================================================
+//  TRANSFORMACIÓN NMEA
+// ===========================================================
+static size_t svarint_largo(int32_t v)
+{
+    uint32_t z = ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+    size_t n = 1;
+    while (z >= 0x80) {
+        z >>= 7;
+        n++;
+    }
+    return n;
+}
+
+static size_t transformar_campos(const caja_referencia_t *ref, const uint8_t *linea, size_t largo, uint8_t *out)
+{
+    cursor_t ca = { ref->linea, ref->largo, 0 };
+    cursor_t cb = { ref->largo_anterior ? ref->anterior : NULL, ref->largo_anterior, 0 };
+    size_t o = 0, p = 0;
+    while (1) {
+        const uint8_t *coma = memchr(linea + p, ',', largo - p);
+        size_t fin = coma ? (size_t)(coma - linea) : largo;
+        const uint8_t *campo = linea + p;
+        size_t lc = fin - p, la, lb;
+        const char *fa = NULL, *fb = NULL;
+        bool hay_a = siguiente_campo(&ca, &fa, &la);
+        bool hay_b = siguiente_campo(&cb, &fb, &lb);
+
+        // diferencias de dígito contra el último
+        bool dif = hay_a && lc == la;
+        size_t iguales = 0;
+        for (size_t k = 0; dif && k < lc; k++) {
+            uint8_t c = campo[k], r = (uint8_t)fa[k];
+            dif = c == r || (es_digito(c) && es_digito(r));
+            if (c == r && iguales == k) iguales++;
+        }
+        size_t costo_dif = dif ? 1 + lc - iguales : SIZE_MAX;
+
+        // extrapolación numérica
+        numero_t pred, actual;
+        int64_t residuo = 0;
+        size_t costo_pred = SIZE_MAX;
+        if (hay_a && (!dif || iguales < lc) && predecir(fa, la, fb, lb, hay_b, &pred) &&
+            leer_numero((const char *)campo, lc, &actual) && mismo_formato(&pred, &actual)) {
+            residuo = actual.v - pred.v;
+            if (residuo == 0) costo_pred = 1;
+            else if (residuo > -RESIDUO_MAX && residuo < RESIDUO_MAX) costo_pred = 1 + svarint_largo((int32_t)residuo);
+        }
+
+        size_t escape = lc > 0 && (campo[0] >= T_EXACTO || campo[0] == T_ESCAPE);
+        size_t costo_lit = lc + 1 + escape;
+
+        if (costo_pred <= costo_dif && costo_pred < costo_lit) {
+            if (residuo == 0) {
+                out[o++] = T_EXACTO;
+            } else {
+                out[o++] = T_PREDICHO;
+                o = (size_t)(put_svarint(out + o, (int32_t)residuo) - out);
+            }
+        } else if (costo_dif < costo_lit) {
+            out[o++] = (uint8_t)(T_CAMPO_DIF | iguales);
+            for (size_t k = iguales; k < lc; k++) {
+                uint8_t r = (uint8_t)fa[k];
+                out[o++] = es_digito(r) ? (uint8_t)((campo[k] - r + 10) % 10) : 0;
+            }
+        } else {
+            if (escape) out[o++] = T_ESCAPE;
+            memcpy(out + o, campo, lc);
+            o += lc;
+            out[o++] = ',';
+        }
+
+        if (coma == NULL) return o;
+        p = fin + 1;
+    }
+}
+
+static size_t transformar(caja_referencias_t *r, const uint8_t *in, size_t n, uint8_t *out)
+{
+    memset(r, 0, sizeof(*r));
+    size_t o = 0, i = 0;
+    uint8_t sin_cs[CAJA_LINEA_MAX];
+    while (i < n) {
+        const uint8_t *nl = memchr(in + i, '\n', n - i);
+        size_t fin = nl ? (size_t)(nl - in) : n;
+        const uint8_t *linea = in + i;
+        size_t largo = fin - i;
+
+        size_t largo_sin_cs = quitar_checksum(linea, largo, sin_cs);
+        uint8_t cs = 0;
+        if (largo_sin_cs) {
+            linea = sin_cs;
+            largo = largo_sin_cs;
+            cs = 1;
+        }
+
+        int slot = buscar_referencia(r, linea, largo);
+        if (slot < 0) {
+            out[o++] = (uint8_t)(T_LITERAL + cs);
+            memcpy(out + o, linea, largo);
+            o += largo;
+        } else {
+            out[o++] = (uint8_t)((cs ? T_DELTA_CS : T_DELTA) + slot);
+            o += transformar_campos(&r->ref[slot], linea, largo, out + o);
+        }
+        if (nl) out[o++] = '\n';
+
+        guardar_referencia(r, linea, largo);
+        i = fin + (nl ? 1 : 0);
+    }
+    return o;
+}
+
+// Decodifica los campos de una línea delta desde in[*i]; se detiene en '\n' o al final
+static bool destransformar_campos(const caja_referencia_t *ref, const uint8_t *in, size_t n, size_t *i,
+                                  uint8_t *out, size_t max, size_t *o)
+{
+    cursor_t ca = { ref->linea, ref->largo, 0 };
+    cursor_t cb = { ref->largo_anterior ? ref->anterior : NULL, ref->largo_anterior, 0 };
+    size_t p = *i;
+    bool primero = true;
+    while (p < n && in[p] != '\n') {
+        const char *fa = NULL, *fb = NULL;
+        size_t la, lb;
+        bool hay_a = siguiente_campo(&ca, &fa, &la);
+        bool hay_b = siguiente_campo(&cb, &fb, &lb);
+
+        if (!primero) {
+            if (*o + 1 > max) return false;
+            out[(*o)++] = ',';
+        }
+        primero = false;
+
+        uint8_t cod = in[p];
+        if (cod >= T_CAMPO_DIF) {
+            size_t iguales = cod & (uint8_t)~T_CAMPO_DIF;
+            if (!hay_a || iguales > la || n - p - 1 < la - iguales || *o + la > max) return false;
+            memcpy(out + *o, fa, iguales);
+            for (size_t k = iguales; k < la; k++) {
+                uint8_t d = in[p + 1 + k - iguales], r = (uint8_t)fa[k];
+                if (d > 9) return false;
+                out[*o + k] = es_digito(r) ? (uint8_t)('0' + (r - '0' + d) % 10) : r;
+            }
+            *o += la;
+            p += 1 + la - iguales;
+        } else if (cod == T_EXACTO || cod == T_PREDICHO) {
+            numero_t pred;
+            int32_t residuo = 0;
+            p++;
+            if (cod == T_PREDICHO) {
+                const uint8_t *sig = get_svarint(in + p, in + n, &residuo);
+                if (sig == NULL) return false;
+                p = (size_t)(sig - in);
+            }
+            if (!hay_a || !predecir(fa, la, fb, lb, hay_b, &pred) || *o + pred.largo > max) return false;
+            if (!escribir_numero(&pred, pred.v + residuo, out + *o)) return false;
+            *o += pred.largo;
+        } else {
+            p += cod == T_ESCAPE;
+            const uint8_t *coma = memchr(in + p, ',', n - p);
+            if (coma == NULL) return false;
+            size_t lc = (size_t)(coma - in) - p;
+            if (*o + lc > max) return false;
+            memcpy(out + *o, in + p, lc);
+            *o += lc;
+            p += lc + 1;
+        }
+    }
+    *i = p;
+    return true;
+}
+
+static bool destransformar(caja_referencias_t *r, const uint8_t *in, size_t n, uint8_t *out, size_t max, size_t *largo)
+{
+    memset(r, 0, sizeof(*r));
+    size_t o = 0, i = 0;
+    while (i < n) {
+        uint8_t tipo = in[i++];
+        size_t inicio = o;
+        bool cs = tipo == T_LITERAL_CS || (tipo >= T_DELTA_CS && tipo < T_DELTA_CS + CAJA_TIPOS);
+
+        if (tipo == T_LITERAL || tipo == T_LITERAL_CS) {
+            const uint8_t *nl = memchr(in + i, '\n', n - i);
+            size_t fin = nl ? (size_t)(nl - in) : n;
+            if (o + (fin - i) > max) return false;
+            memcpy(out + o, in + i, fin - i);
+            o += fin - i;
+            i = fin;
+        } else if (tipo >= T_DELTA && tipo < T_DELTA_CS + CAJA_TIPOS && r->ref[(tipo - T_DELTA) % CAJA_TIPOS].largo) {
+            if (!destransformar_campos(&r->ref[(tipo - T_DELTA) % CAJA_TIPOS], in, n, &i, out, max, &o)) return false;
+        } else {
+            return false;
+        }
+
+        guardar_referencia(r, out + inicio, o - inicio);
+
+        if (cs) {
+            // el checksum va después del último '*' (solo puede seguir un '\r')
+            size_t estrella = o;
+            while (estrella > inicio && out[estrella - 1] != '*') estrella--;
+            if (estrella <= inicio + 1 || o + 2 > max) return false;
+            uint8_t x = xor_nmea(out + inicio + 1, out + estrella - 1);
+            memmove(out + estrella + 2, out + estrella, o - estrella);
+            out[estrella] = (uint8_t)HEX[x >> 4];
+            out[estrella + 1] = (uint8_t)HEX[x & 0x0F];
+            o += 2;
+        }
+        if (i < n) {            // in[i] == '\n'
+            if (o + 1 > max) return false;
+            out[o++] = '\n';
+            i++;
+        }
+    }
+    *largo = o;
+    return true;
+}
+
+// ===========================================================
+//  LZ77 (formato de secuencias estilo LZ4)
+// ===========================================================
+static inline uint32_t leer32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+static inline uint32_t hash4(uint32_t v)
+{
+    return (v * 2654435761u) >> (32 - CAJA_HASH_BITS);
+}
+
+static uint8_t *largo_extendido(uint8_t *o, const uint8_t *fin, size_t resto)
+{
+    while (resto >= 255) {
+        if (o >= fin) return NULL;
+        *o++ = 255;
+        resto -= 255;
+    }
+    if (o >= fin) return NULL;
+    *o++ = (uint8_t)resto;
+    return o;
+}
+
+static uint8_t *secuencia(uint8_t *o, const uint8_t *fin, const uint8_t *lit, size_t n_lit, size_t offset, size_t n_match)
+{
+    if (o >= fin) return NULL;
+    uint8_t *token = o++;
+    *token = (uint8_t)((n_lit < 15 ? n_lit : 15) << 4);
+    if (n_lit >= 15 && !(o = largo_extendido(o, fin, n_lit - 15))) return NULL;
+    if (o + n_lit > fin) return NULL;
+    memcpy(o, lit, n_lit);
+    o += n_lit;
+    if (n_match == 0) return o;                     // secuencia final: solo literales
+
+    if (o + 2 > fin) return NULL;
+    o = put_u16(o, (uint16_t)offset);
+    size_t m = n_match - LZ_MIN;
+    *token |= (uint8_t)(m < 15 ? m : 15);
+    if (m >= 15 && !(o = largo_extendido(o, fin, m - 15))) return NULL;
+    return o;
+}
+
+static size_t lz_comprimir(uint16_t *hash, const uint8_t *in, size_t n, uint8_t *out, size_t max)
+{
+    memset(hash, 0, sizeof(uint16_t) << CAJA_HASH_BITS);
+    const uint8_t *fin = out + max;
+    uint8_t *o = out;
+    size_t i = 0, ancla = 0;
+
+    while (n >= LZ_MIN && i + LZ_MIN <= n) {
+        uint32_t v = leer32(in + i);
+        uint32_t h = hash4(v);
+        size_t cand = hash[h];
+        hash[h] = (uint16_t)(i + 1);
+        if (cand == 0 || i - (cand - 1) > LZ_OFFSET_MAX || leer32(in + cand - 1) != v) {
+            i++;
+            continue;
+        }
+        cand--;
+        size_t largo = LZ_MIN;
+        while (i + largo < n && in[cand + largo] == in[i + largo]) largo++;
+
+        if (!(o = secuencia(o, fin, in + ancla, i - ancla, i - cand, largo))) return 0;
+        // posiciones dentro de la coincidencia: solo la penúltima, como LZ4 rápido
+        if (i + largo - 2 + LZ_MIN <= n) hash[hash4(leer32(in + i + largo - 2))] = (uint16_t)(i + largo - 1);
+        i += largo;
+        ancla = i;
+    }
+    if (!(o = secuencia(o, fin, in + ancla, n - ancla, 0, 0))) return 0;
+    return (size_t)(o - out);
+}
+
+static bool lz_descomprimir(const uint8_t *in, size_t n, uint8_t *out, size_t max, size_t *largo)
+{
+    const uint8_t *p = in, *fin = in + n;
+    size_t o = 0;
+    while (p < fin) {
+        uint8_t token = *p++;
+        size_t n_lit = token >> 4;
+        if (n_lit == 15) {
+            uint8_t b;
+            do {
+                if (p >= fin) return false;
+                b = *p++;
+                n_lit += b;
+            } while (b == 255);
+        }
+        if ((size_t)(fin - p) < n_lit || o + n_lit > max) return false;
+        memcpy(out + o, p, n_lit);
+        p += n_lit;
+        o += n_lit;
+        if (p == fin) break;                        // secuencia final
+
+        if (fin - p < 2) return false;
+        size_t offset = get_u16(p);
+        p += 2;
+        size_t m = (token & 0x0F);
+        if (m == 15) {
+            uint8_t b;
+            do {
+                if (p >= fin) return false;
+                b = *p++;
+                m += b;
+            } while (b == 255);
+        }
+        m += LZ_MIN;
+        if (offset == 0 || offset > o || o + m > max) return false;
+        // byte a byte: la coincidencia puede solaparse con lo que copia (corridas)
+        for (size_t k = 0; k < m; k++, o++) out[o] = out[o - offset];
+    }
+    *largo = o;
+    return true;
+}
+
+// ===========================================================
+//  BLOQUE
+// ===========================================================
+size_t caja_comprimir(caja_compresor_t *c, const uint8_t *crudo, size_t largo, uint8_t *salida, size_t max)
+{
+    if (largo > CAJA_BLOQUE_CRUDO) return 0;
+    size_t t = transformar(&c->refs, crudo, largo, c->transformado);
+    size_t n = lz_comprimir(c->hash, c->transformado, t, salida, max);
+    return (n > 0 && n < largo) ? n : 0;
+}
+
+bool caja_descomprimir(caja_compresor_t *c, const uint8_t *comp, size_t largo, uint8_t *salida, size_t largo_crudo)
+{
+    size_t t, n;
+    if (!lz_descomprimir(comp, largo, c->transformado, sizeof(c->transformado), &t)) return false;
+    if (!destransformar(&c->refs, c->transformado, t, salida, largo_crudo, &n)) return false;
+    return n == largo_crudo;
+}
+
+// ===========================================================
+//  LECTURA DE SECTORES
+// ===========================================================
+static bool leer_cabecera_bloque(const uint8_t *p, size_t disponible, caja_bloque_t *b)
+{
+    if (disponible < CAJA_CABECERA_BLOQUE || p[0] != CAJA_MARCA_BLOQUE) return false;
+    b->flags = p[3];
+    b->largo = get_u16(p + 4);
+    b->crudo = get_u16(p + 6);
+    b->t_ms = get_u32(p + 8);
+    b->perdidos = get_u32(p + 12);
+    if (b->largo > disponible - CAJA_CABECERA_BLOQUE || b->crudo > CAJA_BLOQUE_CRUDO) return false;
+    return get_u16(p + 1) == crc16_ccitt(p + 3, CAJA_CABECERA_BLOQUE - 3 + b->largo);
+}
+
+int caja_decodificar_sector(const uint8_t *sector, uint32_t *seq, uint32_t *usado, caja_bloque_cb cb, void *ctx)
+{
+    if (get_u32(sector) != CAJA_MAGIC) return -1;
+    if (get_u16(sector + 8) != crc16_ccitt(sector, 8)) return -1;
+    if (seq) *seq = get_u32(sector + 4);
+
+    uint32_t pos = CAJA_CABECERA_SECTOR;
+    int n = 0;
+    caja_bloque_t b;
+    while (leer_cabecera_bloque(sector + pos, CAJA_SECTOR - pos, &b)) {
+        if (cb) cb(ctx, &b, sector + pos + CAJA_CABECERA_BLOQUE);
+        pos += CAJA_CABECERA_BLOQUE + b.largo;
+        n++;
+    }
+    if (usado) *usado = pos;
+    return n;
+}
+
+// ===========================================================
+//  ESCRITOR
+// ===========================================================
+void caja_escritor_init(caja_escritor_t *w, const caja_almacen_t *almacen)
+{
+    memset(w, 0, sizeof(*w));
+    w->almacen = almacen;
+
+    // sector con la secuencia más alta (comparación circular de seq)
+    uint8_t cab[CAJA_CABECERA_SECTOR];
+    for (uint32_t s = 0; s < almacen->n_sectores; s++) {
+        if (!almacen->leer(almacen->ctx, s * CAJA_SECTOR, cab, sizeof(cab))) continue;
+        if (get_u32(cab) != CAJA_MAGIC || get_u16(cab + 8) != crc16_ccitt(cab, 8)) continue;
+        uint32_t seq = get_u32(cab + 4);
+        if (!w->hay_sector || (int32_t)(seq - w->seq) > 0) {
+            w->hay_sector = true;
+            w->seq = seq;
+            w->sector = s;
+        }
+    }
+    if (!w->hay_sector) return;
+
+    // retomar a continuación del último bloque íntegro si lo que sigue está borrado
+    uint8_t *buf = malloc(CAJA_SECTOR);
+    if (buf == NULL) return;
+    if (almacen->leer(almacen->ctx, w->sector * CAJA_SECTOR, buf, CAJA_SECTOR)) {
+        uint32_t usado;
+        if (caja_decodificar_sector(buf, NULL, &usado, NULL, NULL) >= 0) {
+            bool limpio = true;
+            for (uint32_t i = usado; i < CAJA_SECTOR && i < usado + CAJA_CABECERA_BLOQUE; i++)
+                if (buf[i] != 0xFF) limpio = false;
+            w->usado = usado;
+            w->abierto = limpio;
+        }
+    }
+    free(buf);
+}
+
+static bool abrir_sector(caja_escritor_t *w)
+{
+    const caja_almacen_t *a = w->almacen;
+    if (w->hay_sector) {
+        w->sector = (w->sector + 1) % a->n_sectores;
+        w->seq++;
+    }
+
+    uint32_t base = w->sector * CAJA_SECTOR;
+    if (!a->borrar_sector(a->ctx, base)) return false;
+    w->sectores_borrados++;
+
+    uint8_t cab[CAJA_CABECERA_SECTOR];
+    uint8_t *q = put_u32(cab, CAJA_MAGIC);
+    q = put_u32(q, w->seq);
+    put_u16(q, crc16_ccitt(cab, 8));
+    if (!a->escribir(a->ctx, base, cab, sizeof(cab))) return false;
+
+    w->hay_sector = true;
+    w->abierto = true;
+    w->usado = CAJA_CABECERA_SECTOR;
+    w->bytes_escritos += sizeof(cab);
+    return true;
+}
+
+bool caja_escritor_agregar(caja_escritor_t *w, const caja_bloque_t *b, uint8_t *registro)
+{
+    size_t total = CAJA_CABECERA_BLOQUE + b->largo;
+    if (total > CAJA_SECTOR - CAJA_CABECERA_SECTOR) return false;
+    if (!w->abierto || w->usado + total > CAJA_SECTOR) {
+        w->abierto = false;
+        if (!abrir_sector(w)) return false;
+    }
+
+    registro[0] = CAJA_MARCA_BLOQUE;
+    registro[3] = b->flags;
+    put_u16(registro + 4, b->largo);
+    put_u16(registro + 6, b->crudo);
+    put_u32(registro + 8, b->t_ms);
+    put_u32(registro + 12, b->perdidos);
+    put_u16(registro + 1, crc16_ccitt(registro + 3, total - 3));
+
+    bool ok = w->almacen->escribir(w->almacen->ctx, w->sector * CAJA_SECTOR + w->usado, registro, total);
+    w->usado += total;
+    w->bytes_escritos += total;
+    w->bloques_escritos++;
+    return ok;
+}
@@ -0,0 +1,112 @@
+#ifndef CAJA_NEGRA_CODEC_H
+#define CAJA_NEGRA_CODEC_H
+
+// Compresión por bloques del flujo crudo del receptor y formato de la partición
+// circular "caja_negra". Sin dependencias de FreeRTOS ni de flash: el acceso al
+// almacenamiento se hace con callbacks, así el mismo código corre en el firmware
+// y en host/caja_negra.
+//
+// Compresión en dos pasos, con memoria acotada y cada bloque independiente:
+//  1. Transformación NMEA: cada línea "$XXXXX,..." se expresa respecto de las dos
+//     últimas líneas del mismo tipo del bloque. Un campo repetido o un número que
+//     sigue la extrapolación lineal (hora, posición a rumbo constante) cuesta un
+//     byte; si no, residuo de la extrapolación o diferencias dígito a dígito. El
+//     checksum correcto se omite y se recalcula al decodificar. Cualquier otro
+//     byte (basura, líneas cortadas, binario) pasa literal.
+//  2. LZ77 estilo LZ4 (token, literales, offset u16) con tabla hash de 4096
+//     entradas; si el resultado no es menor, el bloque se guarda crudo.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// ==================== FORMATO EN FLASH ====================
+// Sector de 4 KB:  magic u32 | seq u32 | crc16 | bloques... hasta 0xFF (flash borrada)
+// Bloque:          marca u8 | crc16 | flags u8 | largo u16 | crudo u16 | t_ms u32 |
+//                  perdidos u32 | payload (largo bytes)
+// crc16 cubre desde flags hasta el final del payload; perdidos = bytes del receptor
+// descartados justo antes de este bloque porque la flash no daba abasto.
+#define CAJA_SECTOR             4096
+#define CAJA_MAGIC              0x31424E43  // "CNB1"
+#define CAJA_CABECERA_SECTOR    10
+#define CAJA_CABECERA_BLOQUE    16
+#define CAJA_MARCA_BLOQUE       0xB1
+#define CAJA_FLAG_COMPRIMIDO    0x01
+// Un bloque crudo siempre entra en un sector recién abierto
+#define CAJA_BLOQUE_CRUDO       (CAJA_SECTOR - CAJA_CABECERA_SECTOR - CAJA_CABECERA_BLOQUE)
+
+// ==================== COMPRESOR ====================
+#define CAJA_HASH_BITS          12
+#define CAJA_TIPOS              8       // tipos de sentencia recordados por bloque
+#define CAJA_LINEA_MAX          120     // líneas más largas no sirven de referencia
+#define CAJA_TRANSFORMADO_MAX   (2 * CAJA_BLOQUE_CRUDO + 16)
+
+typedef struct {
+    uint8_t largo;
+    uint8_t largo_anterior;
+    char linea[CAJA_LINEA_MAX];
+    char anterior[CAJA_LINEA_MAX];      // la línea previa del mismo tipo, para extrapolar
+} caja_referencia_t;
+
+typedef struct {
+    caja_referencia_t ref[CAJA_TIPOS];
+    uint8_t proxima;                    // reemplazo circular cuando no hay lugar
+} caja_referencias_t;
+
+// Estado de trabajo (~17 KB): se reutiliza entre bloques, no se guarda nada
+typedef struct {
+    uint16_t hash[1 << CAJA_HASH_BITS];
+    caja_referencias_t refs;
+    uint8_t transformado[CAJA_TRANSFORMADO_MAX];
+} caja_compresor_t;
+
+// Comprime largo bytes (≤ CAJA_BLOQUE_CRUDO) en salida (capacidad max). Devuelve el
+// largo comprimido o 0 si no resulta menor que max (guardar crudo).
+size_t caja_comprimir(caja_compresor_t *c, const uint8_t *crudo, size_t largo, uint8_t *salida, size_t max);
+// Reconstruye exactamente largo_crudo bytes. Usa c como memoria de trabajo.
+bool caja_descomprimir(caja_compresor_t *c, const uint8_t *comp, size_t largo, uint8_t *salida, size_t largo_crudo);
+
+// ==================== ALMACENAMIENTO ====================
+// Offsets relativos al inicio de la partición
+typedef struct {
+    void *ctx;
+    uint32_t n_sectores;
+    bool (*leer)(void *ctx, uint32_t offset, void *dst, size_t len);
+    bool (*escribir)(void *ctx, uint32_t offset, const void *src, size_t len);
+    bool (*borrar_sector)(void *ctx, uint32_t offset);
+} caja_almacen_t;
+
+typedef struct {
+    uint8_t flags;
+    uint16_t largo;             // bytes de payload en flash
+    uint16_t crudo;             // bytes del receptor
+    uint32_t t_ms;              // reloj del equipo al empezar el bloque
+    uint32_t perdidos;
+} caja_bloque_t;
+
+typedef struct {
+    const caja_almacen_t *almacen;
+    uint32_t sector;
+    uint32_t seq;
+    uint32_t usado;
+    bool abierto;
+    bool hay_sector;
+    uint32_t bloques_escritos;  // estadísticas
+    uint32_t bytes_escritos;
+    uint32_t sectores_borrados;
+} caja_escritor_t;
+
+// Busca el sector más reciente y continúa a continuación del último bloque íntegro
+void caja_escritor_init(caja_escritor_t *w, const caja_almacen_t *almacen);
+// registro: CAJA_CABECERA_BLOQUE bytes libres seguidos del payload (b->largo bytes);
+// la cabecera se completa acá y todo se escribe de una vez.
+bool caja_escritor_agregar(caja_escritor_t *w, const caja_bloque_t *b, uint8_t *registro);
+
+// ==================== LECTURA ====================
+typedef void (*caja_bloque_cb)(void *ctx, const caja_bloque_t *b, const uint8_t *payload);
+
+// Recorre los bloques íntegros de un sector. Devuelve la cantidad o -1 si la cabecera
+// no es válida; usado = bytes válidos (cabecera + bloques).
+int caja_decodificar_sector(const uint8_t *sector, uint32_t *seq, uint32_t *usado, caja_bloque_cb cb, void *ctx);
+
+#endif // CAJA_NEGRA_CODEC_H
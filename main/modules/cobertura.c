@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <esp_log.h>
+#include <esp_partition.h>
+
+#include "modules/cobertura.h"
+#include "modules/cobertura_codec.h"
+
+static const char *TAG = "COBERTURA";
+
+#define COBERTURA_SUBTIPO_PARTICION 0x43
+
+static const esp_partition_t *particion = NULL;
+static QueueHandle_t cola_celdas = NULL;
+
+static cobertura_almacen_t almacen;
+static cobertura_log_t registro;
+static cobertura_mapa_t mapa;
+static cobertura_indice_t indice[CONFIG_COBERTURA_MAX_TILES];
+static cobertura_tile_t tiles[CONFIG_COBERTURA_TILES_RAM];
+
+static cobertura_celda_t ultima_celda = { UINT32_MAX, UINT32_MAX };
+static uint32_t celdas_descartadas = 0;
+
+// ===========================================================
+//  ACCESO A LA PARTICIÓN
+// ===========================================================
+static bool flash_leer(void *ctx, uint32_t offset, void *dst, size_t len)
+{
+    return esp_partition_read(particion, offset, dst, len) == ESP_OK;
+}
+
+static bool flash_escribir(void *ctx, uint32_t offset, const void *src, size_t len)
+{
+    return esp_partition_write(particion, offset, src, len) == ESP_OK;
+}
+
+static bool flash_borrar_sector(void *ctx, uint32_t offset)
+{
+    return esp_partition_erase_range(particion, offset, COBERTURA_SECTOR) == ESP_OK;
+}
+
+// ===========================================================
+//  INICIALIZACIÓN
+// ===========================================================
+void init_cobertura(void)
+{
+    particion = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, COBERTURA_SUBTIPO_PARTICION, "cobertura");
+    if (particion == NULL) {
+        ESP_LOGE(TAG, "No existe la partición 'cobertura' (revisar partitions.csv)");
+        return;
+    }
+
+    almacen.ctx = NULL;
+    almacen.n_sectores = particion->size / COBERTURA_SECTOR;
+    almacen.leer = flash_leer;
+    almacen.escribir = flash_escribir;
+    almacen.borrar_sector = flash_borrar_sector;
+
+    if (!cobertura_log_init(&registro, &almacen, CONFIG_COBERTURA_CELDA_M, indice, CONFIG_COBERTURA_MAX_TILES)) {
+        ESP_LOGW(TAG, "La partición tiene otro tamaño de celda: se empieza un mapa nuevo de %d m",
+                 CONFIG_COBERTURA_CELDA_M);
+    }
+    cobertura_mapa_init(&mapa, &registro, tiles, CONFIG_COBERTURA_TILES_RAM);
+
+    cola_celdas = xQueueCreate(CONFIG_COBERTURA_COLA, sizeof(cobertura_celda_t));
+
+    ESP_LOGI(TAG, "Partición cobertura: %lu sectores (%lu en uso), %lu tiles de celdas de %d m",
+             (unsigned long)almacen.n_sectores, (unsigned long)registro.usados,
+             (unsigned long)registro.n_indice, CONFIG_COBERTURA_CELDA_M);
+}
+
+// ===========================================================
+//  ENTRADA DESDE EL LECTOR GPS
+// ===========================================================
+void cobertura_registrar_fix(const gps_data_t *gps)
+{
+    if (cola_celdas == NULL) return;
+
+    cobertura_celda_t c;
+    if (!cobertura_celda(gps->latitude, gps->longitude, CONFIG_COBERTURA_CELDA_M, &c)) return;
+    if (c.x == ultima_celda.x && c.y == ultima_celda.y) return;    // casi todos los fixes
+
+    if (xQueueSend(cola_celdas, &c, 0) == pdTRUE) {
+        ultima_celda = c;
+    } else {
+        celdas_descartadas++;
+    }
+}
+
+// ===========================================================
+//  TAREA: MARCAR Y ESCRIBIR
+// ===========================================================
+void task_cobertura(void *pvParameters)
+{
+    cobertura_celda_t c;
+    TickType_t ultimo_vaciado = xTaskGetTickCount();
+
+    while (1) {
+        if (cola_celdas == NULL) {
+            vTaskDelay(pdMS_TO_TICKS(10000));
+            continue;
+        }
+
+        if (xQueueReceive(cola_celdas, &c, pdMS_TO_TICKS(1000)) == pdTRUE) {
+            cobertura_marcar(&mapa, &c);
+        }
+
+        // limitar lo que se pierde ante un corte de energía
+        if (xTaskGetTickCount() - ultimo_vaciado > pdMS_TO_TICKS(CONFIG_COBERTURA_VACIAR_S * 1000)) {
+            if (!cobertura_vaciar(&mapa)) {
+                ESP_LOGE(TAG, "Error escribiendo en la partición cobertura%s",
+                         registro.lleno ? " (llena)" : "");
+            }
+            ESP_LOGI(TAG, "🗺️ %lu celdas nuevas, %lu tiles, %lu bytes escritos, %lu sectores borrados",
+                     (unsigned long)mapa.celdas_nuevas, (unsigned long)registro.n_indice,
+                     (unsigned long)registro.bytes_escritos, (unsigned long)registro.sectores_borrados);
+            ultimo_vaciado = xTaskGetTickCount();
+        }
+    }
+}
+
+// ===========================================================
+//  GETTERS DE DIAGNÓSTICO
+// ===========================================================
+uint32_t cobertura_get_celdas_nuevas(void) { return mapa.celdas_nuevas; }
+uint32_t cobertura_get_celdas_descartadas(void) { return celdas_descartadas; }
+uint32_t cobertura_get_tiles(void) { return registro.n_indice; }
+uint32_t cobertura_get_bytes_escritos(void) { return registro.bytes_escritos; }
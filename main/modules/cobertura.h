@@ -0,0 +1,25 @@
+#ifndef COBERTURA_H
+#define COBERTURA_H
+
+#include <stdint.h>
+
+#include "modules/nmea_parser.h"
+
+// Mapa de las celdas recorridas en la partición "cobertura" (formato en
+// cobertura_codec.h). El lector GPS solo calcula la celda y la encola cuando
+// cambia; marcar el bit y escribir en flash ocurren en task_cobertura.
+// Exportar con host/cobertura exportar.
+
+void init_cobertura(void);
+// Llamado por cada fix válido; nunca bloquea (descarta si la cola está llena)
+void cobertura_registrar_fix(const gps_data_t *gps);
+
+void task_cobertura(void *pvParameters);
+
+// GETTERS DE DIAGNÓSTICO
+uint32_t cobertura_get_celdas_nuevas(void);
+uint32_t cobertura_get_celdas_descartadas(void);
+uint32_t cobertura_get_tiles(void);
+uint32_t cobertura_get_bytes_escritos(void);
+
+#endif // COBERTURA_H
@@ -0,0 +1,428 @@
+#include <math.h>
+#include <string.h>
+
+#include "modules/cobertura_codec.h"
+#include "modules/varint.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// ===========================================================
+//  GRILLA
+// ===========================================================
+static double paso_longitud(uint32_t y, double paso)
+{
+    double lat_centro = (y + 0.5) * paso - 90.0;
+    double c = cos(lat_centro * M_PI / 180.0);
+    return paso / (c > 0.01 ? c : 0.01);    // cerca de los polos, celdas más anchas
+}
+
+bool cobertura_celda(double lat, double lon, uint16_t celda_m, cobertura_celda_t *c)
+{
+    if (celda_m < COBERTURA_CELDA_MIN_M || !(lat >= -90.0 && lat < 90.0) || !(lon >= -180.0 && lon < 180.0)) return false;
+    double paso = celda_m / COBERTURA_METROS_GRADO;
+    c->y = (uint32_t)((lat + 90.0) / paso);
+    c->x = (uint32_t)((lon + 180.0) / paso_longitud(c->y, paso));
+    return true;
+}
+
+void cobertura_celda_limites(const cobertura_celda_t *c, uint16_t celda_m,
+                             double *lat_min, double *lat_max, double *lon_min, double *lon_max)
+{
+    double paso = celda_m / COBERTURA_METROS_GRADO;
+    double paso_lon = paso_longitud(c->y, paso);
+    *lat_min = c->y * paso - 90.0;
+    *lat_max = *lat_min + paso;
+    *lon_min = c->x * paso_lon - 180.0;
+    *lon_max = *lon_min + paso_lon;
+}
+
+// ===========================================================
+//  CODIFICACIÓN DE TILES
+// ===========================================================
+size_t cobertura_codificar_tile(const uint8_t *bits, uint8_t *salida, uint8_t *tipo)
+{
+    // corridas alternadas empezando por ceros; la última corrida de ceros se omite.
+    // Cada corrida es < 4096: ocupa 1 o 2 bytes.
+    const uint8_t *fin = salida + COBERTURA_TILE_BYTES - 2;
+    uint8_t *o = salida;
+    bool uno = false;
+    uint32_t corrida = 0;
+
+    for (size_t i = 0; i < COBERTURA_TILE_BYTES; i++) {
+        uint8_t b = bits[i];
+        if (b == (uno ? 0xFF : 0x00)) {
+            corrida += 8;
+            continue;
+        }
+        for (int k = 0; k < 8; k++) {
+            if ((bool)((b >> k) & 1) == uno) {
+                corrida++;
+                continue;
+            }
+            if (o >= fin) goto denso;
+            o = put_varint(o, corrida);
+            uno = !uno;
+            corrida = 1;
+        }
+    }
+    if (uno) {
+        if (o >= fin) goto denso;
+        o = put_varint(o, corrida);
+    }
+    *tipo = COBERTURA_TIPO_RLE;
+    return (size_t)(o - salida);
+
+denso:
+    memcpy(salida, bits, COBERTURA_TILE_BYTES);
+    *tipo = COBERTURA_TIPO_DENSO;
+    return COBERTURA_TILE_BYTES;
+}
+
+bool cobertura_decodificar_tile(uint8_t tipo, const uint8_t *payload, size_t largo, uint8_t *bits)
+{
+    if (tipo == COBERTURA_TIPO_DENSO) {
+        if (largo != COBERTURA_TILE_BYTES) return false;
+        memcpy(bits, payload, COBERTURA_TILE_BYTES);
+        return true;
+    }
+    if (tipo != COBERTURA_TIPO_RLE) return false;
+
+    memset(bits, 0, COBERTURA_TILE_BYTES);
+    const uint8_t *p = payload, *fin = payload + largo;
+    uint32_t pos = 0;
+    bool uno = false;
+    while (p < fin) {
+        uint32_t corrida;
+        p = get_varint(p, fin, &corrida);
+        if (p == NULL || corrida > COBERTURA_TILE_BITS - pos) return false;
+        if (uno)
+            for (uint32_t i = pos; i < pos + corrida; i++) bits[i >> 3] |= (uint8_t)(1 << (i & 7));
+        pos += corrida;
+        uno = !uno;
+    }
+    return true;
+}
+
+// ===========================================================
+//  ÍNDICE (ordenado por clave)
+// ===========================================================
+static bool buscar_indice(const cobertura_log_t *log, uint32_t clave, uint32_t *pos)
+{
+    uint32_t lo = 0, hi = log->n_indice;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (log->indice[mid].clave < clave) lo = mid + 1;
+        else hi = mid;
+    }
+    *pos = lo;
+    return lo < log->n_indice && log->indice[lo].clave == clave;
+}
+
+static bool actualizar_indice(cobertura_log_t *log, uint32_t clave, uint32_t offset)
+{
+    uint32_t pos;
+    if (!buscar_indice(log, clave, &pos)) {
+        if (log->n_indice >= log->max_indice) return false;
+        memmove(&log->indice[pos + 1], &log->indice[pos], (log->n_indice - pos) * sizeof(cobertura_indice_t));
+        log->indice[pos].clave = clave;
+        log->n_indice++;
+    }
+    log->indice[pos].offset = offset;
+    return true;
+}
+
+// ===========================================================
+//  SECTORES
+// ===========================================================
+static bool leer_cabecera_sector(const uint8_t *cab, uint32_t *seq, uint16_t *celda_m)
+{
+    if (get_u32(cab) != COBERTURA_MAGIC || get_u16(cab + 10) != crc16_ccitt(cab, 10)) return false;
+    *seq = get_u32(cab + 4);
+    *celda_m = get_u16(cab + 8);
+    return true;
+}
+
+typedef void (*registro_cb)(cobertura_log_t *log, uint32_t offset, const uint8_t *registro, size_t largo);
+
+// Recorre los registros íntegros del sector en log->sector; devuelve los bytes válidos
+static uint32_t recorrer_sector(cobertura_log_t *log, uint32_t base, registro_cb cb)
+{
+    const uint8_t *s = log->sector;
+    uint32_t p = COBERTURA_CABECERA_SECTOR;
+    while (p + COBERTURA_CABECERA_REGISTRO <= COBERTURA_SECTOR && s[p] == COBERTURA_MARCA_REGISTRO) {
+        size_t largo = COBERTURA_CABECERA_REGISTRO + get_u16(s + p + 8);
+        if (p + largo > COBERTURA_SECTOR || get_u16(s + p + 1) != crc16_ccitt(s + p + 3, largo - 3)) break;
+        if (cb) cb(log, base + p, s + p, largo);
+        p += (uint32_t)largo;
+    }
+    return p;
+}
+
+static void indexar(cobertura_log_t *log, uint32_t offset, const uint8_t *registro, size_t largo)
+{
+    actualizar_indice(log, get_u32(registro + 4), offset);
+}
+
+// ===========================================================
+//  REGISTRO EN FLASH
+// ===========================================================
+bool cobertura_log_init(cobertura_log_t *log, const cobertura_almacen_t *almacen, uint16_t celda_m,
+                        cobertura_indice_t *indice, uint32_t max_indice)
+{
+    memset(log, 0, sizeof(*log));
+    log->almacen = almacen;
+    log->celda_m = celda_m;
+    log->indice = indice;
+    log->max_indice = max_indice;
+
+    // sector más reciente (comparación circular de seq)
+    uint32_t n = almacen->n_sectores;
+    uint8_t cab[COBERTURA_CABECERA_SECTOR];
+    uint16_t celda_cabeza = 0;
+    bool hay = false;
+    for (uint32_t s = 0; s < n; s++) {
+        uint32_t seq;
+        uint16_t celda;
+        if (!almacen->leer(almacen->ctx, s * COBERTURA_SECTOR, cab, sizeof(cab))) continue;
+        if (!leer_cabecera_sector(cab, &seq, &celda)) continue;
+        if (!hay || (int32_t)(seq - log->seq) > 0) {
+            hay = true;
+            log->seq = seq;
+            log->cabeza = s;
+            celda_cabeza = celda;
+        }
+    }
+    if (!hay) return true;
+    if (celda_cabeza != celda_m) return false;     // otra grilla: se empieza de cero después de log->seq
+
+    // hacia atrás mientras las secuencias sean consecutivas; siempre queda un sector libre
+    log->cola = log->cabeza;
+    log->usados = 1;
+    uint32_t seq_cola = log->seq;
+    while (log->usados < n - 1) {
+        uint32_t s = (log->cola + n - 1) % n, seq;
+        uint16_t celda;
+        if (!almacen->leer(almacen->ctx, s * COBERTURA_SECTOR, cab, sizeof(cab))) break;
+        if (!leer_cabecera_sector(cab, &seq, &celda) || celda != celda_m || seq != seq_cola - 1) break;
+        log->cola = s;
+        seq_cola = seq;
+        log->usados++;
+    }
+
+    // el índice se arma en orden: el registro más nuevo de cada tile queda último
+    for (uint32_t i = 0; i < log->usados; i++) {
+        uint32_t s = (log->cola + i) % n;
+        if (!almacen->leer(almacen->ctx, s * COBERTURA_SECTOR, log->sector, COBERTURA_SECTOR)) continue;
+        uint32_t usado = recorrer_sector(log, s * COBERTURA_SECTOR, indexar);
+        if (s == log->cabeza) {
+            // retomar solo si lo que sigue está borrado; si no, el próximo registro abre sector
+            bool limpio = true;
+            for (uint32_t k = usado; k < COBERTURA_SECTOR && k < usado + COBERTURA_CABECERA_REGISTRO; k++)
+                if (log->sector[k] != 0xFF) limpio = false;
+            log->usado = limpio ? usado : COBERTURA_SECTOR;
+        }
+    }
+    return true;
+}
+
+static void copiar_vigente(cobertura_log_t *log, uint32_t offset, const uint8_t *registro, size_t largo)
+{
+    uint32_t pos;
+    if (!buscar_indice(log, get_u32(registro + 4), &pos) || log->indice[pos].offset != offset) return;
+    const cobertura_almacen_t *a = log->almacen;
+    uint32_t destino = log->cabeza * COBERTURA_SECTOR + log->usado;
+    if (!a->escribir(a->ctx, destino, registro, largo)) return;
+    log->indice[pos].offset = destino;
+    log->usado += (uint32_t)largo;
+    log->bytes_escritos += (uint32_t)largo;
+    log->registros_copiados++;
+}
+
+// Pasa los registros vigentes del sector más viejo a la cabeza recién abierta y lo libera.
+// Entran siempre: lo vigente de un sector nunca supera lo que cabe en uno vacío.
+static void recolectar(cobertura_log_t *log)
+{
+    const cobertura_almacen_t *a = log->almacen;
+    uint32_t base = log->cola * COBERTURA_SECTOR;
+    if (a->leer(a->ctx, base, log->sector, COBERTURA_SECTOR)) recorrer_sector(log, base, copiar_vigente);
+
+    // invalidar la cabecera (bajar bits no requiere borrar); se borra al volver a abrirlo
+    static const uint8_t cero[4] = { 0 };
+    a->escribir(a->ctx, base, cero, sizeof(cero));
+    log->cola = (log->cola + 1) % a->n_sectores;
+    log->usados--;
+}
+
+static bool abrir_sector(cobertura_log_t *log)
+{
+    const cobertura_almacen_t *a = log->almacen;
+    uint32_t s = log->usados ? (log->cabeza + 1) % a->n_sectores : log->cabeza;
+    uint32_t base = s * COBERTURA_SECTOR;
+    if (!a->borrar_sector(a->ctx, base)) return false;
+    log->sectores_borrados++;
+
+    uint8_t cab[COBERTURA_CABECERA_SECTOR];
+    uint8_t *q = put_u32(cab, COBERTURA_MAGIC);
+    q = put_u32(q, ++log->seq);
+    q = put_u16(q, log->celda_m);
+    put_u16(q, crc16_ccitt(cab, 10));
+    if (!a->escribir(a->ctx, base, cab, sizeof(cab))) return false;
+
+    if (log->usados == 0) log->cola = s;
+    log->cabeza = s;
+    log->usados++;
+    log->usado = COBERTURA_CABECERA_SECTOR;
+    log->bytes_escritos += sizeof(cab);
+
+    if (log->usados == a->n_sectores && a->n_sectores > 1) recolectar(log);
+    return true;
+}
+
+// Deja lugar para largo bytes en la cabeza. Falla si la partición está llena de
+// registros vigentes (cada vuelta libera un sector pero lo vuelve a llenar).
+static bool reservar(cobertura_log_t *log, size_t largo)
+{
+    if (log->lleno) return false;
+    for (uint32_t i = 0; i <= log->almacen->n_sectores; i++) {
+        if (log->usados && log->usado + largo <= COBERTURA_SECTOR) return true;
+        if (!abrir_sector(log)) return false;
+    }
+    log->lleno = true;
+    return false;
+}
+
+bool cobertura_log_guardar(cobertura_log_t *log, uint32_t clave, const uint8_t *bits)
+{
+    uint32_t pos;
+    if (!buscar_indice(log, clave, &pos) && log->n_indice >= log->max_indice) return false;
+
+    uint8_t *r = log->registro;
+    uint8_t tipo;
+    size_t n = cobertura_codificar_tile(bits, r + COBERTURA_CABECERA_REGISTRO, &tipo);
+    size_t largo = COBERTURA_CABECERA_REGISTRO + n;
+    r[0] = COBERTURA_MARCA_REGISTRO;
+    r[3] = tipo;
+    put_u32(r + 4, clave);
+    put_u16(r + 8, (uint16_t)n);
+    put_u16(r + 1, crc16_ccitt(r + 3, largo - 3));
+
+    if (!reservar(log, largo)) return false;
+    const cobertura_almacen_t *a = log->almacen;
+    uint32_t offset = log->cabeza * COBERTURA_SECTOR + log->usado;
+    if (!a->escribir(a->ctx, offset, r, largo)) return false;
+    log->usado += (uint32_t)largo;
+    log->bytes_escritos += (uint32_t)largo;
+    log->registros_escritos++;
+    return actualizar_indice(log, clave, offset);
+}
+
+bool cobertura_log_cargar(cobertura_log_t *log, uint32_t clave, uint8_t *bits)
+{
+    memset(bits, 0, COBERTURA_TILE_BYTES);
+    uint32_t pos;
+    if (!buscar_indice(log, clave, &pos)) return false;
+
+    const cobertura_almacen_t *a = log->almacen;
+    uint8_t *r = log->registro;
+    uint32_t offset = log->indice[pos].offset;
+    if (!a->leer(a->ctx, offset, r, COBERTURA_CABECERA_REGISTRO)) return false;
+    size_t n = get_u16(r + 8);
+    if (r[0] != COBERTURA_MARCA_REGISTRO || get_u32(r + 4) != clave || n > COBERTURA_TILE_BYTES) return false;
+    if (!a->leer(a->ctx, offset + COBERTURA_CABECERA_REGISTRO, r + COBERTURA_CABECERA_REGISTRO, n)) return false;
+    if (get_u16(r + 1) != crc16_ccitt(r + 3, COBERTURA_CABECERA_REGISTRO - 3 + n)) return false;
+    return cobertura_decodificar_tile(r[3], r + COBERTURA_CABECERA_REGISTRO, n, bits);
+}
+
+// ===========================================================
+//  MAPA EN RAM
+// ===========================================================
+void cobertura_mapa_init(cobertura_mapa_t *m, cobertura_log_t *log, cobertura_tile_t *tiles, uint8_t n_tiles)
+{
+    memset(m, 0, sizeof(*m));
+    memset(tiles, 0, n_tiles * sizeof(cobertura_tile_t));
+    m->log = log;
+    m->tiles = tiles;
+    m->n_tiles = n_tiles;
+}
+
+static inline uint32_t hash_tile(const cobertura_mapa_t *m, uint32_t clave)
+{
+    return ((clave * 2654435761u) >> 16) % m->n_tiles;
+}
+
+// Sondeo lineal; los slots nunca se vacían (el desalojo reemplaza en el lugar),
+// así que una clave ausente termina en un slot libre o recorriendo toda la tabla.
+static int buscar_slot(const cobertura_mapa_t *m, uint32_t clave)
+{
+    const cobertura_tile_t *t = &m->tiles[m->ultimo];
+    if (t->ocupado && t->clave == clave) return m->ultimo;
+    uint32_t h = hash_tile(m, clave);
+    for (uint32_t i = 0; i < m->n_tiles; i++) {
+        uint32_t s = (h + i) % m->n_tiles;
+        if (!m->tiles[s].ocupado) return -1;
+        if (m->tiles[s].clave == clave) return (int)s;
+    }
+    return -1;
+}
+
+static int traer_tile(cobertura_mapa_t *m, uint32_t clave)
+{
+    uint32_t h = hash_tile(m, clave);
+    int s = -1;
+    for (uint32_t i = 0; i < m->n_tiles && s < 0; i++)
+        if (!m->tiles[(h + i) % m->n_tiles].ocupado) s = (int)((h + i) % m->n_tiles);
+
+    if (s < 0) {
+        // tabla llena: desalojar el menos usado
+        s = 0;
+        for (uint32_t i = 1; i < m->n_tiles; i++)
+            if (m->tiles[i].uso < m->tiles[s].uso) s = (int)i;
+        cobertura_tile_t *v = &m->tiles[s];
+        if (v->sucio && !cobertura_log_guardar(m->log, v->clave, v->bits)) m->errores++;
+        m->desalojos++;
+    }
+
+    cobertura_tile_t *t = &m->tiles[s];
+    if (cobertura_log_cargar(m->log, clave, t->bits)) m->cargas++;
+    t->clave = clave;
+    t->ocupado = true;
+    t->sucio = false;
+    return s;
+}
+
+bool cobertura_marcar(cobertura_mapa_t *m, const cobertura_celda_t *c)
+{
+    uint32_t clave = cobertura_clave(c);
+    uint16_t bit = cobertura_bit(c);
+    int s = buscar_slot(m, clave);
+    if (s < 0) s = traer_tile(m, clave);
+
+    cobertura_tile_t *t = &m->tiles[s];
+    t->uso = ++m->reloj;
+    m->ultimo = (uint8_t)s;
+
+    uint8_t mascara = (uint8_t)(1 << (bit & 7));
+    if (t->bits[bit >> 3] & mascara) return false;
+    t->bits[bit >> 3] |= mascara;
+    t->sucio = true;
+    m->celdas_nuevas++;
+    return true;
+}
+
+bool cobertura_vaciar(cobertura_mapa_t *m)
+{
+    bool ok = true;
+    for (uint32_t i = 0; i < m->n_tiles; i++) {
+        cobertura_tile_t *t = &m->tiles[i];
+        if (!t->ocupado || !t->sucio) continue;
+        if (cobertura_log_guardar(m->log, t->clave, t->bits)) {
+            t->sucio = false;
+        } else {
+            m->errores++;
+            ok = false;
+        }
+    }
+    return ok;
+}
@@ -0,0 +1,143 @@
+#ifndef COBERTURA_CODEC_H
+#define COBERTURA_CODEC_H
+
+// Mapa de cobertura: qué celdas de una grilla fija pisó el vehículo, sin guardar
+// los puntos. Sin dependencias de FreeRTOS ni de flash: el acceso al
+// almacenamiento se hace con callbacks, así el mismo código corre en el firmware
+// y en host/cobertura.
+//
+// Grilla: filas de celda_m metros en latitud; en cada fila el paso en longitud se
+// ajusta con el coseno de su latitud central, así las celdas miden ~celda_m de lado
+// en cualquier lugar. Las celdas se agrupan en tiles de 64×64 (512 bytes de bits).
+// En RAM hay unos pocos tiles densos en una tabla hash; en flash cada tile se guarda
+// denso o en RLE, lo que resulte menor. La flash crece con el área distinta
+// recorrida, no con el tiempo.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#define COBERTURA_TILE_LADO     64
+#define COBERTURA_TILE_BITS     (COBERTURA_TILE_LADO * COBERTURA_TILE_LADO)
+#define COBERTURA_TILE_BYTES    (COBERTURA_TILE_BITS / 8)
+#define COBERTURA_METROS_GRADO  111320.0
+
+// ==================== FORMATO EN FLASH ====================
+// Sector de 4 KB:  magic u32 | seq u32 | celda_m u16 | crc16 | registros... hasta 0xFF
+// Registro:        marca u8 | crc16 | tipo u8 | clave u32 | largo u16 | payload
+// crc16 cubre desde tipo hasta el final del payload. Cada registro es el estado
+// completo del tile: vale el más reciente. Los sectores forman un anillo; al llenarse,
+// los registros todavía vigentes del sector más viejo se copian al nuevo.
+#define COBERTURA_SECTOR            4096
+#define COBERTURA_MAGIC             0x31424F43  // "COB1"
+#define COBERTURA_CABECERA_SECTOR   12
+#define COBERTURA_CABECERA_REGISTRO 10
+#define COBERTURA_MARCA_REGISTRO    0xC0
+#define COBERTURA_TIPO_DENSO        0
+#define COBERTURA_TIPO_RLE          1       // corridas alternadas 0/1 en varint, fila por fila
+#define COBERTURA_REGISTRO_MAX      (COBERTURA_CABECERA_REGISTRO + COBERTURA_TILE_BYTES)
+
+// ==================== GRILLA ====================
+typedef struct {
+    uint32_t x;         // columna dentro de la fila
+    uint32_t y;         // fila desde el polo sur
+} cobertura_celda_t;
+
+// false si la posición está fuera de rango o celda_m < COBERTURA_CELDA_MIN_M
+bool cobertura_celda(double lat, double lon, uint16_t celda_m, cobertura_celda_t *c);
+// Rectángulo en grados de una celda (para exportar)
+void cobertura_celda_limites(const cobertura_celda_t *c, uint16_t celda_m,
+                             double *lat_min, double *lat_max, double *lon_min, double *lon_max);
+
+// La clave lleva columna y fila de tile en 16 bits cada una. En el ecuador una fila
+// tiene 40 075 km / celda_m columnas: por debajo de ~9,6 m pasan de 65536 tiles y
+// las claves se pisan. cobertura_celda rechaza celdas menores a este mínimo.
+#define COBERTURA_CELDA_MIN_M   10
+
+static inline uint32_t cobertura_clave(const cobertura_celda_t *c)
+{
+    return ((c->y / COBERTURA_TILE_LADO) << 16) | (c->x / COBERTURA_TILE_LADO);
+}
+
+static inline uint16_t cobertura_bit(const cobertura_celda_t *c)
+{
+    return (uint16_t)((c->y % COBERTURA_TILE_LADO) * COBERTURA_TILE_LADO + c->x % COBERTURA_TILE_LADO);
+}
+
+// ==================== CODIFICACIÓN DE TILES ====================
+// Elige denso o RLE; salida debe tener COBERTURA_TILE_BYTES. Devuelve el largo.
+size_t cobertura_codificar_tile(const uint8_t *bits, uint8_t *salida, uint8_t *tipo);
+bool cobertura_decodificar_tile(uint8_t tipo, const uint8_t *payload, size_t largo, uint8_t *bits);
+
+// ==================== ALMACENAMIENTO ====================
+// Offsets relativos al inicio de la partición
+typedef struct {
+    void *ctx;
+    uint32_t n_sectores;
+    bool (*leer)(void *ctx, uint32_t offset, void *dst, size_t len);
+    bool (*escribir)(void *ctx, uint32_t offset, const void *src, size_t len);
+    bool (*borrar_sector)(void *ctx, uint32_t offset);
+} cobertura_almacen_t;
+
+// Índice en RAM: registro vigente de cada tile, ordenado por clave (8 bytes por tile)
+typedef struct {
+    uint32_t clave;
+    uint32_t offset;
+} cobertura_indice_t;
+
+typedef struct {
+    const cobertura_almacen_t *almacen;
+    uint16_t celda_m;
+    uint32_t cabeza;            // sector en uso
+    uint32_t cola;              // sector más viejo con datos
+    uint32_t usados;            // sectores con datos (cola..cabeza)
+    uint32_t seq;
+    uint32_t usado;             // bytes escritos en la cabeza
+    bool lleno;                 // todo vigente: no se escribe más hasta reiniciar (evita borrados inútiles)
+    cobertura_indice_t *indice;
+    uint32_t n_indice;
+    uint32_t max_indice;
+    uint8_t sector[COBERTURA_SECTOR];   // lectura de sectores completos (arranque y recolección)
+    uint8_t registro[COBERTURA_REGISTRO_MAX];
+    uint32_t registros_escritos;        // estadísticas
+    uint32_t bytes_escritos;
+    uint32_t registros_copiados;
+    uint32_t sectores_borrados;
+} cobertura_log_t;
+
+// Recorre la partición, arma el índice y continúa después del último registro íntegro.
+// Si la partición es de otra celda_m se descarta (devuelve false en ese caso).
+bool cobertura_log_init(cobertura_log_t *log, const cobertura_almacen_t *almacen, uint16_t celda_m,
+                        cobertura_indice_t *indice, uint32_t max_indice);
+bool cobertura_log_guardar(cobertura_log_t *log, uint32_t clave, const uint8_t *bits);
+// Carga el último estado del tile; false (y bits en cero) si nunca se guardó
+bool cobertura_log_cargar(cobertura_log_t *log, uint32_t clave, uint8_t *bits);
+
+// ==================== MAPA EN RAM ====================
+typedef struct {
+    uint32_t clave;
+    uint32_t uso;               // para desalojar el menos reciente
+    bool ocupado;
+    bool sucio;
+    uint8_t bits[COBERTURA_TILE_BYTES];
+} cobertura_tile_t;
+
+typedef struct {
+    cobertura_log_t *log;
+    cobertura_tile_t *tiles;
+    uint8_t n_tiles;
+    uint8_t ultimo;             // slot del último acceso: la siguiente celda casi siempre cae ahí
+    uint32_t reloj;
+    uint32_t celdas_nuevas;     // estadísticas
+    uint32_t cargas;
+    uint32_t desalojos;
+    uint32_t errores;
+} cobertura_mapa_t;
+
+void cobertura_mapa_init(cobertura_mapa_t *m, cobertura_log_t *log, cobertura_tile_t *tiles, uint8_t n_tiles);
+// Marca la celda; true si no estaba marcada. Solo toca la flash si el tile no está en RAM.
+bool cobertura_marcar(cobertura_mapa_t *m, const cobertura_celda_t *c);
+// Guarda los tiles modificados desde el último vaciado
+bool cobertura_vaciar(cobertura_mapa_t *m);
+
+#endif // COBERTURA_CODEC_H
@@ -0,0 +1,407 @@
+#include <stdio.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <driver/gpio.h>
+#include <driver/uart.h>
+
+#include "modules/gnss.h"
+#include "modules/gnss_receptor.h"
+#include "modules/arranque.h"
+#if CONFIG_TELEMETRIA_BINARIA
+#include "modules/telemetria.h"
+#endif
+#if CONFIG_TRAYECTO
+#include "modules/trayecto.h"
+#endif
+#if CONFIG_COBERTURA
+#include "modules/cobertura.h"
+#endif
+#if CONFIG_CAJA_NEGRA
+#include "modules/caja_negra.h"
+#endif
+#if CONFIG_NMEA_REENVIO
+#include "modules/reenvio_nmea.h"
+#endif
+#if CONFIG_GPS_TASA_ADAPTATIVA
+#include "modules/tasa_adaptativa.h"
+#include "modules/monitor_velocidad.h"
+#endif
+
+static const char *TAG = "GNSS";
+
+// Registro común de fix: lo llena el receptor (NMEA o UBX) y lo leen los getters
+static gps_data_t gps;
+static gps_quality_t quality;
+
+//parametros de calibracion
+#if CONFIG_MONITOR_UMBRALES_AJUSTABLES
+static double umbral_movimiento_kmh = CONFIG_GPS_UMBRAL_MOVIMIENTO_KMH;// velocidad minima para considerar movimiento
+#else
+#define umbral_movimiento_kmh ((double)CONFIG_GPS_UMBRAL_MOVIMIENTO_KMH)
+#endif
+
+#if CONFIG_GPS_KALMAN
+static kalman_t kalman_velocidad;
+static bool kalman_listo = false;
+#endif
+
+// ===========================================================
+//  CONTADORES PARA DIAGNÓSTICO DEL GPS
+// ===========================================================
+static uint32_t contador_tramas = 0;   // cuántas líneas / tramas llegan
+static uint32_t contador_rmc = 0;      // cuántas soluciones (RMC / NAV-PVT) llegan
+
+// Fixes válidos ya filtrados: número, velocidad y hora del fix, escritos juntos al
+// final de gnss_publicar_fix. El monitor los lee desde el otro núcleo.
+static portMUX_TYPE publicado_mux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t contador_publicados = 0;
+static double vel_publicada = 0.0;
+static uint32_t t_publicado_ms = 0;
+
+// Marcas de tiempo (ticks) de la última trama con checksum válido y del último fix
+static TickType_t ts_ultima_trama = 0;
+static TickType_t ts_ultimo_fix = 0;
+static bool hubo_trama = false;
+static bool hubo_fix = false;
+
+// Configuración del receptor: frecuencia, controlador de tasa y comandos en curso.
+// La cambian config_gps (tarea de configuración o supervisor) y la tarea lectora
+// (tasa adaptativa); config_gps lo toma mientras dura la reconfiguración entera.
+static SemaphoreHandle_t receptor_mutex = NULL;
+
+// Frecuencia configurada en el receptor (define cuándo un fix está obsoleto)
+static int frecuencia_actual_hz = GPS_UPDATE_RATE_HZ;
+static uint32_t intervalo_anterior_ms = 1000 / GPS_UPDATE_RATE_HZ;
+static TickType_t ts_cambio_frecuencia = 0;
+
+#if CONFIG_GPS_TASA_ADAPTATIVA
+#define GPS_TASA_ALERTA_HZ 10
+
+static const tasa_parametros_t tasa_parametros = {
+    .margen_alerta_kmh     = CONFIG_GPS_TASA_MARGEN_ALERTA_KMH,
+    .margen_reposo_kmh     = CONFIG_GPS_TASA_MARGEN_REPOSO_KMH,
+    .umbral_movimiento_kmh = CONFIG_GPS_UMBRAL_MOVIMIENTO_KMH,
+    .acel_alta_kmh_s       = CONFIG_GPS_TASA_ACEL_ALTA_KMH_S,
+    .histeresis_kmh        = CONFIG_GPS_TASA_HISTERESIS_KMH,
+    .permanencia_ms        = CONFIG_GPS_TASA_PERMANENCIA_S * 1000,
+};
+static tasa_controlador_t tasa;
+static uint32_t contador_cambios_tasa = 0;
+#define MODO_TASA_ACTUAL ((int)tasa.modo)
+#else
+#define MODO_TASA_ACTUAL 0
+#endif
+
+// ===========================================================
+//  CONFIGURACIÓN UART
+// ===========================================================
+void init_uart_gnss(void)
+{
+    const uart_config_t uart_config = {
+        .baud_rate = GPS_BAUD_RATE,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+    };
+
+    gpio_config_t reset_cfg = {
+        .pin_bit_mask = (1ULL << GPS_RST_PIN),
+        .mode = GPIO_MODE_OUTPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE
+    };
+
+    gpio_config(&reset_cfg);
+    gpio_set_level(GPS_RST_PIN, 1);
+
+    receptor_mutex = xSemaphoreCreateMutex();
+
+    uart_param_config(GPS_UART_NUM, &uart_config);
+    uart_set_pin(GPS_UART_NUM, GPS_TX_PIN, GPS_RX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    uart_driver_install(GPS_UART_NUM, GPS_BUFFER_SIZE * 2, 0, 0, NULL, 0);
+
+    ESP_LOGI(TAG, "UART GPS inicializado correctamente (receptor %s)", gnss_receptor_nombre());
+}
+
+// ===========================================================
+//  AJUSTE DE FRECUENCIA DE ACTUALIZACIÓN
+// ===========================================================
+void gnss_set_frecuencia_hz(int hz)
+{
+    if (!gnss_receptor_set_frecuencia_hz(hz)) {
+        ESP_LOGE(TAG, "❌ Frecuencia de %d Hz no válida para el %s", hz, gnss_receptor_nombre());
+        return;
+    }
+
+    // mientras el receptor aplica el cambio se tolera el intervalo más largo
+    intervalo_anterior_ms = 1000 / frecuencia_actual_hz;
+    ts_cambio_frecuencia = xTaskGetTickCount();
+    frecuencia_actual_hz = hz;
+
+    ESP_LOGI(TAG, "🟢 Frecuencia del GPS configurada a %d Hz", hz);
+}
+
+// ===========================================================
+//  CONFIGURAR GPS
+// ===========================================================
+void config_gps(void){
+    xSemaphoreTake(receptor_mutex, portMAX_DELAY);
+#if CONFIG_ARRANQUE_TIBIO
+    arranque_guardar_receptor(false, frecuencia_actual_hz, 0);  // un reset a mitad obliga a repetir
+#endif
+#if CONFIG_GPS_TASA_ADAPTATIVA
+    tasa_init(&tasa, &tasa_parametros, TASA_NORMAL);
+#endif
+    gnss_set_frecuencia_hz(GPS_UPDATE_RATE_HZ);
+    vTaskDelay(pdMS_TO_TICKS(200));
+
+#if GNSS_CON_CALIDAD
+    gnss_receptor_configurar(true);
+#else
+    gnss_receptor_configurar(false);  // GGA no se procesa: no pedirla
+#endif
+    vTaskDelay(pdMS_TO_TICKS(200));
+
+    uart_flush(GPS_UART_NUM);         //Limpiar todo el buffer
+    vTaskDelay(pdMS_TO_TICKS(200));  //Esperar a que la configuración se aplique
+
+#if CONFIG_ARRANQUE_TIBIO
+    arranque_guardar_receptor(true, frecuencia_actual_hz, MODO_TASA_ACTUAL);
+#endif
+    xSemaphoreGive(receptor_mutex);
+}
+
+void task_config_gps(void *pvParameters)
+{
+    int64_t inicio = esp_timer_get_time();
+
+#if CONFIG_ARRANQUE_TIBIO
+    const arranque_rtc_t *rtc = arranque_estado_tibio();
+    if (rtc != NULL && rtc->hay_fix) {
+        gps = rtc->fix;             // posición disponible antes del primer fix (no vigente)
+    }
+    if (rtc != NULL && rtc->receptor_configurado && rtc->frecuencia_hz > 0) {
+        // El receptor no se reinició con el ESP32: sigue con la configuración anterior
+        xSemaphoreTake(receptor_mutex, portMAX_DELAY);
+        frecuencia_actual_hz = rtc->frecuencia_hz;
+        intervalo_anterior_ms = 1000 / frecuencia_actual_hz;
+#if CONFIG_GPS_TASA_ADAPTATIVA
+        tasa_init(&tasa, &tasa_parametros, (tasa_modo_t)rtc->modo_tasa);
+#endif
+        xSemaphoreGive(receptor_mutex);
+        ESP_LOGI(TAG, "♻️ Receptor ya configurado (%d Hz): sin reenviar comandos", frecuencia_actual_hz);
+        vTaskDelete(NULL);
+        return;
+    }
+#endif
+
+    config_gps();
+    ESP_LOGI(TAG, "⏱️ Receptor configurado en %d ms (%d ms desde el reset)",
+             (int)((esp_timer_get_time() - inicio) / 1000), (int)(esp_timer_get_time() / 1000));
+    vTaskDelete(NULL);
+}
+
+// ===========================================================
+//  FRECUENCIA ADAPTATIVA
+// ===========================================================
+#if CONFIG_GPS_TASA_ADAPTATIVA
+// Se llama desde la tarea lectora con receptor_mutex tomado: solo escribe en el UART, sin flush ni esperas
+// (el receptor aplica los comandos entre dos fixes y las tramas en curso siguen válidas).
+static void aplicar_modo_tasa(tasa_modo_t modo)
+{
+#if GNSS_CON_CALIDAD
+    gnss_receptor_set_mensajes(tasa_con_gga(modo));
+#else
+    gnss_receptor_set_mensajes(false);
+#endif
+    gnss_set_frecuencia_hz(tasa_frecuencia_hz(modo, GPS_UPDATE_RATE_HZ, GPS_TASA_ALERTA_HZ));
+    contador_cambios_tasa++;
+#if CONFIG_ARRANQUE_TIBIO
+    arranque_guardar_receptor(true, frecuencia_actual_hz, modo);
+#endif
+
+    ESP_LOGI(TAG, "⚡ Tasa adaptativa: %s (%d Hz)", tasa_nombre(modo), frecuencia_actual_hz);
+}
+
+uint32_t gps_get_contador_cambios_tasa(void) { return contador_cambios_tasa; }
+#endif
+
+
+// ===========================================================
+//  FUNCIONES DE LECTURA Y ESCRITURA DE DATOS GPS
+// ===========================================================
+
+// getters
+double gps_get_speed_kmh(void){return gps.speed_kmh;}
+const char *gps_get_hora_utc(void){return gps.time;}
+double gps_get_umbral_movimiento(void){return umbral_movimiento_kmh;}
+double gps_get_latitude(void){return gps.latitude;}
+double gps_get_longitude(void){return gps.longitude;}
+double gps_get_altitude(void){return quality.altitude;}
+int gps_get_satellites(void){return quality.satellites;}
+double gps_get_hdop(void){return quality.hdop;}
+bool gps_is_valid(void){return gps.valid;}
+
+// ===========================================================
+// GETTERS DEL DIAGNÓSTICO GPS
+// ===========================================================
+uint32_t gps_get_contador_tramas(void) { return contador_tramas; }
+uint32_t gps_get_contador_rmc(void) { return contador_rmc; }
+
+uint32_t gps_get_fix_publicado(double *vel, uint32_t *t_ms)
+{
+    portENTER_CRITICAL(&publicado_mux);
+    uint32_t n = contador_publicados;
+    *vel = vel_publicada;
+    *t_ms = t_publicado_ms;
+    portEXIT_CRITICAL(&publicado_mux);
+    return n;
+}
+
+uint32_t gps_get_intervalo_fix_ms(void)
+{
+    uint32_t intervalo = 1000 / frecuencia_actual_hz;
+    if ((xTaskGetTickCount() - ts_cambio_frecuencia) * portTICK_PERIOD_MS < 2000 && intervalo_anterior_ms > intervalo)
+        return intervalo_anterior_ms;
+    return intervalo;
+}
+
+uint32_t gps_get_edad_trama_ms(void)
+{
+    if (!hubo_trama) return UINT32_MAX;
+    return (xTaskGetTickCount() - ts_ultima_trama) * portTICK_PERIOD_MS;
+}
+
+uint32_t gps_get_edad_fix_ms(void)
+{
+    if (!hubo_fix) return UINT32_MAX;
+    return (xTaskGetTickCount() - ts_ultimo_fix) * portTICK_PERIOD_MS;
+}
+
+// El fix se considera vigente mientras no falten más de N intervalos esperados
+bool gps_fix_vigente(void)
+{
+    return gps_get_edad_fix_ms() <= CONFIG_GPS_FIX_OBSOLETO_INTERVALOS * gps_get_intervalo_fix_ms();
+}
+
+
+// setters
+#if CONFIG_MONITOR_UMBRALES_AJUSTABLES
+void gps_set_umbral_movimiento(double valor){
+    umbral_movimiento_kmh = valor;
+    ESP_LOGI(TAG,"🟢 Nuevo umbral de movimiento establecido a %.2f km/h", umbral_movimiento_kmh);
+}
+#endif
+
+
+// ===========================================================
+//  REGISTRO COMÚN (modules/gnss_receptor.h)
+// ===========================================================
+gps_data_t *gnss_registro_fix(void) { return &gps; }
+gps_quality_t *gnss_registro_calidad(void) { return &quality; }
+
+GPS_HOT_ATTR void gnss_registrar_trama(bool valida)
+{
+    contador_tramas++;
+    if (!valida) return;
+
+    ts_ultima_trama = xTaskGetTickCount();
+    hubo_trama = true;
+}
+
+// Filtrado y publicación de un fix recién decodificado, igual para los dos receptores
+GPS_HOT_ATTR void gnss_publicar_fix(bool decodificado)
+{
+    contador_rmc++;
+    if (!decodificado || !gps.valid) return;
+
+    ts_ultimo_fix = ts_ultima_trama;
+    hubo_fix = true;
+
+#if CONFIG_GPS_KALMAN
+    if (!kalman_listo) {
+        kalman_init(&kalman_velocidad, CONFIG_GPS_KALMAN_Q_MILI / 1000.0, CONFIG_GPS_KALMAN_R_MILI / 1000.0);
+        kalman_velocidad.estimate = gps.speed_kmh;
+        kalman_listo = true;
+    }
+    gps.speed_kmh = kalman_update(&kalman_velocidad, gps.speed_kmh);
+#endif
+
+    if (gps.speed_kmh < umbral_movimiento_kmh) {
+        gps.speed_kmh = 0.0;
+    }
+
+#if CONFIG_GPS_TASA_ADAPTATIVA
+    // sin esperar: si config_gps está reconfigurando el receptor (y reinicia el
+    // controlador), este fix no cambia de modo
+    if (xSemaphoreTake(receptor_mutex, 0) == pdTRUE) {
+        tasa_modo_t previo = tasa.modo;
+        tasa_modo_t modo = tasa_evaluar(&tasa, gps.speed_kmh, ts_ultimo_fix * portTICK_PERIOD_MS, monitor_velocidad_get_umbral());
+        if (modo != previo) {
+            aplicar_modo_tasa(modo);
+        }
+        xSemaphoreGive(receptor_mutex);
+    }
+#endif
+
+#if CONFIG_CONTOMETRO_LOG_VERBOSE
+#if GNSS_CON_CALIDAD
+    ESP_LOGI(TAG, "HDOP: %.2f | Satélites: %d", quality.hdop, quality.satellites);
+#endif
+    ESP_LOGI(TAG, "Hora: %s | Vel: %.2f km/h | Lat: %.6f | Lon: %.6f | Alt: %.1f m",gps.time, gps.speed_kmh, gps.latitude, gps.longitude, quality.altitude);
+#endif
+
+#if CONFIG_ARRANQUE_TIBIO
+    arranque_guardar_fix(&gps);
+#endif
+
+#if CONFIG_TELEMETRIA_BINARIA
+    telemetria_enviar_fix(&gps, &quality);
+#endif
+#if CONFIG_TRAYECTO
+    trayecto_registrar_fix(&gps);
+#endif
+#if CONFIG_COBERTURA
+    cobertura_registrar_fix(&gps);
+#endif
+
+    // último: quien vea el número nuevo lee la velocidad después de Kalman y umbral
+    portENTER_CRITICAL(&publicado_mux);
+    vel_publicada = gps.speed_kmh;
+    t_publicado_ms = ts_ultimo_fix * portTICK_PERIOD_MS;
+    contador_publicados++;
+    portEXIT_CRITICAL(&publicado_mux);
+}
+
+
+// ===========================================================
+//  TAREA PRINCIPAL DE LECTURA Y PROCESAMIENTO GPS
+// ===========================================================
+void task_gps_read_and_parse(void *pvParameters)
+{
+    uint8_t rx_temp[128];           // La lectura actual del UART (fragmento o trama)
+
+    while (1) {
+
+        int len = uart_read_bytes(GPS_UART_NUM, rx_temp,sizeof(rx_temp) - 1,pdMS_TO_TICKS(50));
+#if CONFIG_NMEA_REENVIO
+        reenvio_nmea_lectura();     // también las vacías: acotan cuándo llegó lo que sigue
+#endif
+#if CONFIG_CAJA_NEGRA
+        // también las vacías: si el GPS se calla, el bloque a medias sale por antigüedad
+        caja_negra_registrar(rx_temp, len > 0 ? (size_t)len : 0);
+#endif
+
+        if (len > 0) {
+            gnss_receptor_procesar(rx_temp, len);
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef GNSS_H
+#define GNSS_H
+
+// Front end GNSS independiente del receptor: UART, tarea lectora, registro de
+// fix común (gps_data_t / gps_quality_t), filtrado, frecuencia, diagnóstico y
+// publicación a los demás módulos. El receptor concreto (L80-R por NMEA/PMTK o
+// u-blox por UBX) se elige en menuconfig e implementa modules/gnss_receptor.h.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "modules/nmea_parser.h"
+
+// ==================== CONFIGURACIÓN DE HARDWARE ====================
+// Valores definidos en menuconfig (main/Kconfig.projbuild)
+#define GPS_UART_NUM      CONFIG_GPS_UART_PORT_NUM
+#define GPS_TX_PIN        CONFIG_GPS_TX_PIN
+#define GPS_RX_PIN        CONFIG_GPS_RX_PIN
+#define GPS_RST_PIN       CONFIG_GPS_RST_PIN
+#define GPS_BUFFER_SIZE   CONFIG_GPS_BUFFER_SIZE
+#define GPS_BAUD_RATE     CONFIG_GPS_BAUD_RATE
+#define GPS_UPDATE_RATE_HZ CONFIG_GPS_UPDATE_RATE_HZ
+
+// El receptor entrega altitud, satélites y HDOP/PDOP
+#define GNSS_CON_CALIDAD  (CONFIG_GPS_PARSE_GGA || CONFIG_GNSS_RECEPTOR_UBX)
+
+// ==================== FUNCIONES PÚBLICAS ====================
+void init_uart_gnss(void);
+
+// Frecuencia y mensajes según menuconfig (al arrancar y al recuperar el receptor)
+void config_gps(void);
+void gnss_set_frecuencia_hz(int hz);
+
+// Tareas
+void task_gps_read_and_parse(void *pvParameters);
+// Configura el receptor fuera del camino de arranque (o restaura la configuración
+// vigente tras un reinicio tibio) y se elimina
+void task_config_gps(void *pvParameters);
+
+
+// SETTERS
+#if CONFIG_MONITOR_UMBRALES_AJUSTABLES
+void gps_set_umbral_movimiento(double v);
+#endif
+
+// GETTERS
+double gps_get_speed_kmh(void);
+const char *gps_get_hora_utc(void);   // "hhmmss.sss" del último fix
+double gps_get_umbral_movimiento(void);
+double gps_get_latitude(void);
+double gps_get_longitude(void);
+double gps_get_altitude(void);
+int gps_get_satellites(void);
+double gps_get_hdop(void);
+bool gps_is_valid(void);
+
+// GETTERS DE DIAGNÓSTICO GPS
+// Tramas recibidas (líneas NMEA o tramas UBX) y soluciones de navegación (RMC o NAV-PVT)
+uint32_t gps_get_contador_tramas(void);
+uint32_t gps_get_contador_rmc(void);
+// Fixes válidos publicados (después de Kalman y umbral de movimiento), con la
+// velocidad y la hora (ms desde el arranque) de ese mismo fix; el número cambia una
+// vez por fix
+uint32_t gps_get_fix_publicado(double *vel, uint32_t *t_ms);
+uint32_t gps_get_intervalo_fix_ms(void);
+// Antigüedad de la última trama válida / del último fix (UINT32_MAX si nunca hubo)
+uint32_t gps_get_edad_trama_ms(void);
+uint32_t gps_get_edad_fix_ms(void);
+bool gps_fix_vigente(void);
+#if CONFIG_GPS_TASA_ADAPTATIVA
+uint32_t gps_get_contador_cambios_tasa(void);
+#endif
+
+#endif // GNSS_H
@@ -0,0 +1,43 @@
+#ifndef GNSS_RECEPTOR_H
+#define GNSS_RECEPTOR_H
+
+// Contrato entre el front end (gnss.c) y el receptor elegido en menuconfig
+// (gps_l80r.c o gps_ubx.c). Se enlaza uno solo.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "modules/nmea_parser.h"
+
+// ===========================================================
+//  LO QUE IMPLEMENTA CADA RECEPTOR
+// ===========================================================
+const char *gnss_receptor_nombre(void);
+
+// Protocolo de salida y mensajes (con esperas; al arrancar y al recuperar)
+void gnss_receptor_configurar(bool con_calidad);
+// false si el receptor no admite la frecuencia
+bool gnss_receptor_set_frecuencia_hz(int hz);
+// Cambio de mensajes en marcha (tasa adaptativa): solo escribe en el UART
+void gnss_receptor_set_mensajes(bool con_calidad);
+// Pide al receptor pasar a estos baudios (el UART local lo cambia el llamador)
+void gnss_receptor_fijar_baudios(int baudios);
+// Provoca una respuesta del receptor (búsqueda de baudios)
+void gnss_receptor_sondear(void);
+
+// Bytes leídos del UART, en el orden en que llegan
+void gnss_receptor_procesar(const uint8_t *datos, size_t largo);
+
+// ===========================================================
+//  LO QUE OFRECE EL FRONT END AL RECEPTOR
+// ===========================================================
+// Registro común: el receptor decodifica directamente sobre él
+gps_data_t *gnss_registro_fix(void);
+gps_quality_t *gnss_registro_calidad(void);
+
+// Cada trama o línea recibida; valida = checksum correcto
+void gnss_registrar_trama(bool valida);
+// Tras decodificar una solución de navegación (RMC / NAV-PVT) en el registro
+void gnss_publicar_fix(bool decodificado);
+
+#endif // GNSS_RECEPTOR_H
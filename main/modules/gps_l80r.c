@@ -1,71 +1,42 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <math.h>
-#include <ctype.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <esp_log.h>
-#include <driver/gpio.h>
 #include <driver/uart.h>
 
 #include "modules/gps_l80r.h"
-#include "screens/display_7seg.h"
+#include "modules/gnss_receptor.h"
+#include "modules/traza.h"
+#if CONFIG_NMEA_REENVIO
+#include "modules/reenvio_nmea.h"
+#endif
 
 static const char *TAG = "L80-R";
 
-static gps_data_t gps; // estructura para almacenar datos GPS
-static gps_quality_t quality;
+static nmea_acumulador_t acumulador;
 
-//parametros de calibracion 
-static double umbral_movimiento_kmh = 5.0;// velocidad minima para considerar movimiento
-
-// ===========================================================
-//  CONTADORES PARA DIAGNÓSTICO DEL GPS
-// ===========================================================
-static uint32_t contador_tramas = 0;   // cuántas líneas NMEA llegan
-static uint32_t contador_rmc = 0;      // cuántas RMC llegan
-
-// ===========================================================
-//  CONFIGURACIÓN UART
-// ===========================================================
-void init_uart_gps_l80r(void)
-{
-    const uart_config_t uart_config = {
-        .baud_rate = 9600,
-        .data_bits = UART_DATA_8_BITS,
-        .parity = UART_PARITY_DISABLE,
-        .stop_bits = UART_STOP_BITS_1,
-        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
-    };
-
-    gpio_config_t reset_cfg = {
-        .pin_bit_mask = (1ULL << GPS_RST_PIN),
-        .mode = GPIO_MODE_OUTPUT,
-        .pull_up_en = GPIO_PULLUP_DISABLE,
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_DISABLE
-    };
-
-    gpio_config(&reset_cfg);
-    gpio_set_level(GPS_RST_PIN, 1);
-
-    uart_param_config(GPS_UART_NUM, &uart_config);
-    uart_set_pin(GPS_UART_NUM, GPS_TX_PIN, GPS_RX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
-    uart_driver_install(GPS_UART_NUM, GPS_BUFFER_SIZE * 2, 0, 0, NULL, 0);
-
-    ESP_LOGI(TAG, "UART GPS inicializado correctamente");
-}
 // ===========================================================
 //  FUNCIONES DE ENVÍO DE COMANDOS AL GPS
 // ===========================================================
-static void gps_send_cmd(const char *cmd)
+// El L80-R descarta en silencio las líneas sin '$' o con checksum inválido:
+// el comando sale entero como $<cmd>*<XOR de cmd>\r\n en una sola escritura
+void gps_send_cmd(const char *cmd)
 {
-    const char *ending = "\r\n";
-    uart_write_bytes(GPS_UART_NUM, cmd, strlen(cmd));
-    uart_write_bytes(GPS_UART_NUM, ending, strlen(ending));
+    char trama[96];
+    uint8_t checksum = 0;
+    for (const char *c = cmd; *c; c++) {
+        checksum ^= (uint8_t)*c;
+    }
+    int largo = snprintf(trama, sizeof(trama), "$%s*%02X\r\n", cmd, checksum);
+    if (largo < 0 || largo >= (int)sizeof(trama)) {
+        ESP_LOGE(TAG, "CMD demasiado largo: %s", cmd);
+        return;
+    }
+    uart_write_bytes(GPS_UART_NUM, trama, largo);
 
-    ESP_LOGI(TAG, "CMD enviado: %s", cmd);
+    ESP_LOGI(TAG, "CMD enviado: %.*s", largo - 2, trama);
 }
 
 // ===========================================================
@@ -91,7 +62,7 @@ void gps_restore_default(void)
 // ===========================================================
 //  AJUSTE DE FRECUENCIA DE ACTUALIZACIÓN
 // ===========================================================
-void gps_set_update_rate_hz(int hz)
+bool gnss_receptor_set_frecuencia_hz(int hz)
 {
     char cmd1[32];
     char cmd2[32];
@@ -117,15 +88,18 @@ void gps_set_update_rate_hz(int hz)
             strcpy(cmd1, "PMTK300,200,0,0,0,0");
             strcpy(cmd2, "PMTK220,200");
             break;
+        case 10:
+            // a 9600 baudios solo entra RMC (~70 B x 10/s); con RMC+GGA se satura el UART
+            strcpy(cmd1, "PMTK300,100,0,0,0,0");
+            strcpy(cmd2, "PMTK220,100");
+            break;
         default:
-            ESP_LOGE(TAG, "❌ Frecuencia no válida. Use 1-5 Hz");
-            return;
+            return false;       // el L80-R admite 1-5 o 10 Hz
     }
 
     gps_send_cmd(cmd1);
     gps_send_cmd(cmd2);
-
-    ESP_LOGI(TAG, "🟢 Frecuencia del GPS configurada a %d Hz", hz);
+    return true;
 }
 
 // ===========================================================
@@ -156,9 +130,44 @@ void gps_enable_only_gga(void)
     ESP_LOGI(TAG, "🟢 GPS enviará solo GPGGA");
 }
 
+// ===========================================================
+//  CONTRATO CON EL FRONT END (modules/gnss_receptor.h)
+// ===========================================================
+const char *gnss_receptor_nombre(void) { return "L80-R"; }
+
+void gnss_receptor_configurar(bool con_calidad)
+{
+    if (con_calidad) {
+        gps_enable_rmc_gga_only();    // Solo RMC + GGA
+    } else {
+        gps_enable_only_rmc();
+    }
+}
+
+// Tasa adaptativa: un solo PMTK314, sin esperas
+void gnss_receptor_set_mensajes(bool con_calidad)
+{
+    if (con_calidad) {
+        gps_send_cmd("PMTK314,0,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0");
+    } else {
+        gps_send_cmd("PMTK314,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0");
+    }
+}
+
+void gnss_receptor_fijar_baudios(int baudios)
+{
+    char cmd[24];
+    snprintf(cmd, sizeof(cmd), "PMTK251,%d", baudios);
+    gps_send_cmd(cmd);
+}
+
+// El L80-R emite NMEA continuamente: no hace falta pedir nada
+void gnss_receptor_sondear(void) { }
+
 // ===========================================================
 //  FUNCIONES DE DEPURACIÓN
 // ===========================================================
+#if CONFIG_GPS_DEBUG_DUMP
 void mostrar_data_NMEA(void)
 {
     uint8_t data[GPS_BUFFER_SIZE];
@@ -187,224 +196,49 @@ void mostrar_data_NMEA_filtrada(void)
         if (gpgga) ESP_LOGI(TAG, "GGA: %s", gpgga);
     }
 }
-
-
-// ===========================================================
-//  CONVERSIÓN NMEA ddmm.mmmm → grados decimales
-// ===========================================================
-static double nmea_to_decimal(double nmea_value, char hemisphere)
-{
-    int degrees = (int)(nmea_value / 100);
-    double minutes = nmea_value - (degrees * 100);
-    double decimal = degrees + (minutes / 60.0);
-    if (hemisphere == 'S' || hemisphere == 'W')
-        decimal *= -1.0;
-    return decimal;
-}
-
-// ===========================================================
-//  VERIFICACIÓN DE CHECKSUM
-// ===========================================================
-bool nmea_verify_checksum(const char *sentence)
-{
-    if (sentence == NULL || *sentence != '$') return false;
-    const char *asterisk = strchr(sentence, '*');
-    if (!asterisk) return false;
-
-    uint8_t checksum = 0;
-    for (const char *p = sentence + 1; p < asterisk; p++)
-        checksum ^= (uint8_t)*p;
-
-    if (strlen(asterisk) < 3) return false;
-    uint8_t received = (uint8_t)strtol(asterisk + 1, NULL, 16);
-    return (checksum == received);
-}
-
-// ===========================================================
-//  PARSER GPRMC (posición, velocidad, rumbo)
-// ===========================================================
-bool gps_parse_gprmc(const char *nmea, gps_data_t *gps)
-{
-    if (strncmp(nmea, "$GPRMC", 6) != 0) return false;
-
-    char buf[128];
-    strncpy(buf, nmea, sizeof(buf));
-    buf[sizeof(buf) - 1] = '\0';
-
-    char *tok = strtok(buf, ",");
-    int field = 0;
-
-    while (tok != NULL) {
-        switch (field) {
-            case 1: strncpy(gps->time, tok, sizeof(gps->time)); break;
-            case 2: gps->valid = (tok[0] == 'A'); break;
-            case 3: gps->latitude = atof(tok); break;
-            case 4: gps->latitude = nmea_to_decimal(gps->latitude, tok[0]); break;
-            case 5: gps->longitude = atof(tok); break;
-            case 6: gps->longitude = nmea_to_decimal(gps->longitude, tok[0]); break;
-            case 7: gps->speed_kmh = atof(tok) * 1.852; break;
-            case 8: gps->course_deg = atof(tok); break;
-            case 9: strncpy(gps->date, tok, sizeof(gps->date)); break;
-        }
-        tok = strtok(NULL, ",");
-        field++;
-    }
-    return true;
-}
-
-// ===========================================================
-//  PARSER GPGGA (precisión, altitud, satélites)
-// ===========================================================
-bool gps_parse_gpgga(const char *nmea, gps_quality_t *q)
-{
-    if (strncmp(nmea, "$GPGGA", 6) != 0) return false;
-
-    char buf[128];
-    strncpy(buf, nmea, sizeof(buf));
-    buf[sizeof(buf) - 1] = '\0';
-
-    char *tok = strtok(buf, ",");
-    int field = 0;
-
-    while (tok != NULL) {
-        switch (field) {
-            case 7: q->satellites = atoi(tok); break;
-            case 8: q->hdop = atof(tok); break;
-            case 9: q->altitude = atof(tok); break;
-        }
-        tok = strtok(NULL, ",");
-        field++;
-    }
-    return true;
-}
-
-// ===========================================================
-//  FILTRO KALMAN UNIDIMENSIONAL
-// ===========================================================
-void kalman_init(kalman_t *kf, double Q, double R)
-{
-    kf->estimate = 0.0;
-    kf->P = 1.0;
-    kf->Q = Q;
-    kf->R = R;
-}
-
-double kalman_update(kalman_t *kf, double measurement)
-{
-    kf->P += kf->Q;
-    double K = kf->P / (kf->P + kf->R);
-    kf->estimate += K * (measurement - kf->estimate);
-    kf->P *= (1.0 - K);
-    return kf->estimate;
-}
-
-// ===========================================================
-//  FUNCIONES DE LECTURA Y ESCRITURA DE DATOS GPS   
-// ===========================================================
-
-// getters
-double gps_get_speed_kmh(void){return gps.speed_kmh;}
-double gps_get_umbral_movimiento(void){return umbral_movimiento_kmh;}
-double gps_get_latitude(void){return gps.latitude;}
-double gps_get_longitude(void){return gps.longitude;}
-double gps_get_altitude(void){return quality.altitude;}
-int gps_get_satellites(void){return quality.satellites;}
-double gps_get_hdop(void){return quality.hdop;}
-bool gps_is_valid(void){return gps.valid;}
-
-// ===========================================================
-// GETTERS DEL DIAGNÓSTICO GPS
-// ===========================================================
-uint32_t gps_get_contador_tramas(void) { return contador_tramas; }
-uint32_t gps_get_contador_rmc(void) { return contador_rmc; }
-
-
-// setters
-void gps_set_umbral_movimiento(double valor){
-    umbral_movimiento_kmh = valor;
-    ESP_LOGI(TAG,"🟢 Nuevo umbral de movimiento establecido a %.2f km/h", umbral_movimiento_kmh);
-}
+#endif // CONFIG_GPS_DEBUG_DUMP
 
 
 // ===========================================================
 //  analiza una línea completa y actualiza los datos del GPS.
 // ===========================================================
 
-static void procesar_sentencia_nmea(const char *linea){
-
-    contador_tramas++;
+GPS_HOT_ATTR void procesar_sentencia_nmea(char *linea){
 
-    if (!nmea_verify_checksum(linea)) {
+    bool valida = nmea_verify_checksum(linea);
+    gnss_registrar_trama(valida);
+    if (!valida) {
         return;
     }
 
+#if CONFIG_GPS_PARSE_GGA
     if (strncmp(linea, "$GPGGA", 6) == 0) {
-        gps_parse_gpgga(linea, &quality);
-        return;
-    }
-
+        gps_parse_gpgga(linea, gnss_registro_calidad());
+    } else
+#endif
     if (strncmp(linea, "$GPRMC", 6) == 0) {
-        contador_rmc++;
-        if (gps_parse_gprmc(linea, &gps) && gps.valid) {
-
-            if (gps.speed_kmh < umbral_movimiento_kmh) {
-                gps.speed_kmh = 0.0;
-            }
-
-            ESP_LOGI(TAG, "HDOP: %.2f | Satélites: %d", quality.hdop, quality.satellites);
-            ESP_LOGI(TAG, "Hora: %s | Vel: %.2f km/h | Lat: %.6f | Lon: %.6f | Alt: %.1f m",gps.time, gps.speed_kmh, gps.latitude, gps.longitude, quality.altitude);
-
-        }
+        gnss_publicar_fix(gps_parse_gprmc(linea, gnss_registro_fix()));
     }
+
+#if CONFIG_NMEA_REENVIO
+    // después del parseo local para no demorarlo; la línea sale sin copiarla
+    // (reenvio_nmea_linea escribe "\r\n" en el buffer del acumulador y lo restaura)
+    reenvio_nmea_linea(linea);
+#endif
 }
 
 
 // ===========================================================
-//  TAREA PRINCIPAL DE LECTURA Y PROCESAMIENTO GPS
+//  BYTES DEL UART → LÍNEAS NMEA
 // ===========================================================
-void task_gps_read_and_parse(void *pvParameters)
+static void por_linea(char *linea, void *ctx)
 {
-    uint8_t rx_temp[128];           // La lectura actual del UART (fragmento o sentencia)
-    static char nmea_buffer[2048]; // Acumulador de toda la data incompleta y completa
-    static size_t nmea_len = 0;    //Cuántos bytes válidos hay en nmea_buffer
-
-    while (1) {
-
-        int len = uart_read_bytes(GPS_UART_NUM, rx_temp,sizeof(rx_temp) - 1,pdMS_TO_TICKS(50));
-
-        if (len > 0) {
-
-            if (nmea_len + len >= sizeof(nmea_buffer) - 1) {
-                nmea_len = 0; // prevenir overflow
-            }
-
-            memcpy(&nmea_buffer[nmea_len], rx_temp, len);
-            nmea_len += len;
-            nmea_buffer[nmea_len] = '\0';
-
-            // Procesar líneas completas
-            char *inicio = nmea_buffer;
-            char *nl; //Índice donde termina la sentencia (\n)
-
-            while ((nl = strchr(inicio, '\n')) != NULL) {
-
-                *nl = 0;
-
-                if (nl > inicio && *(nl-1) == '\r') {
-                    *(nl-1) = 0;
-                }
-
-                procesar_sentencia_nmea(inicio);
-
-                inicio = nl + 1;
-            }
-
-            // Compactar el buffer con el resto incompleto
-            size_t resto = strlen(inicio);
-            memmove(nmea_buffer, inicio, resto + 1);
-            nmea_len = resto;
-        }
+    TRAZA_INICIO(TRAZA_PARSE);
+    procesar_sentencia_nmea(linea);
+    TRAZA_FIN(TRAZA_PARSE);
+}
 
-        vTaskDelay(pdMS_TO_TICKS(5));
-    }
+void gnss_receptor_procesar(const uint8_t *datos, size_t largo)
+{
+    nmea_acumular(&acumulador, datos, largo, por_linea, NULL);
 }
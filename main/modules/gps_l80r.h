@@ -1,83 +1,28 @@
 #ifndef GPS_L80R_H
 #define GPS_L80R_H
 
+// Receptor Quectel L80-R: NMEA de salida y comandos PMTK. Implementa
+// modules/gnss_receptor.h; los getters del fix están en modules/gnss.h.
+
 #include <stdbool.h>
 #include <stdint.h>
-
-// ==================== CONFIGURACIÓN DE HARDWARE ====================
-#define GPS_UART_NUM      UART_NUM_1
-#define GPS_TX_PIN        GPIO_NUM_25
-#define GPS_RX_PIN        GPIO_NUM_26
-#define GPS_RST_PIN       GPIO_NUM_23
-#define GPS_BUFFER_SIZE   1024
-
-// ==================== ESTRUCTURAS DE DATOS ====================
-
-// Datos extraídos de la trama GPRMC
-typedef struct {
-    double latitude;        // Latitud en grados decimales
-    double longitude;       // Longitud en grados decimales
-    double speed_kmh;       // Velocidad (km/h)
-    double course_deg;      // Rumbo (grados)
-    char time[16];          // Hora UTC (hhmmss)
-    char date[8];           // Fecha (ddmmyy)
-    bool valid;             // True si el fix es válido ('A')
-} gps_data_t;
-
-// Datos extraídos de la trama GPGGA
-typedef struct {
-    double altitude;        // Altitud sobre el nivel del mar (m)
-    int satellites;         // Satélites usados
-    double hdop;            // Precisión horizontal
-} gps_quality_t;
-
-// Filtro Kalman unidimensional (para velocidad)
-typedef struct {
-    double estimate;
-    double P;
-    double Q;
-    double R;
-} kalman_t;
+#include "sdkconfig.h"
+#include "modules/gnss.h"
 
 // ==================== FUNCIONES PÚBLICAS ====================
-void init_uart_gps_l80r(void);
+#if CONFIG_GPS_DEBUG_DUMP
 void mostrar_data_NMEA(void);
 void mostrar_data_NMEA_filtrada(void);
+#endif
 
-// Parsers
-bool gps_parse_gprmc(const char *nmea_sentence, gps_data_t *gps);
-bool gps_parse_gpgga(const char *nmea_sentence, gps_quality_t *quality);
-
-// Checksum
-bool nmea_verify_checksum(const char *sentence);
-
-// Kalman
-void kalman_init(kalman_t *kf, double Q, double R);
-double kalman_update(kalman_t *kf, double measurement);
-
-// Tareas
-void task_gps_read_and_parse(void *pvParameters);
-
-
-// SETTERS
-void gps_set_umbral_movimiento(double v);
-
-// GETTERS
-double gps_get_speed_kmh(void);
-double gps_get_umbral_movimiento(void);
-double gps_get_latitude(void);
-double gps_get_longitude(void);
-double gps_get_altitude(void);
-int gps_get_satellites(void);
-double gps_get_hdop(void);
-bool gps_is_valid(void);
+// Procesa una línea NMEA completa (sin \r\n) y actualiza el registro de fix. Con el
+// reenvío activo usa temporalmente los 2 bytes que siguen al NUL (ver reenvio_nmea.h)
+void procesar_sentencia_nmea(char *linea);
 
-// GETTERS DE DIAGNÓSTICO GPS
-uint32_t gps_get_contador_tramas(void);
-uint32_t gps_get_contador_rmc(void);
+// Envía un comando PMTK: se pasa sin '$' ni checksum y sale con los dos agregados
+void gps_send_cmd(const char *cmd);
 
 // Configuración de mensajes NMEA
-void gps_set_update_rate_hz(int hz);
 void gps_enable_rmc_gga_only(void);
 void gps_enable_only_rmc(void);
 void gps_enable_only_gga(void);
@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_log.h>
+#include <driver/gpio.h>
+#include <driver/uart.h>
+
+#include "modules/gps_supervisor.h"
+#include "modules/gnss.h"
+#include "modules/gnss_receptor.h"
+
+static const char *TAG = "GPS_SUPERVISOR";
+
+static const char *nombre_paso[GPS_PASO_CANTIDAD] = {
+    "ninguno", "flush UART", "reconfigurar", "reset HW", "detectar baudios"
+};
+
+// Baudios que se prueban al buscar el receptor (el configurado va primero)
+static const int baudios_candidatos[] = { GPS_BAUD_RATE, 9600, 115200, 57600, 38400, 19200, 4800 };
+
+// ===========================================================
+//  ESTADÍSTICAS
+// ===========================================================
+static uint32_t fallas = 0;
+static uint32_t recuperaciones[GPS_PASO_CANTIDAD] = {0};
+static uint32_t ultima_recuperacion_ms = 0;
+static uint32_t peor_recuperacion_ms = 0;
+
+uint32_t gps_supervisor_get_fallas(void) { return fallas; }
+uint32_t gps_supervisor_get_recuperaciones(gps_paso_recuperacion_t paso) { return recuperaciones[paso]; }
+uint32_t gps_supervisor_get_ultima_recuperacion_ms(void) { return ultima_recuperacion_ms; }
+uint32_t gps_supervisor_get_peor_recuperacion_ms(void) { return peor_recuperacion_ms; }
+
+// ===========================================================
+//  ESPERAR TRAMAS NUEVAS
+// ===========================================================
+// true si llega una trama con checksum válido antes de timeout_ms
+static bool esperar_trama(uint32_t timeout_ms)
+{
+    TickType_t inicio = xTaskGetTickCount();
+    while ((xTaskGetTickCount() - inicio) * portTICK_PERIOD_MS < timeout_ms) {
+        vTaskDelay(pdMS_TO_TICKS(50));
+        if (gps_get_edad_trama_ms() < (xTaskGetTickCount() - inicio) * portTICK_PERIOD_MS)
+            return true;
+    }
+    return false;
+}
+
+// ===========================================================
+//  PASOS DE RECUPERACIÓN
+// ===========================================================
+static void pulso_reset(void)
+{
+    gpio_set_level(GPS_RST_PIN, 0);     // RESET del receptor es activo en bajo (L80-R y u-blox)
+    vTaskDelay(pdMS_TO_TICKS(100));
+    gpio_set_level(GPS_RST_PIN, 1);
+    vTaskDelay(pdMS_TO_TICKS(1000));    // arranque del receptor
+}
+
+static void detectar_baudios(void)
+{
+    for (size_t i = 0; i < sizeof(baudios_candidatos) / sizeof(baudios_candidatos[0]); i++) {
+        int baudios = baudios_candidatos[i];
+        uart_set_baudrate(GPS_UART_NUM, baudios);
+        uart_flush_input(GPS_UART_NUM);
+        gnss_receptor_sondear();
+
+        if (!esperar_trama(1500)) continue;
+
+        ESP_LOGW(TAG, "Receptor encontrado a %d baudios", baudios);
+        if (baudios != GPS_BAUD_RATE) {
+            // devolver el receptor a los baudios configurados
+            gnss_receptor_fijar_baudios(GPS_BAUD_RATE);
+            uart_wait_tx_done(GPS_UART_NUM, pdMS_TO_TICKS(100));
+            vTaskDelay(pdMS_TO_TICKS(200));
+            uart_set_baudrate(GPS_UART_NUM, GPS_BAUD_RATE);
+        }
+        config_gps();
+        return;
+    }
+
+    ESP_LOGE(TAG, "Sin respuesta en ningún baudio");
+    uart_set_baudrate(GPS_UART_NUM, GPS_BAUD_RATE);
+}
+
+static void ejecutar_paso(gps_paso_recuperacion_t paso)
+{
+    ESP_LOGW(TAG, "🔧 Recuperación GPS: paso '%s'", nombre_paso[paso]);
+
+    switch (paso) {
+        case GPS_PASO_FLUSH_UART:
+            uart_flush_input(GPS_UART_NUM);
+            break;
+        case GPS_PASO_RECONFIGURAR:
+            config_gps();
+            break;
+        case GPS_PASO_RESET_HW:
+            pulso_reset();
+            config_gps();
+            break;
+        case GPS_PASO_DETECTAR_BAUDIOS:
+            detectar_baudios();
+            break;
+        default:
+            break;
+    }
+}
+
+// ===========================================================
+//  TAREA SUPERVISORA
+// ===========================================================
+void task_gps_supervisor(void *pvParameters)
+{
+    gps_paso_recuperacion_t paso = GPS_PASO_NINGUNO;
+    TickType_t ts_falla = 0;
+    TickType_t ts_ultima_accion = xTaskGetTickCount();
+
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+
+        TickType_t ahora = xTaskGetTickCount();
+        uint32_t edad_trama = gps_get_edad_trama_ms();
+        uint32_t desde_accion = (ahora - ts_ultima_accion) * portTICK_PERIOD_MS;
+        uint32_t sin_tramas_ms = (edad_trama < desde_accion) ? edad_trama : desde_accion;
+
+        if (sin_tramas_ms <= CONFIG_GPS_SUPERVISOR_ESPERA_MS) {
+            if (paso != GPS_PASO_NINGUNO && edad_trama < desde_accion) {
+                // volvieron las tramas después de un paso de recuperación
+                ultima_recuperacion_ms = (ahora - ts_falla) * portTICK_PERIOD_MS;
+                if (ultima_recuperacion_ms > peor_recuperacion_ms)
+                    peor_recuperacion_ms = ultima_recuperacion_ms;
+                recuperaciones[paso]++;
+
+                ESP_LOGW(TAG, "🟢 GPS recuperado en %lu ms (paso '%s', fallas %lu)",
+                         (unsigned long)ultima_recuperacion_ms, nombre_paso[paso], (unsigned long)fallas);
+                paso = GPS_PASO_NINGUNO;
+            }
+            continue;
+        }
+
+        if (paso == GPS_PASO_NINGUNO) {
+            fallas++;
+            ts_falla = ahora - pdMS_TO_TICKS(sin_tramas_ms);
+            ESP_LOGW(TAG, "🛑 Sin tramas GPS hace %lu ms", (unsigned long)sin_tramas_ms);
+        }
+
+        // escalar; tras el último paso se espera antes de recomenzar el ciclo
+        if (paso == GPS_PASO_DETECTAR_BAUDIOS) {
+            ESP_LOGE(TAG, "Recuperación sin éxito, reintento en %d s", CONFIG_GPS_SUPERVISOR_REINTENTO_S);
+            vTaskDelay(pdMS_TO_TICKS(CONFIG_GPS_SUPERVISOR_REINTENTO_S * 1000));
+            paso = GPS_PASO_NINGUNO;
+        }
+        paso++;
+
+        ejecutar_paso(paso);
+        ts_ultima_accion = xTaskGetTickCount();
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef GPS_SUPERVISOR_H
+#define GPS_SUPERVISOR_H
+
+#include <stdint.h>
+
+// Pasos de recuperación, en orden de escalamiento
+typedef enum {
+    GPS_PASO_NINGUNO = 0,
+    GPS_PASO_FLUSH_UART,        // descartar lo acumulado en el buffer RX
+    GPS_PASO_RECONFIGURAR,      // reenviar frecuencia y tramas (PMTK220/300/314)
+    GPS_PASO_RESET_HW,          // pulso en GPS_RST_PIN y reconfigurar
+    GPS_PASO_DETECTAR_BAUDIOS,  // probar baudios hasta recibir tramas válidas
+    GPS_PASO_CANTIDAD
+} gps_paso_recuperacion_t;
+
+// Vigila la llegada de tramas y recupera el receptor si se detiene
+void task_gps_supervisor(void *pvParameters);
+
+// GETTERS DE DIAGNÓSTICO
+uint32_t gps_supervisor_get_fallas(void);
+uint32_t gps_supervisor_get_recuperaciones(gps_paso_recuperacion_t paso);
+uint32_t gps_supervisor_get_ultima_recuperacion_ms(void);
+uint32_t gps_supervisor_get_peor_recuperacion_ms(void);
+
+#endif // GPS_SUPERVISOR_H
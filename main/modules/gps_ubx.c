@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_log.h>
+#include <driver/uart.h>
+
+#include "modules/gps_ubx.h"
+#include "modules/gnss_receptor.h"
+#include "modules/ubx_parser.h"
+#include "modules/traza.h"
+
+static const char *TAG = "UBX";
+
+// Baudios de un receptor de fábrica (o con la configuración borrada)
+#define UBX_BAUDIOS_FABRICA 9600
+
+static ubx_framer_t framer;
+static int frecuencia_hz = 1;      // última CFG-RATE pedida (se repite al configurar)
+
+// ===========================================================
+//  ENVÍO DE MENSAJES
+// ===========================================================
+static inline void escribir_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void escribir_u32(uint8_t *p, uint32_t v)
+{
+    escribir_u16(p, (uint16_t)v);
+    escribir_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+void ubx_enviar(uint8_t clase, uint8_t id, const void *payload, uint16_t largo)
+{
+    uint8_t trama[32 + UBX_SOBRECARGA];
+    if (largo > 32) return;
+
+    size_t n = ubx_armar_trama(clase, id, payload, largo, trama);
+    uart_write_bytes(GPS_UART_NUM, trama, n);
+
+    ESP_LOGI(TAG, "CMD enviado: clase 0x%02x id 0x%02x (%u bytes)", clase, id, (unsigned)n);
+}
+
+// CFG-PRT del UART1: 8N1, entrada UBX+NMEA, salida solo UBX
+static void enviar_cfg_prt(int baudios)
+{
+    uint8_t p[20] = {0};
+    p[0] = UBX_PUERTO_UART1;
+    escribir_u32(&p[4], 0x000008D0);        // 8 bits, sin paridad, 1 stop
+    escribir_u32(&p[8], (uint32_t)baudios);
+    escribir_u16(&p[12], 0x0003);           // inProtoMask: UBX | NMEA
+    escribir_u16(&p[14], 0x0001);           // outProtoMask: UBX
+    ubx_enviar(UBX_CLASE_CFG, UBX_ID_CFG_PRT, p, sizeof(p));
+}
+
+static void enviar_cfg_rate(int hz)
+{
+    uint8_t p[6];
+    escribir_u16(&p[0], (uint16_t)(1000 / hz));     // measRate (ms)
+    escribir_u16(&p[2], 1);                         // navRate: una solución por medición
+    escribir_u16(&p[4], 1);                         // timeRef: hora GPS
+    ubx_enviar(UBX_CLASE_CFG, UBX_ID_CFG_RATE, p, sizeof(p));
+}
+
+// CFG-CFG: guarda puerto, mensajes y navegación (incluye CFG-RATE) en BBR y flash,
+// así el pulso de RESET de config_gps y los arranques siguientes no los pierden
+static void guardar_configuracion(void)
+{
+    uint8_t p[13] = {0};
+    escribir_u32(&p[4], 0x0000000B);        // saveMask: ioPort | msgConf | navConf
+    p[12] = 0x17;                           // deviceMask: BBR, flash, EEPROM, SPI flash
+    ubx_enviar(UBX_CLASE_CFG, UBX_ID_CFG_CFG, p, sizeof(p));
+}
+
+// ===========================================================
+//  CONTRATO CON EL FRONT END (modules/gnss_receptor.h)
+// ===========================================================
+const char *gnss_receptor_nombre(void) { return "u-blox"; }
+
+// NAV-PVT ya trae altitud, satélites y PDOP: con_calidad no cambia nada
+void gnss_receptor_configurar(bool con_calidad)
+{
+#if GPS_BAUD_RATE != UBX_BAUDIOS_FABRICA
+    // Un receptor sin configuración guardada escucha a 9600: pasarlo a GPS_BAUD_RATE
+    // desde ahí. Si ya estaba a GPS_BAUD_RATE esta trama se pierde y vale la siguiente.
+    uart_set_baudrate(GPS_UART_NUM, UBX_BAUDIOS_FABRICA);
+    enviar_cfg_prt(GPS_BAUD_RATE);
+    uart_wait_tx_done(GPS_UART_NUM, pdMS_TO_TICKS(100));
+    vTaskDelay(pdMS_TO_TICKS(100));
+    uart_set_baudrate(GPS_UART_NUM, GPS_BAUD_RATE);
+#endif
+    enviar_cfg_prt(GPS_BAUD_RATE);
+    uart_wait_tx_done(GPS_UART_NUM, pdMS_TO_TICKS(100));
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    // la CFG-RATE de config_gps pudo salir antes de que el receptor cambiara de baudios
+    enviar_cfg_rate(frecuencia_hz);
+
+    const uint8_t msg[3] = { UBX_CLASE_NAV, UBX_ID_NAV_PVT, 1 };    // uno por época
+    ubx_enviar(UBX_CLASE_CFG, UBX_ID_CFG_MSG, msg, sizeof(msg));
+
+    guardar_configuracion();
+
+    ESP_LOGI(TAG, "🟢 Receptor enviará solo UBX NAV-PVT (configuración guardada)");
+}
+
+bool gnss_receptor_set_frecuencia_hz(int hz)
+{
+    if (hz < 1 || hz > 10) return false;
+
+    enviar_cfg_rate(hz);
+    frecuencia_hz = hz;
+    return true;
+}
+
+void gnss_receptor_set_mensajes(bool con_calidad) { }
+
+void gnss_receptor_fijar_baudios(int baudios)
+{
+    enviar_cfg_prt(baudios);
+}
+
+// Un poll de CFG-PRT vacío responde con la configuración del puerto actual
+void gnss_receptor_sondear(void)
+{
+    ubx_enviar(UBX_CLASE_CFG, UBX_ID_CFG_PRT, NULL, 0);
+}
+
+// ===========================================================
+//  BYTES DEL UART → TRAMAS UBX
+// ===========================================================
+void gnss_receptor_procesar(const uint8_t *datos, size_t largo)
+{
+    while (largo > 0) {
+        size_t usados;
+        ubx_resultado_t r = ubx_framer_alimentar(&framer, datos, largo, &usados);
+        datos += usados;
+        largo -= usados;
+        if (r == UBX_SIN_TRAMA) continue;
+
+        gnss_registrar_trama(r == UBX_TRAMA_OK);
+        if (r == UBX_TRAMA_OK && framer.clase == UBX_CLASE_NAV && framer.id == UBX_ID_NAV_PVT) {
+            TRAZA_INICIO(TRAZA_PARSE);
+            gnss_publicar_fix(ubx_nav_pvt_a_fix(framer.payload, framer.largo,
+                                                gnss_registro_fix(), gnss_registro_calidad()));
+            TRAZA_FIN(TRAZA_PARSE);
+        }
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef GPS_UBX_H
+#define GPS_UBX_H
+
+// Receptor u-blox (serie 8) por protocolo UBX: un NAV-PVT por época con
+// posición, velocidad, precisión y hora. Implementa modules/gnss_receptor.h;
+// los getters del fix están en modules/gnss.h.
+
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "modules/gnss.h"
+
+// Puerto del receptor conectado al ESP32 (UART1 del módulo u-blox)
+#define UBX_PUERTO_UART1 1
+
+// Envía un mensaje UBX (arma sync, largo y checksum)
+void ubx_enviar(uint8_t clase, uint8_t id, const void *payload, uint16_t largo);
+
+#endif // GPS_UBX_H
@@ -0,0 +1,23 @@
+#ifndef MONITOR_EVENTOS_H
+#define MONITOR_EVENTOS_H
+
+// Máquina de estados del monitor de velocidad, sin FreeRTOS ni NVS: la usa
+// task_monitor_velocidad y la reproduce host/auditor_nmea sobre logs crudos.
+
+#include <stdbool.h>
+
+typedef struct {
+    bool sobre_umbral;
+} monitor_eventos_t;
+
+// Evalúa una velocidad con fix válido. Devuelve true si inicia un evento
+// (cruce hacia arriba del umbral); seguir sobre el umbral no cuenta de nuevo.
+static inline bool monitor_eventos_evaluar(monitor_eventos_t *m, double vel, double umbral)
+{
+    bool sobre = vel > umbral;
+    bool evento = sobre && !m->sobre_umbral;
+    m->sobre_umbral = sobre;
+    return evento;
+}
+
+#endif // MONITOR_EVENTOS_H
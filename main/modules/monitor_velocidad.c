@@ -3,34 +3,63 @@
 #include <esp_log.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 
 #include "nvs_flash.h"
 #include "nvs.h"
 
 #include "monitor_velocidad.h"
-#include "gps_l80r.h"
+#include "modules/monitor_eventos.h"
+#include "modules/gnss.h"
 #include "screens/display_7seg.h"
 #include "drivers/buzzer_driver.h"
+#include "modules/traza.h"
+#include "modules/arranque.h"
+#if CONFIG_MONITOR_REGLAS
+#include <esp_partition.h>
+#include "modules/reglas.h"
+#endif
 
 static const char *TAG = "MONITOR_VEL";
 
 // ===========================================================
 //  PARÁMETROS CONFIGURABLES
 // ===========================================================
-static double umbral_velocidad = 30.0;   // km/h
+#if CONFIG_MONITOR_UMBRALES_AJUSTABLES
+static double umbral_velocidad = CONFIG_MONITOR_UMBRAL_VELOCIDAD_KMH;   // km/h
+#else
+#define umbral_velocidad ((double)CONFIG_MONITOR_UMBRAL_VELOCIDAD_KMH)
+#endif
 
 // ===========================================================
 //  VARIABLES INTERNAS
 // ===========================================================
 static uint16_t contador_eventos = 0;
-static bool estaba_sobre_umbral = false;
+static monitor_eventos_t estado_eventos = { .sobre_umbral = false };
 static bool ultimo_fix_valido = false;
 
+#if CONFIG_MONITOR_REGLAS
+#define REGLAS_SUBTIPO_PARTICION 0x41
+
+static reglas_tabla_t tabla_reglas;
+static reglas_estado_t estado_reglas;
+static uint32_t firma_reglas = 0;       // CRC de la tabla cargada: asocia los contadores en NVS
+static uint32_t ultimo_fix_evaluado = 0;
+
+// Contadores por regla en NVS, válidos solo para la tabla con la que se contaron
+typedef struct {
+    uint32_t firma;
+    uint32_t contador[REGLAS_MAX];
+} reglas_contadores_nvs_t;
+#endif
+
 // ===========================================================
 //  NVS: GUARDAR CONTADOR COMO uint32_t
 // ===========================================================
 static void guardar_contador_eventos(uint16_t valor)
 {
+    TRAZA_INICIO(TRAZA_NVS);
     nvs_handle_t handle;
     esp_err_t err = nvs_open("almacen", NVS_READWRITE, &handle);
 
@@ -44,6 +73,7 @@ static void guardar_contador_eventos(uint16_t valor)
     } else {
         ESP_LOGE(TAG, "Error al abrir NVS para guardar contador");
     }
+    TRAZA_FIN(TRAZA_NVS);
 }
 
 // ===========================================================
@@ -71,6 +101,76 @@ static void leer_contador_guardado_en_nvs(void)
     }
 }
 
+#if CONFIG_MONITOR_REGLAS
+// ===========================================================
+//  NVS: CONTADORES POR REGLA
+// ===========================================================
+static void guardar_contadores_reglas(void)
+{
+    TRAZA_INICIO(TRAZA_NVS);
+    nvs_handle_t handle;
+    if (nvs_open("almacen", NVS_READWRITE, &handle) == ESP_OK) {
+        reglas_contadores_nvs_t c = { .firma = firma_reglas };
+        memcpy(c.contador, estado_reglas.contador, sizeof(c.contador));
+        nvs_set_blob(handle, "reglas_cnt", &c, sizeof(c));
+        nvs_commit(handle);
+        nvs_close(handle);
+    } else {
+        ESP_LOGE(TAG, "Error al abrir NVS para guardar contadores de reglas");
+    }
+    TRAZA_FIN(TRAZA_NVS);
+}
+
+static void leer_contadores_reglas(void)
+{
+    nvs_handle_t handle;
+    if (nvs_open("almacen", NVS_READONLY, &handle) != ESP_OK) return;
+
+    reglas_contadores_nvs_t c;
+    size_t largo = sizeof(c);
+    if (nvs_get_blob(handle, "reglas_cnt", &c, &largo) == ESP_OK && largo == sizeof(c) && c.firma == firma_reglas) {
+        memcpy(estado_reglas.contador, c.contador, sizeof(c.contador));
+    } else {
+        ESP_LOGW(TAG, "Contadores por regla de otra tabla o inexistentes, comenzando en 0");
+    }
+    nvs_close(handle);
+}
+
+// ===========================================================
+//  CARGA DE LA TABLA DE REGLAS
+// ===========================================================
+// Primero la tabla compilada en la partición "reglas" (host/compilar_reglas);
+// si no hay, el texto de menuconfig; si está vacío, el umbral de siempre.
+static void cargar_reglas(void)
+{
+    const esp_partition_t *p = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, REGLAS_SUBTIPO_PARTICION, "reglas");
+    if (p != NULL && esp_partition_read(p, 0, &tabla_reglas, sizeof(tabla_reglas)) == ESP_OK &&
+        reglas_tabla_valida(&tabla_reglas)) {
+        ESP_LOGI(TAG, "📋 %u reglas desde la partición 'reglas'", tabla_reglas.n);
+    } else {
+        char umbral[48];
+        char error[80];
+        snprintf(umbral, sizeof(umbral), "exceso: vel > %d alerta bip continua", CONFIG_MONITOR_UMBRAL_VELOCIDAD_KMH);
+        const char *texto = CONFIG_MONITOR_REGLAS_TEXTO[0] ? CONFIG_MONITOR_REGLAS_TEXTO : umbral;
+
+        if (reglas_compilar(texto, CONFIG_MONITOR_REGLAS_HUSO_MIN, &tabla_reglas, error, sizeof(error)) != 0) {
+            ESP_LOGE(TAG, "Reglas de menuconfig inválidas (%s): se usa solo el umbral", error);
+            reglas_compilar(umbral, CONFIG_MONITOR_REGLAS_HUSO_MIN, &tabla_reglas, NULL, 0);
+        }
+        ESP_LOGI(TAG, "📋 %u reglas desde menuconfig", tabla_reglas.n);
+    }
+
+    for (int i = 0; i < tabla_reglas.n; i++) {
+        char desc[128];
+        reglas_describir(&tabla_reglas, i, desc, sizeof(desc));
+        ESP_LOGI(TAG, "   #%d %s", i, desc);
+    }
+
+    firma_reglas = tabla_reglas.crc;
+    reglas_estado_init(&estado_reglas);
+}
+#endif
+
 // ===========================================================
 //  GETTERS Y SETTERS
 // ===========================================================
@@ -86,15 +186,29 @@ bool monitor_velocidad_ultimo_fix_valido(void) {
     return ultimo_fix_valido;
 }
 
+#if CONFIG_MONITOR_UMBRALES_AJUSTABLES
 void monitor_velocidad_set_umbral(double nuevo_umbral) {
     umbral_velocidad = nuevo_umbral;
+#if CONFIG_MONITOR_REGLAS
+    // la regla 0 hace de umbral principal si compara velocidad hacia arriba
+    if (tabla_reglas.n > 0 && tabla_reglas.variable[0] == REGLA_VEL && tabla_reglas.signo[0] > 0)
+        reglas_fijar_umbral(&tabla_reglas, 0, (float)nuevo_umbral);
+#endif
     ESP_LOGI(TAG,"🟢 Nuevo umbral de velocidad establecido a %.2f km/h", umbral_velocidad);
 }
+#endif
 
 void monitor_velocidad_reset_contador(void)
 {
     contador_eventos = 0;
     guardar_contador_eventos(0);
+#if CONFIG_MONITOR_REGLAS
+    memset(estado_reglas.contador, 0, sizeof(estado_reglas.contador));
+    guardar_contadores_reglas();
+#endif
+#if CONFIG_ARRANQUE_TIBIO
+    arranque_guardar_monitor(contador_eventos, estado_eventos.sobre_umbral);
+#endif
 
     ESP_LOGW(TAG, "🟢 Contador de eventos reiniciado a 0");
     display_set_number(0);
@@ -119,9 +233,11 @@ static void alerta_bi_bi(void)
         if (ahora - ts_ultimo_bip > pdMS_TO_TICKS(180)) {
 
             // beep corto
+            TRAZA_INICIO(TRAZA_BUZZER);
             buzzer_on();
             vTaskDelay(pdMS_TO_TICKS(70));
             buzzer_off();
+            TRAZA_FIN(TRAZA_BUZZER);
 
             contador_bips++;
             ts_ultimo_bip = xTaskGetTickCount();
@@ -136,6 +252,73 @@ static void alerta_bi_bi(void)
     }
 }
 
+#if CONFIG_MONITOR_REGLAS
+// ===========================================================
+//  PATRÓN DE ALERTA AL INICIAR UN EVENTO DE REGLA
+// ===========================================================
+static void alerta_evento(uint8_t alerta)
+{
+    static const struct { uint8_t bips; uint16_t ms; } patrones[] = {
+        [REGLA_ALERTA_NINGUNA] = { 0, 0 },
+        [REGLA_ALERTA_BIP]     = { 1, 120 },
+        [REGLA_ALERTA_DOBLE]   = { 2, 70 },
+        [REGLA_ALERTA_LARGO]   = { 1, 600 },
+    };
+    if (alerta >= sizeof(patrones) / sizeof(patrones[0])) return;
+
+    TRAZA_INICIO(TRAZA_BUZZER);
+    for (int i = 0; i < patrones[alerta].bips; i++) {
+        if (i > 0) vTaskDelay(pdMS_TO_TICKS(100));
+        buzzer_on();
+        vTaskDelay(pdMS_TO_TICKS(patrones[alerta].ms));
+        buzzer_off();
+    }
+    TRAZA_FIN(TRAZA_BUZZER);
+}
+
+// ===========================================================
+//  EVALUACIÓN DE REGLAS (una vez por fix)
+// ===========================================================
+static void evaluar_reglas(double vel, uint32_t t_ms)
+{
+    reglas_entrada_t in = {
+        .vel_kmh = (float)vel,
+        .t_ms = t_ms,
+        .minuto_dia = reglas_minuto_dia(gps_get_hora_utc(), tabla_reglas.huso_min),
+    };
+    uint32_t activas_antes = estado_reglas.activas;
+    uint32_t eventos = reglas_evaluar(&tabla_reglas, &estado_reglas, &in);
+
+    if (eventos) {
+        for (uint32_t m = eventos; m; m &= m - 1) {
+            int i = __builtin_ctz(m);
+            contador_eventos++;
+            ESP_LOGI(TAG, "🚀 Evento #%u: regla %s (#%lu, vel=%.2f)", contador_eventos, tabla_reglas.nombre[i],
+                     (unsigned long)estado_reglas.contador[i], vel);
+        }
+#if CONFIG_ARRANQUE_TIBIO
+        // antes del commit a NVS: un reset durante la escritura no pierde el evento
+        arranque_guardar_reglas(estado_reglas.activas);
+        arranque_guardar_monitor(contador_eventos, estado_reglas.activas != 0);
+#endif
+        guardar_contador_eventos(contador_eventos);
+        guardar_contadores_reglas();
+        display_set_number(contador_eventos);
+
+        // si empiezan varias a la vez suena la de menor índice
+        alerta_evento(tabla_reglas.alerta[__builtin_ctz(eventos)]);
+    }
+#if CONFIG_ARRANQUE_TIBIO
+    else if (estado_reglas.activas != activas_antes) {
+        arranque_guardar_reglas(estado_reglas.activas);
+        arranque_guardar_monitor(contador_eventos, estado_reglas.activas != 0);
+    }
+#else
+    (void)activas_antes;
+#endif
+}
+#endif
+
 // ===========================================================
 //  FUNCIÓN PARA DIAGNOSTICAR ESTADO DEL GPS
 // ===========================================================
@@ -165,17 +348,61 @@ static bool gps_diagnostico_ok(double vel, bool fix_ok)
         return false;
     }
 
+    // 4) Dejaron de llegar fixes: la última velocidad ya no es la actual
+    if (!gps_fix_vigente()) {
+        ESP_LOGW("MONITOR_VEL", "⏱️ FIX OBSOLETO (%lu ms) → Vel %.2f ignorada", (unsigned long)gps_get_edad_fix_ms(), vel);
+        vTaskDelay(pdMS_TO_TICKS(200));
+        return false;
+    }
+
     return true; // Todo está OK
 }
 
 
 // ===========================================================
-//  Task principal
+//  ESTADO INICIAL
 // ===========================================================
-void task_monitor_velocidad(void *pvParameters)
+void monitor_velocidad_init(void)
 {
+#if CONFIG_ARRANQUE_TIBIO
+    // Reinicio tibio: el bloque RTC tiene el contador y si se estaba sobre el
+    // umbral (un exceso en curso no se vuelve a contar)
+    const arranque_rtc_t *rtc = arranque_estado_tibio();
+    if (rtc != NULL) {
+        contador_eventos = rtc->contador_eventos;
+        estado_eventos.sobre_umbral = rtc->sobre_umbral;
+        ESP_LOGI(TAG, "Contador restaurado de RTC: %u", contador_eventos);
+    } else {
+        leer_contador_guardado_en_nvs();
+        arranque_guardar_monitor(contador_eventos, estado_eventos.sobre_umbral);
+    }
+#else
     leer_contador_guardado_en_nvs();
+#endif
     display_set_number(contador_eventos);
+}
+
+// ===========================================================
+//  Task principal
+// ===========================================================
+void task_monitor_velocidad(void *pvParameters)
+{
+#if CONFIG_ARRANQUE_TIBIO
+    // Fuera del camino crítico: si el reinicio cortó un commit, NVS se pone al día
+    // (nvs_set_u32 no escribe si el valor no cambió)
+    if (arranque_es_tibio())
+        guardar_contador_eventos(contador_eventos);
+#endif
+#if CONFIG_MONITOR_REGLAS
+    cargar_reglas();
+    leer_contadores_reglas();
+#if CONFIG_ARRANQUE_TIBIO
+    // reglas que estaban en evento no se vuelven a contar
+    const arranque_rtc_t *rtc = arranque_estado_tibio();
+    if (rtc != NULL)
+        estado_reglas.condicion = estado_reglas.activas = rtc->reglas_activas;
+#endif
+#endif
 
     while (1)
     {
@@ -190,29 +417,57 @@ void task_monitor_velocidad(void *pvParameters)
         // =============================
         // ESTADO NORMAL (GPS con FIX)
         // =============================
-        if (!estaba_sobre_umbral && vel > umbral_velocidad)
+        TRAZA_INICIO(TRAZA_DECIDIR);
+#if CONFIG_MONITOR_REGLAS
+        // gps_get_contador_rmc sube antes del filtrado: con el otro núcleo a mitad
+        // de gnss_publicar_fix se evaluaría la velocidad cruda
+        double vel_fix;
+        uint32_t t_fix_ms;
+        uint32_t fix_n = gps_get_fix_publicado(&vel_fix, &t_fix_ms);
+        if (fix_n != ultimo_fix_evaluado) {
+            ultimo_fix_evaluado = fix_n;
+            evaluar_reglas(vel_fix, t_fix_ms);
+        }
+
+        if (estado_reglas.activas & tabla_reglas.continua)
+        {
+            alerta_bi_bi();
+        }
+#else
+#if CONFIG_ARRANQUE_TIBIO
+        bool estaba_sobre_umbral = estado_eventos.sobre_umbral;
+#endif
+        if (monitor_eventos_evaluar(&estado_eventos, vel, umbral_velocidad))
         {
             contador_eventos++;
-            estaba_sobre_umbral = true;
+#if CONFIG_ARRANQUE_TIBIO
+            // antes del commit a NVS: un reset durante la escritura no pierde el evento
+            arranque_guardar_monitor(contador_eventos, estado_eventos.sobre_umbral);
+#endif
 
             ESP_LOGI(TAG, "🚀 Evento #%u (vel=%.2f)", contador_eventos, vel);
 
             guardar_contador_eventos(contador_eventos);
             display_set_number(contador_eventos);
 
+            TRAZA_INICIO(TRAZA_BUZZER);
             buzzer_on();
             vTaskDelay(pdMS_TO_TICKS(120));
             buzzer_off();
+            TRAZA_FIN(TRAZA_BUZZER);
         }
 
-        if (estaba_sobre_umbral && vel > umbral_velocidad)
+#if CONFIG_ARRANQUE_TIBIO
+        if (estado_eventos.sobre_umbral != estaba_sobre_umbral)
+            arranque_guardar_monitor(contador_eventos, estado_eventos.sobre_umbral);
+#endif
+
+        if (estado_eventos.sobre_umbral)
         {
             alerta_bi_bi();
         }
-        else
-        {
-            estaba_sobre_umbral = false;
-        }
+#endif
+        TRAZA_FIN(TRAZA_DECIDIR);
 
         vTaskDelay(pdMS_TO_TICKS(40));
     }
@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "sdkconfig.h"
 
 // GETTERS
 double monitor_velocidad_get_umbral(void);
@@ -10,9 +11,15 @@ uint16_t monitor_velocidad_get_contador_eventos(void);
 bool monitor_velocidad_ultimo_fix_valido(void);
 
 // SETTERS
+#if CONFIG_MONITOR_UMBRALES_AJUSTABLES
 void monitor_velocidad_set_umbral(double nuevo_umbral);
+#endif
 void monitor_velocidad_reset_contador(void);
 
+// Contador y estado inicial (bloque RTC tras reinicio tibio, si no NVS) y
+// primer valor del display. Llamar antes de crear la tarea.
+void monitor_velocidad_init(void);
+
 // TAREA PRINCIPAL
 void task_monitor_velocidad(void *pvParameters);
 
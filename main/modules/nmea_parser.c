@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "modules/nmea_parser.h"
+
+// ===========================================================
+//  CONVERSIÓN NMEA ddmm.mmmm → grados decimales
+// ===========================================================
+GPS_HOT_ATTR double nmea_to_decimal(double nmea_value, char hemisphere)
+{
+    int degrees = (int)(nmea_value / 100);
+    double minutes = nmea_value - (degrees * 100);
+    double decimal = degrees + (minutes / 60.0);
+    if (hemisphere == 'S' || hemisphere == 'W')
+        decimal *= -1.0;
+    return decimal;
+}
+
+// ===========================================================
+//  ACUMULADOR DE LÍNEAS
+// ===========================================================
+GPS_HOT_ATTR void nmea_acumular(nmea_acumulador_t *acc, const uint8_t *datos, size_t largo, nmea_por_linea_t por_linea, void *ctx)
+{
+    while (largo > 0) {
+        // de a medio buffer: una lectura grande no pisa el resto pendiente
+        size_t n = largo < sizeof(acc->buffer) / 2 ? largo : sizeof(acc->buffer) / 2;
+
+        if (acc->largo + n >= sizeof(acc->buffer) - 1) {
+            acc->largo = 0; // prevenir overflow (línea sin '\n' demasiado larga)
+        }
+
+        memcpy(&acc->buffer[acc->largo], datos, n);
+        acc->largo += n;
+        acc->buffer[acc->largo] = '\0';
+        datos += n;
+        largo -= n;
+
+        // Procesar líneas completas
+        char *inicio = acc->buffer;
+        char *nl; // dónde termina la sentencia (\n)
+
+        while ((nl = strchr(inicio, '\n')) != NULL) {
+            *nl = 0;
+            if (nl > inicio && *(nl - 1) == '\r') {
+                *(nl - 1) = 0;
+            }
+            por_linea(inicio, ctx);
+            inicio = nl + 1;
+        }
+
+        // Compactar el buffer con el resto incompleto
+        size_t resto = strlen(inicio);
+        memmove(acc->buffer, inicio, resto + 1);
+        acc->largo = resto;
+    }
+}
+
+// ===========================================================
+//  VERIFICACIÓN DE CHECKSUM
+// ===========================================================
+GPS_HOT_ATTR bool nmea_verify_checksum(const char *sentence)
+{
+    if (sentence == NULL || *sentence != '$') return false;
+    const char *asterisk = strchr(sentence, '*');
+    if (!asterisk) return false;
+
+    uint8_t checksum = 0;
+    for (const char *p = sentence + 1; p < asterisk; p++)
+        checksum ^= (uint8_t)*p;
+
+    if (strlen(asterisk) < 3) return false;
+    uint8_t received = (uint8_t)strtol(asterisk + 1, NULL, 16);
+    return (checksum == received);
+}
+
+// ===========================================================
+//  PARSER GPRMC (posición, velocidad, rumbo)
+// ===========================================================
+GPS_HOT_ATTR bool gps_parse_gprmc(const char *nmea, gps_data_t *gps)
+{
+    if (strncmp(nmea, "$GPRMC", 6) != 0) return false;
+
+    char buf[128];
+    strncpy(buf, nmea, sizeof(buf));
+    buf[sizeof(buf) - 1] = '\0';
+
+    char *resto;
+    char *tok = strtok_r(buf, ",", &resto);
+    int field = 0;
+
+    while (tok != NULL) {
+        switch (field) {
+            case 1:
+                strncpy(gps->time, tok, sizeof(gps->time) - 1);
+                gps->time[sizeof(gps->time) - 1] = '\0';
+                break;
+            case 2: gps->valid = (tok[0] == 'A'); break;
+            case 3: gps->latitude = atof(tok); break;
+            case 4: gps->latitude = nmea_to_decimal(gps->latitude, tok[0]); break;
+            case 5: gps->longitude = atof(tok); break;
+            case 6: gps->longitude = nmea_to_decimal(gps->longitude, tok[0]); break;
+            case 7: gps->speed_kmh = atof(tok) * 1.852; break;
+            case 8: gps->course_deg = atof(tok); break;
+            case 9:
+                strncpy(gps->date, tok, sizeof(gps->date) - 1);
+                gps->date[sizeof(gps->date) - 1] = '\0';
+                break;
+        }
+        tok = strtok_r(NULL, ",", &resto);
+        field++;
+    }
+    return true;
+}
+
+// ===========================================================
+//  PARSER GPGGA (precisión, altitud, satélites)
+// ===========================================================
+#if CONFIG_GPS_PARSE_GGA
+GPS_HOT_ATTR bool gps_parse_gpgga(const char *nmea, gps_quality_t *q)
+{
+    if (strncmp(nmea, "$GPGGA", 6) != 0) return false;
+
+    char buf[128];
+    strncpy(buf, nmea, sizeof(buf));
+    buf[sizeof(buf) - 1] = '\0';
+
+    char *resto;
+    char *tok = strtok_r(buf, ",", &resto);
+    int field = 0;
+
+    while (tok != NULL) {
+        switch (field) {
+            case 7: q->satellites = atoi(tok); break;
+            case 8: q->hdop = atof(tok); break;
+            case 9: q->altitude = atof(tok); break;
+        }
+        tok = strtok_r(NULL, ",", &resto);
+        field++;
+    }
+    return true;
+}
+#endif // CONFIG_GPS_PARSE_GGA
+
+// ===========================================================
+//  FILTRO KALMAN UNIDIMENSIONAL
+// ===========================================================
+#if CONFIG_GPS_KALMAN
+void kalman_init(kalman_t *kf, double Q, double R)
+{
+    kf->estimate = 0.0;
+    kf->P = 1.0;
+    kf->Q = Q;
+    kf->R = R;
+}
+
+GPS_HOT_ATTR double kalman_update(kalman_t *kf, double measurement)
+{
+    kf->P += kf->Q;
+    double K = kf->P / (kf->P + kf->R);
+    kf->estimate += K * (measurement - kf->estimate);
+    kf->P *= (1.0 - K);
+    return kf->estimate;
+}
+#endif // CONFIG_GPS_KALMAN
@@ -0,0 +1,77 @@
+#ifndef NMEA_PARSER_H
+#define NMEA_PARSER_H
+
+// Parsers NMEA, checksum y Kalman: sin dependencias de FreeRTOS ni de drivers,
+// se compilan igual en el firmware y en las herramientas de host (host/).
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+#include "modules/atributos.h"
+
+// ==================== ESTRUCTURAS DE DATOS ====================
+
+// Datos extraídos de la trama GPRMC
+typedef struct {
+    double latitude;        // Latitud en grados decimales
+    double longitude;       // Longitud en grados decimales
+    double speed_kmh;       // Velocidad (km/h)
+    double course_deg;      // Rumbo (grados)
+    char time[16];          // Hora UTC (hhmmss)
+    char date[8];           // Fecha (ddmmyy)
+    bool valid;             // True si el fix es válido ('A')
+} gps_data_t;
+
+// Datos extraídos de la trama GPGGA
+typedef struct {
+    double altitude;        // Altitud sobre el nivel del mar (m)
+    int satellites;         // Satélites usados
+    double hdop;            // Precisión horizontal
+} gps_quality_t;
+
+// Filtro Kalman unidimensional (para velocidad)
+typedef struct {
+    double estimate;
+    double P;
+    double Q;
+    double R;
+} kalman_t;
+
+// Acumulador de líneas: junta los fragmentos leídos del UART y entrega cada
+// línea completa sin \r\n
+#define NMEA_ACUMULADOR_MAX 2048
+
+typedef struct {
+    char buffer[NMEA_ACUMULADOR_MAX];
+    size_t largo;           // bytes válidos en buffer
+} nmea_acumulador_t;
+
+// linea apunta al buffer del acumulador y se puede modificar en el lugar, incluidos
+// los 2 bytes que siguen a su NUL (donde estaban "\r\n"), si se restauran antes de volver
+typedef void (*nmea_por_linea_t)(char *linea, void *ctx);
+
+// ==================== FUNCIONES PÚBLICAS ====================
+
+// Parsers
+bool gps_parse_gprmc(const char *nmea_sentence, gps_data_t *gps);
+#if CONFIG_GPS_PARSE_GGA
+bool gps_parse_gpgga(const char *nmea_sentence, gps_quality_t *quality);
+#endif
+
+// Llama a por_linea con cada línea completa; el resto queda para la próxima lectura
+void nmea_acumular(nmea_acumulador_t *acc, const uint8_t *datos, size_t largo, nmea_por_linea_t por_linea, void *ctx);
+
+// Checksum
+bool nmea_verify_checksum(const char *sentence);
+
+// Conversión ddmm.mmmm → grados decimales
+double nmea_to_decimal(double nmea_value, char hemisphere);
+
+// Kalman
+#if CONFIG_GPS_KALMAN
+void kalman_init(kalman_t *kf, double Q, double R);
+double kalman_update(kalman_t *kf, double measurement);
+#endif
+
+#endif // NMEA_PARSER_H
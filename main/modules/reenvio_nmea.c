@@ -0,0 +1,212 @@
+#include <stdio.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_log.h>
+#include <esp_cpu.h>
+#include <esp_timer.h>
+#include <driver/uart.h>
+
+#include "modules/gnss.h"
+#include "modules/reenvio_nmea.h"
+
+static const char *TAG = "REENVIO_NMEA";
+
+#define REENVIO_UART            CONFIG_NMEA_REENVIO_UART_PORT_NUM
+#define REENVIO_MAX_FILTROS     12
+#define REENVIO_REPORTE_S       60
+
+// uart_write_bytes espera lugar en el buffer TX con portMAX_DELAY: antes de escribir
+// se exige el peor caso de lo que ocupa. uart_tx_all (ESP-IDF) guarda un ítem
+// uart_tx_data_t y los datos en trozos de hasta la mitad del ítem máximo; cada ítem
+// lleva cabecera y se alinea a 4, y como el ring no parte ítems, uno que no entra
+// al final deja ese resto sin usar.
+#define RING_CABECERA           8
+#define RING_ITEM_TX            12      // sizeof(uart_tx_data_t)
+#define RING_ALINEAR(n)         (((n) + 3u) & ~3u)
+#define RING_TROZO              ((RING_ALINEAR(CONFIG_NMEA_REENVIO_TX_BUFFER / 2) - RING_CABECERA) / 2)
+
+#if REENVIO_UART == GPS_UART_NUM
+#error "El reenvío NMEA no puede usar el mismo UART que el GPS"
+#endif
+#if CONFIG_TELEMETRIA_BINARIA && REENVIO_UART == CONFIG_TELEMETRIA_UART_PORT_NUM
+#error "El reenvío NMEA y la telemetría binaria usan el mismo UART"
+#endif
+
+// Filtro compilado en init: tipos de 3 letras ("RMC") se comparan después del
+// talker; los más largos ("GPRMC", "PMTK") desde el principio de la dirección
+typedef struct {
+    char tipo[6];
+    uint8_t largo;
+} reenvio_filtro_t;
+
+static reenvio_filtro_t filtros[REENVIO_MAX_FILTROS];
+static uint8_t n_filtros = 0;           // 0 = todas las sentencias
+
+static int64_t t_lectura = 0;
+static int64_t t_lectura_anterior = 0;
+
+static uint32_t lineas_enviadas = 0;
+static uint32_t lineas_descartadas = 0;
+static uint32_t lineas_filtradas = 0;
+static uint64_t ciclos_total = 0;
+static uint32_t ciclos_peor = 0;
+static uint64_t latencia_total_us = 0;
+static uint32_t latencia_peor_us = 0;
+static int64_t ultimo_reporte = 0;
+
+// ===========================================================
+//  FILTRO DE SENTENCIAS
+// ===========================================================
+static void compilar_filtro(const char *spec)
+{
+    n_filtros = 0;
+    if (strcmp(spec, "*") == 0) return;
+
+    const char *p = spec;
+    while (*p && n_filtros < REENVIO_MAX_FILTROS) {
+        while (*p == ',' || *p == ' ') p++;
+        size_t n = strcspn(p, ", ");
+        if (n >= 3 && n < sizeof(filtros[0].tipo)) {
+            memcpy(filtros[n_filtros].tipo, p, n);
+            filtros[n_filtros].tipo[n] = '\0';
+            filtros[n_filtros].largo = (uint8_t)n;
+            n_filtros++;
+        } else if (n > 0) {
+            ESP_LOGW(TAG, "Filtro ignorado: '%.*s' (3 a 5 caracteres)", (int)n, p);
+        }
+        p += n;
+    }
+}
+
+// Bytes del buffer TX que puede consumir un uart_write_bytes de n bytes
+static size_t ocupacion_peor(size_t n)
+{
+    size_t trozos = (n + RING_TROZO - 1) / RING_TROZO;
+    size_t mayor = n < RING_TROZO ? n : RING_TROZO;
+    if (mayor < RING_ITEM_TX) mayor = RING_ITEM_TX;
+    return RING_CABECERA + RING_ALINEAR(RING_ITEM_TX)
+         + n + trozos * (RING_CABECERA + 3)
+         + RING_CABECERA + RING_ALINEAR(mayor);      // resto sin usar al dar la vuelta
+}
+
+static bool pasa_filtro(const char *linea)
+{
+    if (n_filtros == 0) return true;
+    for (uint8_t i = 0; i < n_filtros; i++) {
+        const char *dir = (filtros[i].largo == 3) ? linea + 3 : linea + 1;
+        if (strncmp(dir, filtros[i].tipo, filtros[i].largo) == 0) return true;
+    }
+    return false;
+}
+
+// ===========================================================
+//  CONFIGURACIÓN UART DE REENVÍO
+// ===========================================================
+void init_uart_reenvio(void)
+{
+    const uart_config_t uart_config = {
+        .baud_rate = CONFIG_NMEA_REENVIO_BAUD_RATE,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+    };
+
+    uart_param_config(REENVIO_UART, &uart_config);
+    uart_set_pin(REENVIO_UART, CONFIG_NMEA_REENVIO_TX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    // RX mínimo exigido por el driver; el buffer TX absorbe las ráfagas de cada época
+    uart_driver_install(REENVIO_UART, 256, CONFIG_NMEA_REENVIO_TX_BUFFER, 0, NULL, 0);
+
+    compilar_filtro(CONFIG_NMEA_REENVIO_FILTRO);
+
+    ESP_LOGI(TAG, "UART reenvío NMEA inicializado (UART%d, %d baudios, filtro \"%s\")",
+             REENVIO_UART, CONFIG_NMEA_REENVIO_BAUD_RATE,
+             n_filtros ? CONFIG_NMEA_REENVIO_FILTRO : "*");
+}
+
+// ===========================================================
+//  REENVÍO (llamado desde el lector GPS)
+// ===========================================================
+void reenvio_nmea_lectura(void)
+{
+    t_lectura_anterior = t_lectura;
+    t_lectura = esp_timer_get_time();
+}
+
+void reenvio_nmea_linea(char *linea)
+{
+    uint32_t c0 = esp_cpu_get_cycle_count();
+
+    if (!pasa_filtro(linea)) {
+        lineas_filtradas++;
+        return;
+    }
+
+    size_t largo = strlen(linea);
+    size_t libre = 0;
+    uart_get_tx_buffer_free_size(REENVIO_UART, &libre);
+    if (libre < ocupacion_peor(largo + 2)) {
+        lineas_descartadas++;
+        return;
+    }
+    size_t en_cola = CONFIG_NMEA_REENVIO_TX_BUFFER - libre + largo + 2;
+
+    // El acumulador dejó NUL donde estaban "\r\n" (o "\n" y el primer byte de la
+    // siguiente línea): se vuelve a poner el fin de línea para una sola escritura
+    // y se restaura lo que había
+    char *fin = linea + largo;
+    char siguiente = fin[1];
+    fin[0] = '\r';
+    fin[1] = '\n';
+    uart_write_bytes(REENVIO_UART, linea, largo + 2);
+    fin[0] = '\0';
+    fin[1] = siguiente;
+    lineas_enviadas++;
+
+    uint32_t ciclos = esp_cpu_get_cycle_count() - c0;
+    ciclos_total += ciclos;
+    if (ciclos > ciclos_peor) ciclos_peor = ciclos;
+
+    // el fin de línea llegó después de la lectura anterior; sale cuando se vacíe
+    // lo que ya estaba encolado más la propia línea (10 bits por byte)
+    if (t_lectura_anterior) {
+        uint32_t us = (uint32_t)(esp_timer_get_time() - t_lectura_anterior) +
+                      (uint32_t)(en_cola * 10ull * 1000000ull / CONFIG_NMEA_REENVIO_BAUD_RATE);
+        latencia_total_us += us;
+        if (us > latencia_peor_us) latencia_peor_us = us;
+    }
+}
+
+void reenvio_nmea_reportar(void)
+{
+    int64_t ahora = esp_timer_get_time();
+    if (ahora - ultimo_reporte < REENVIO_REPORTE_S * 1000000ll) return;
+    ultimo_reporte = ahora;
+    if (lineas_enviadas == 0 && lineas_descartadas == 0) return;
+
+    ESP_LOGI(TAG, "🔁 %lu líneas reenviadas, %lu descartadas, %lu filtradas, %lu ciclos/línea (peor %lu), latencia %lu µs (peor %lu)",
+             (unsigned long)lineas_enviadas, (unsigned long)lineas_descartadas,
+             (unsigned long)lineas_filtradas,
+             (unsigned long)reenvio_nmea_get_ciclos_por_linea(), (unsigned long)ciclos_peor,
+             (unsigned long)reenvio_nmea_get_latencia_us_prom(), (unsigned long)latencia_peor_us);
+}
+
+// ===========================================================
+//  GETTERS DE DIAGNÓSTICO
+// ===========================================================
+uint32_t reenvio_nmea_get_lineas_enviadas(void) { return lineas_enviadas; }
+uint32_t reenvio_nmea_get_lineas_descartadas(void) { return lineas_descartadas; }
+uint32_t reenvio_nmea_get_lineas_filtradas(void) { return lineas_filtradas; }
+uint32_t reenvio_nmea_get_ciclos_peor(void) { return ciclos_peor; }
+uint32_t reenvio_nmea_get_latencia_us_peor(void) { return latencia_peor_us; }
+
+uint32_t reenvio_nmea_get_ciclos_por_linea(void)
+{
+    return lineas_enviadas ? (uint32_t)(ciclos_total / lineas_enviadas) : 0;
+}
+
+uint32_t reenvio_nmea_get_latencia_us_prom(void)
+{
+    return lineas_enviadas ? (uint32_t)(latencia_total_us / lineas_enviadas) : 0;
+}
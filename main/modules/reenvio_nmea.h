@@ -0,0 +1,33 @@
+#ifndef REENVIO_NMEA_H
+#define REENVIO_NMEA_H
+
+// Reenvío de las sentencias NMEA con checksum válido a un segundo UART, para otro
+// equipo del vehículo (registrador, telemática) que quiera el mismo GPS.
+// La línea sale del buffer del acumulador directo al buffer TX del driver: sin
+// copias intermedias ni formateo. Si no entra, se descarta; el lector nunca espera.
+
+#include <stdint.h>
+
+#if CONFIG_NMEA_REENVIO
+void init_uart_reenvio(void);
+// Llamado por el lector después de cada uart_read_bytes, con o sin datos (para la latencia)
+void reenvio_nmea_lectura(void);
+// Llamado con cada sentencia verificada, después del parseo local. Los 2 bytes
+// que siguen al NUL de linea se usan como "\r\n" durante la escritura y se
+// restauran: linea tiene que estar en un buffer escribible como el del acumulador
+void reenvio_nmea_linea(char *linea);
+// Log periódico de estadísticas (desde una tarea que pueda esperar en la consola)
+void reenvio_nmea_reportar(void);
+
+uint32_t reenvio_nmea_get_lineas_enviadas(void);
+uint32_t reenvio_nmea_get_lineas_descartadas(void);
+uint32_t reenvio_nmea_get_lineas_filtradas(void);
+uint32_t reenvio_nmea_get_ciclos_por_linea(void);
+uint32_t reenvio_nmea_get_ciclos_peor(void);
+// Cota de latencia por línea: desde la lectura anterior del UART del GPS (el fin de
+// línea llegó después) hasta que su último byte sale por el TX, contando lo encolado
+uint32_t reenvio_nmea_get_latencia_us_prom(void);
+uint32_t reenvio_nmea_get_latencia_us_peor(void);
+#endif
+
+#endif // REENVIO_NMEA_H
@@ -0,0 +1,289 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "modules/reglas.h"
+
+// La tabla se escribe en host y se lee en el ESP32: misma disposición en ambos
+_Static_assert(sizeof(reglas_tabla_t) == 1108, "tabla de reglas de 1108 bytes");
+
+#define MINUTOS_DIA 1440
+// Entre fixes más separados que esto la aceleración no se calcula
+#define ACEL_MAX_DT_MS 5000u
+
+static const char *const nombres_variable[REGLAS_VARIABLES] = { "vel", "acel" };
+static const char *const nombres_alerta[] = { "ninguna", "bip", "doble", "largo" };
+
+// ===========================================================
+//  CRC32 (IEEE, bit a bit: solo al compilar y al cargar la tabla)
+// ===========================================================
+static uint32_t crc32(const void *datos, size_t largo)
+{
+    const uint8_t *p = datos;
+    uint32_t crc = 0xFFFFFFFFu;
+    while (largo--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++)
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+static void sellar(reglas_tabla_t *t)
+{
+    t->crc = crc32(t, offsetof(reglas_tabla_t, crc));
+}
+
+bool reglas_tabla_valida(const reglas_tabla_t *t)
+{
+    return t->magia == REGLAS_MAGIA && t->version == REGLAS_VERSION &&
+           t->n <= REGLAS_MAX && t->crc == crc32(t, offsetof(reglas_tabla_t, crc));
+}
+
+// ===========================================================
+//  COMPILACIÓN
+// ===========================================================
+static int fallar(char *error, size_t largo_error, int linea, const char *msg, const char *token)
+{
+    if (error != NULL && largo_error > 0)
+        snprintf(error, largo_error, "línea %d: %s%s%s", linea, msg, token ? " → " : "", token ? token : "");
+    return linea;
+}
+
+static bool leer_float(const char *s, float *v)
+{
+    char *fin;
+    if (s == NULL) return false;
+    *v = strtof(s, &fin);
+    return fin != s && *fin == '\0';
+}
+
+static bool leer_hora(const char *s, int *minuto)
+{
+    int h, m;
+    char resto;
+    if (sscanf(s, "%d:%d%c", &h, &m, &resto) != 2 || h < 0 || h > 24 || m < 0 || m > 59) return false;
+    *minuto = (h * 60 + m) % MINUTOS_DIA;
+    return true;
+}
+
+static int indice_de(const char *s, const char *const *nombres, int n)
+{
+    for (int i = 0; i < n; i++)
+        if (strcmp(s, nombres[i]) == 0) return i;
+    return -1;
+}
+
+int reglas_compilar(const char *texto, int16_t huso_min, reglas_tabla_t *t, char *error, size_t largo_error)
+{
+    memset(t, 0, sizeof(*t));
+    t->magia = REGLAS_MAGIA;
+    t->version = REGLAS_VERSION;
+    t->huso_min = huso_min;
+
+    int linea = 0;
+    const char *p = texto;
+    while (p != NULL && *p) {
+        linea++;
+        const char *nl = strchr(p, '\n');
+        size_t largo = nl ? (size_t)(nl - p) : strlen(p);
+        char buf[160];
+        if (largo >= sizeof(buf)) return fallar(error, largo_error, linea, "línea demasiado larga", NULL);
+        memcpy(buf, p, largo);
+        buf[largo] = '\0';
+        p = nl ? nl + 1 : NULL;
+
+        char *coment = strchr(buf, '#');
+        if (coment) *coment = '\0';
+        // ';' separa reglas en una sola línea (texto de menuconfig)
+        char *guardado_linea = NULL;
+        for (char *sent = strtok_r(buf, ";", &guardado_linea); sent; sent = strtok_r(NULL, ";", &guardado_linea)) {
+            char *guardado = NULL;
+            char *tok = strtok_r(sent, " \t\r", &guardado);
+            if (tok == NULL) continue;
+
+            if (strcmp(tok, "huso") == 0) {
+                float v;
+                if (!leer_float(strtok_r(NULL, " \t\r", &guardado), &v) || v < -720 || v > 840)
+                    return fallar(error, largo_error, linea, "huso en minutos entre -720 y 840", NULL);
+                t->huso_min = (int16_t)v;
+                continue;
+            }
+
+            // nombre: puede venir pegado al ':' o separado
+            size_t ln = strlen(tok);
+            if (tok[ln - 1] == ':') {
+                tok[--ln] = '\0';
+            } else {
+                char *dos = strtok_r(NULL, " \t\r", &guardado);
+                if (dos == NULL || strcmp(dos, ":") != 0)
+                    return fallar(error, largo_error, linea, "se esperaba 'nombre:'", tok);
+            }
+            if (ln == 0 || ln >= REGLAS_NOMBRE_MAX)
+                return fallar(error, largo_error, linea, "nombre vacío o de más de 11 caracteres", tok);
+            for (size_t k = 0; k < ln; k++)
+                if (!isalnum((unsigned char)tok[k]) && tok[k] != '_')
+                    return fallar(error, largo_error, linea, "nombre con caracteres inválidos", tok);
+            for (int k = 0; k < t->n; k++)
+                if (strcmp(t->nombre[k], tok) == 0)
+                    return fallar(error, largo_error, linea, "nombre repetido", tok);
+            if (t->n >= REGLAS_MAX)
+                return fallar(error, largo_error, linea, "más reglas que REGLAS_MAX", NULL);
+
+            int i = t->n;
+            strcpy(t->nombre[i], tok);
+
+            // predicado: variable comparador valor
+            char *var = strtok_r(NULL, " \t\r", &guardado);
+            char *op = strtok_r(NULL, " \t\r", &guardado);
+            char *val = strtok_r(NULL, " \t\r", &guardado);
+            int v = var ? indice_de(var, nombres_variable, REGLAS_VARIABLES) : -1;
+            if (v < 0) return fallar(error, largo_error, linea, "variable desconocida (vel, acel)", var);
+            if (op == NULL || (strcmp(op, ">") != 0 && strcmp(op, "<") != 0))
+                return fallar(error, largo_error, linea, "comparador inválido (> o <)", op);
+            float umbral;
+            if (!leer_float(val, &umbral)) return fallar(error, largo_error, linea, "valor inválido", val);
+
+            t->variable[i] = (uint8_t)v;
+            t->signo[i] = op[0] == '>' ? 1.0f : -1.0f;
+            t->umbral[i] = t->signo[i] * umbral;
+            t->franja_largo[i] = MINUTOS_DIA;
+            t->alerta[i] = REGLA_ALERTA_BIP;
+
+            // opciones
+            while ((tok = strtok_r(NULL, " \t\r", &guardado)) != NULL) {
+                char *arg;
+                float f;
+                if (strcmp(tok, "durante") == 0) {
+                    if (!leer_float(arg = strtok_r(NULL, " \t\r", &guardado), &f) || f < 0 || f > 86400)
+                        return fallar(error, largo_error, linea, "duración en segundos inválida", arg);
+                    t->duracion_ms[i] = (uint32_t)(f * 1000.0f + 0.5f);
+                } else if (strcmp(tok, "histeresis") == 0) {
+                    if (!leer_float(arg = strtok_r(NULL, " \t\r", &guardado), &f) || f < 0)
+                        return fallar(error, largo_error, linea, "histéresis inválida", arg);
+                    t->histeresis[i] = f;
+                } else if (strcmp(tok, "franja") == 0) {
+                    arg = strtok_r(NULL, " \t\r", &guardado);
+                    char *guion = arg ? strchr(arg, '-') : NULL;
+                    int ini, fin;
+                    if (guion == NULL) return fallar(error, largo_error, linea, "franja HH:MM-HH:MM", arg);
+                    *guion = '\0';
+                    if (!leer_hora(arg, &ini) || !leer_hora(guion + 1, &fin))
+                        return fallar(error, largo_error, linea, "franja HH:MM-HH:MM", arg);
+                    t->franja_ini[i] = (uint16_t)ini;
+                    t->franja_largo[i] = (uint16_t)(fin == ini ? MINUTOS_DIA : (fin - ini + MINUTOS_DIA) % MINUTOS_DIA);
+                } else if (strcmp(tok, "alerta") == 0) {
+                    arg = strtok_r(NULL, " \t\r", &guardado);
+                    int a = arg ? indice_de(arg, nombres_alerta, 4) : -1;
+                    if (a < 0) return fallar(error, largo_error, linea, "alerta desconocida (bip, doble, largo, ninguna)", arg);
+                    t->alerta[i] = (uint8_t)a;
+                } else if (strcmp(tok, "continua") == 0) {
+                    t->continua |= 1u << i;
+                } else {
+                    return fallar(error, largo_error, linea, "opción desconocida", tok);
+                }
+            }
+            t->n++;
+        }
+    }
+
+    sellar(t);
+    return 0;
+}
+
+int reglas_describir(const reglas_tabla_t *t, int i, char *salida, size_t largo)
+{
+    int n = snprintf(salida, largo, "%s: %s %c %g", t->nombre[i], nombres_variable[t->variable[i]],
+                     t->signo[i] > 0 ? '>' : '<', (double)reglas_umbral(t, i));
+    if (t->duracion_ms[i] && n < (int)largo)
+        n += snprintf(salida + n, largo - n, " durante %g", t->duracion_ms[i] / 1000.0);
+    if (t->franja_largo[i] < MINUTOS_DIA && n < (int)largo) {
+        int fin = (t->franja_ini[i] + t->franja_largo[i]) % MINUTOS_DIA;
+        n += snprintf(salida + n, largo - n, " franja %02d:%02d-%02d:%02d",
+                      t->franja_ini[i] / 60, t->franja_ini[i] % 60, fin / 60, fin % 60);
+    }
+    if (t->histeresis[i] > 0 && n < (int)largo)
+        n += snprintf(salida + n, largo - n, " histeresis %g", (double)t->histeresis[i]);
+    if (n < (int)largo)
+        n += snprintf(salida + n, largo - n, " alerta %s%s", reglas_nombre_alerta(t->alerta[i]),
+                      (t->continua >> i) & 1u ? " continua" : "");
+    return n;
+}
+
+void reglas_fijar_umbral(reglas_tabla_t *t, int i, float valor)
+{
+    t->umbral[i] = t->signo[i] * valor;
+    sellar(t);
+}
+
+float reglas_umbral(const reglas_tabla_t *t, int i)
+{
+    return t->signo[i] * t->umbral[i];
+}
+
+const char *reglas_nombre_alerta(uint8_t alerta)
+{
+    return alerta < sizeof(nombres_alerta) / sizeof(nombres_alerta[0]) ? nombres_alerta[alerta] : "?";
+}
+
+// ===========================================================
+//  EVALUACIÓN POR FIX
+// ===========================================================
+void reglas_estado_init(reglas_estado_t *e)
+{
+    memset(e, 0, sizeof(*e));
+}
+
+uint16_t reglas_minuto_dia(const char *hora_utc, int16_t huso_min)
+{
+    for (int k = 0; k < 4; k++)
+        if (!isdigit((unsigned char)hora_utc[k])) return 0;
+    int m = ((hora_utc[0] - '0') * 10 + (hora_utc[1] - '0')) * 60 +
+            (hora_utc[2] - '0') * 10 + (hora_utc[3] - '0') + huso_min;
+    m %= MINUTOS_DIA;
+    return (uint16_t)(m < 0 ? m + MINUTOS_DIA : m);
+}
+
+// Cada regla es la misma secuencia de operaciones (comparaciones convertidas
+// en 0/1, selección por máscara); solo se salta por los bits de evento, que son raros.
+GPS_HOT_ATTR uint32_t reglas_evaluar(const reglas_tabla_t *t, reglas_estado_t *e, const reglas_entrada_t *in)
+{
+    float valores[REGLAS_VARIABLES];
+    uint32_t dt_ms = in->t_ms - e->t_anterior_ms;
+    valores[REGLA_VEL] = in->vel_kmh;
+    valores[REGLA_ACEL] = (e->hay_anterior && dt_ms > 0 && dt_ms <= ACEL_MAX_DT_MS)
+                          ? (in->vel_kmh - e->vel_anterior) * 1000.0f / (float)dt_ms : 0.0f;
+    e->vel_anterior = in->vel_kmh;
+    e->t_anterior_ms = in->t_ms;
+    e->hay_anterior = true;
+
+    const uint32_t minuto = in->minuto_dia + MINUTOS_DIA;
+    uint32_t condicion = 0, activas = 0;
+
+    for (int i = 0; i < t->n; i++) {
+        const uint32_t antes = (e->condicion >> i) & 1u;
+        const float x = t->signo[i] * valores[t->variable[i]];
+        const float limite = t->umbral[i] - (float)antes * t->histeresis[i];
+
+        uint32_t d = minuto - t->franja_ini[i];
+        d -= MINUTOS_DIA & (0u - (uint32_t)(d >= MINUTOS_DIA));
+        const uint32_t c = (uint32_t)(x > limite) & (uint32_t)(d < t->franja_largo[i]);
+
+        // el tramo arranca en el primer fix con el predicado verdadero
+        const uint32_t sigue = 0u - (c & antes);
+        e->desde_ms[i] = (e->desde_ms[i] & sigue) | (in->t_ms & ~sigue);
+        const uint32_t cumple = c & (uint32_t)(in->t_ms - e->desde_ms[i] >= t->duracion_ms[i]);
+
+        condicion |= c << i;
+        activas |= cumple << i;
+    }
+
+    const uint32_t eventos = activas & ~e->activas;
+    e->condicion = condicion;
+    e->activas = activas;
+
+    for (uint32_t m = eventos; m; m &= m - 1)
+        e->contador[__builtin_ctz(m)]++;
+    return eventos;
+}
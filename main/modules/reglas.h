@@ -0,0 +1,109 @@
+#ifndef REGLAS_H
+#define REGLAS_H
+
+// Motor de reglas de eventos: un texto declarativo se compila (en host con
+// host/compilar_reglas, o al arrancar desde menuconfig) a una tabla compacta de
+// predicados por regla, y cada fix se evalúa contra todas las reglas en una sola
+// pasada sin saltos por regla. Sin dependencias de FreeRTOS ni de drivers.
+//
+// Sintaxis (una regla por línea, '#' comenta):
+//   huso -240                                   minutos respecto de UTC para las franjas
+//   nombre: vel|acel >|< valor [durante S] [franja HH:MM-HH:MM] [histeresis H]
+//           [alerta bip|doble|largo|ninguna] [continua]
+//
+//   exceso:     vel > 30 alerta bip continua
+//   sostenido:  vel > 80 durante 10 histeresis 3 alerta doble
+//   frenada:    acel < -12 alerta largo
+//   nocturno:   vel > 50 franja 22:00-06:00
+//   ralenti:    vel < 3 durante 600 alerta ninguna
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "modules/nmea_parser.h"
+
+#define REGLAS_MAX          32      // una regla por bit de las máscaras
+#define REGLAS_NOMBRE_MAX   12
+#define REGLAS_MAGIA        0x52474C31u   // "RGL1"
+#define REGLAS_VERSION      1
+
+typedef enum {
+    REGLA_VEL = 0,          // km/h (filtrada)
+    REGLA_ACEL,             // km/h/s entre fixes consecutivos
+    REGLAS_VARIABLES,
+} regla_variable_t;
+
+typedef enum {
+    REGLA_ALERTA_NINGUNA = 0,
+    REGLA_ALERTA_BIP,       // un bip corto al iniciar el evento
+    REGLA_ALERTA_DOBLE,     // dos bips cortos
+    REGLA_ALERTA_LARGO,     // un bip largo
+} regla_alerta_t;
+
+// ==================== TABLA COMPILADA ====================
+// Estructura de arreglos: la pasada por fix recorre cada campo en orden.
+// Se guarda tal cual en la partición "reglas" (little endian).
+typedef struct {
+    uint32_t magia;
+    uint16_t version;
+    uint8_t n;
+    uint8_t reservado;
+    int16_t huso_min;
+    uint16_t reservado2;
+    uint32_t continua;                      // máscara: bi-bi mientras la regla está activa
+    float signo[REGLAS_MAX];                // +1 para '>', -1 para '<'
+    float umbral[REGLAS_MAX];               // ya multiplicado por signo
+    float histeresis[REGLAS_MAX];
+    uint32_t duracion_ms[REGLAS_MAX];
+    uint16_t franja_ini[REGLAS_MAX];        // minuto local de inicio
+    uint16_t franja_largo[REGLAS_MAX];      // minutos; 1440 = todo el día
+    uint8_t variable[REGLAS_MAX];
+    uint8_t alerta[REGLAS_MAX];
+    char nombre[REGLAS_MAX][REGLAS_NOMBRE_MAX];
+    uint32_t crc;                           // CRC32 de todo lo anterior
+} reglas_tabla_t;
+
+// ==================== ESTADO POR REGLA ====================
+typedef struct {
+    uint32_t condicion;                     // máscara: predicado verdadero en el último fix
+    uint32_t activas;                       // máscara: predicado sostenido por su duración
+    uint32_t desde_ms[REGLAS_MAX];          // inicio del tramo con predicado verdadero
+    uint32_t contador[REGLAS_MAX];
+    float vel_anterior;
+    uint32_t t_anterior_ms;
+    bool hay_anterior;
+} reglas_estado_t;
+
+typedef struct {
+    float vel_kmh;
+    uint32_t t_ms;                          // reloj monotónico
+    uint16_t minuto_dia;                    // hora local (0..1439)
+} reglas_entrada_t;
+
+// ==================== COMPILACIÓN ====================
+// Compila el texto; huso_min es el valor por defecto si no hay línea "huso".
+// Devuelve 0 o el número de línea del error (mensaje en error, si no es NULL).
+int reglas_compilar(const char *texto, int16_t huso_min, reglas_tabla_t *t, char *error, size_t largo_error);
+
+// Verifica magia, versión, cantidad y CRC de una tabla leída de flash
+bool reglas_tabla_valida(const reglas_tabla_t *t);
+// Texto equivalente a la regla i (para logs y para revisar lo compilado)
+int reglas_describir(const reglas_tabla_t *t, int i, char *salida, size_t largo);
+
+// Cambia el umbral de la regla i manteniendo su comparador (y el CRC)
+void reglas_fijar_umbral(reglas_tabla_t *t, int i, float valor);
+float reglas_umbral(const reglas_tabla_t *t, int i);
+
+// ==================== EVALUACIÓN ====================
+void reglas_estado_init(reglas_estado_t *e);
+// Evalúa un fix válido contra todas las reglas. Devuelve la máscara de reglas
+// cuyo evento empezó en este fix (y suma sus contadores).
+uint32_t reglas_evaluar(const reglas_tabla_t *t, reglas_estado_t *e, const reglas_entrada_t *in);
+
+// Minuto del día local a partir de la hora "hhmmss..." del fix (0 si no es válida)
+uint16_t reglas_minuto_dia(const char *hora_utc, int16_t huso_min);
+
+const char *reglas_nombre_alerta(uint8_t alerta);
+
+#endif // REGLAS_H
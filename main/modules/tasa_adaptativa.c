@@ -0,0 +1,71 @@
+#include <math.h>
+
+#include "modules/tasa_adaptativa.h"
+
+static const char *nombres[] = { "REPOSO", "NORMAL", "ALERTA" };
+
+void tasa_init(tasa_controlador_t *c, const tasa_parametros_t *p, tasa_modo_t inicial)
+{
+    c->p = *p;
+    c->modo = inicial;
+    c->vel_anterior = 0.0;
+    c->t_anterior_ms = 0;
+    c->t_cambio_ms = 0;
+    c->hay_anterior = false;
+}
+
+// Modo que corresponde a la velocidad con un corrimiento (histéresis) hacia abajo
+static tasa_modo_t modo_para(const tasa_parametros_t *p, double vel, double acel, double umbral, double corrimiento)
+{
+    if (vel >= umbral - p->margen_alerta_kmh - corrimiento || fabs(acel) >= p->acel_alta_kmh_s)
+        return TASA_ALERTA;
+    if (vel < p->umbral_movimiento_kmh || vel < umbral - p->margen_reposo_kmh - corrimiento)
+        return TASA_REPOSO;
+    return TASA_NORMAL;
+}
+
+tasa_modo_t tasa_evaluar(tasa_controlador_t *c, double vel_kmh, uint32_t t_ms, double umbral_kmh)
+{
+    double acel = 0.0;
+    if (c->hay_anterior && t_ms > c->t_anterior_ms)
+        acel = (vel_kmh - c->vel_anterior) * 1000.0 / (t_ms - c->t_anterior_ms);
+    c->vel_anterior = vel_kmh;
+    c->t_anterior_ms = t_ms;
+    c->hay_anterior = true;
+
+    tasa_modo_t deseado = modo_para(&c->p, vel_kmh, acel, umbral_kmh, 0.0);
+
+    if (deseado > c->modo) {
+        // subir de inmediato: nunca perder resolución cerca del umbral
+        c->modo = deseado;
+        c->t_cambio_ms = t_ms;
+    } else if (deseado < c->modo) {
+        // bajar solo si también se cumple con histéresis y tras la permanencia mínima
+        tasa_modo_t con_histeresis = modo_para(&c->p, vel_kmh, acel, umbral_kmh, c->p.histeresis_kmh);
+        if (con_histeresis < c->modo && t_ms - c->t_cambio_ms >= c->p.permanencia_ms) {
+            c->modo = con_histeresis;
+            c->t_cambio_ms = t_ms;
+        }
+    }
+    return c->modo;
+}
+
+int tasa_frecuencia_hz(tasa_modo_t modo, int frecuencia_normal_hz, int frecuencia_alerta_hz)
+{
+    switch (modo) {
+        case TASA_REPOSO: return 1;
+        case TASA_ALERTA: return frecuencia_alerta_hz;
+        default:          return frecuencia_normal_hz;
+    }
+}
+
+// A 1 Hz RMC+GGA sobra en cualquier baudio: GGA solo se apaga a 10 Hz, donde no cabe
+bool tasa_con_gga(tasa_modo_t modo)
+{
+    return modo != TASA_ALERTA;
+}
+
+const char *tasa_nombre(tasa_modo_t modo)
+{
+    return nombres[modo];
+}
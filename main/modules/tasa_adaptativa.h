@@ -0,0 +1,43 @@
+#ifndef TASA_ADAPTATIVA_H
+#define TASA_ADAPTATIVA_H
+
+// Política de frecuencia de fix según cercanía al umbral de velocidad.
+// Sin dependencias de hardware: se usa en el firmware y en host/replay_tasa.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+    TASA_REPOSO = 0,    // detenido o muy por debajo del umbral: 1 Hz, solo RMC
+    TASA_NORMAL,        // frecuencia de menuconfig, RMC + GGA
+    TASA_ALERTA,        // cerca del umbral o aceleración alta: máxima frecuencia, solo RMC
+} tasa_modo_t;
+
+typedef struct {
+    double margen_alerta_kmh;   // ALERTA si vel >= umbral - margen_alerta
+    double margen_reposo_kmh;   // REPOSO si vel < umbral - margen_reposo
+    double umbral_movimiento_kmh;
+    double acel_alta_kmh_s;     // |aceleración| que fuerza ALERTA
+    double histeresis_kmh;      // para bajar de modo hay que alejarse esto más
+    uint32_t permanencia_ms;    // tiempo mínimo en un modo antes de bajar
+} tasa_parametros_t;
+
+typedef struct {
+    tasa_parametros_t p;
+    tasa_modo_t modo;
+    double vel_anterior;
+    uint32_t t_anterior_ms;
+    uint32_t t_cambio_ms;
+    bool hay_anterior;
+} tasa_controlador_t;
+
+void tasa_init(tasa_controlador_t *c, const tasa_parametros_t *p, tasa_modo_t inicial);
+// Evalúa un fix (t_ms monotónico). Devuelve el modo deseado; subir es inmediato,
+// bajar exige histéresis y permanencia.
+tasa_modo_t tasa_evaluar(tasa_controlador_t *c, double vel_kmh, uint32_t t_ms, double umbral_kmh);
+
+int tasa_frecuencia_hz(tasa_modo_t modo, int frecuencia_normal_hz, int frecuencia_alerta_hz);
+bool tasa_con_gga(tasa_modo_t modo);
+const char *tasa_nombre(tasa_modo_t modo);
+
+#endif // TASA_ADAPTATIVA_H
@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+
+#include "modules/telemetria.h"
+#include "modules/varint.h"
+
+#if CONFIG_TELEMETRIA_BINARIA
+#include <freertos/FreeRTOS.h>
+#include <esp_log.h>
+#include <driver/uart.h>
+
+static const char *TAG = "TELEMETRIA";
+
+static telemetria_codificador_t codificador;
+static uint32_t tramas_enviadas = 0;
+static uint32_t tramas_descartadas = 0;
+#endif
+
+// ===========================================================
+//  CONVERSIÓN gps_data_t → unidades enteras
+// ===========================================================
+static uint8_t dos_digitos(const char *s)
+{
+    if (!isdigit((unsigned char)s[0]) || !isdigit((unsigned char)s[1])) return 0;
+    return (uint8_t)((s[0] - '0') * 10 + (s[1] - '0'));
+}
+
+void telemetria_fix_desde_gps(const gps_data_t *gps, const gps_quality_t *q, telemetria_fix_t *out)
+{
+    // hhmmss.sss → milisegundos del día
+    uint32_t ms = 0;
+    if (strlen(gps->time) >= 6) {
+        ms = (dos_digitos(gps->time) * 3600u + dos_digitos(gps->time + 2) * 60u +
+              dos_digitos(gps->time + 4)) * 1000u;
+        if (gps->time[6] == '.')
+            ms += (uint32_t)lround(atof(gps->time + 6) * 1000.0);
+    }
+    out->ms_dia = ms;
+
+    // ddmmyy
+    if (strlen(gps->date) >= 6) {
+        out->dia = dos_digitos(gps->date);
+        out->mes = dos_digitos(gps->date + 2);
+        out->anio = dos_digitos(gps->date + 4);
+    } else {
+        out->dia = out->mes = out->anio = 0;
+    }
+
+    out->lat_e7 = (int32_t)lround(gps->latitude * 1e7);
+    out->lon_e7 = (int32_t)lround(gps->longitude * 1e7);
+    out->vel_cent_kmh = (uint16_t)lround(fmin(fmax(gps->speed_kmh, 0.0), 655.35) * 100.0);
+    out->rumbo_cent_deg = (uint16_t)(lround(gps->course_deg * 100.0) % 36000);
+    out->alt_dm = (int32_t)lround(q->altitude * 10.0);
+    out->satelites = (uint8_t)q->satellites;
+    out->hdop_dec = (uint8_t)lround(fmin(q->hdop, 25.5) * 10.0);
+    out->flags = gps->valid ? TELEMETRIA_FLAG_VALIDO : 0;
+}
+
+// ===========================================================
+//  CODIFICADOR
+// ===========================================================
+void telemetria_codificador_init(telemetria_codificador_t *c, uint16_t intervalo_clave)
+{
+    memset(c, 0, sizeof(*c));
+    c->intervalo_clave = intervalo_clave ? intervalo_clave : 1;
+}
+
+size_t telemetria_codificar(telemetria_codificador_t *c, const telemetria_fix_t *fix, uint8_t *buf)
+{
+    const telemetria_fix_t *a = &c->anterior;
+    bool clave = !c->hay_anterior
+              || c->fixes_desde_clave >= c->intervalo_clave
+              || fix->dia != a->dia || fix->ms_dia < a->ms_dia;  // cambio de día
+
+    uint8_t *p = buf + 3;  // SYNC, TIPO, LEN se completan al final
+    *p++ = c->seq++;
+
+    if (clave) {
+        p = put_u32(p, fix->ms_dia);
+        *p++ = fix->dia;
+        *p++ = fix->mes;
+        *p++ = fix->anio;
+        p = put_u32(p, (uint32_t)fix->lat_e7);
+        p = put_u32(p, (uint32_t)fix->lon_e7);
+        p = put_u16(p, fix->vel_cent_kmh);
+        p = put_u16(p, fix->rumbo_cent_deg);
+        p = put_u32(p, (uint32_t)fix->alt_dm);
+        *p++ = fix->satelites;
+        *p++ = fix->hdop_dec;
+        c->fixes_desde_clave = 0;
+    } else {
+        // el rumbo se envía por el camino corto (-18000..17999)
+        int32_t drumbo = (int32_t)fix->rumbo_cent_deg - a->rumbo_cent_deg;
+        if (drumbo >= 18000) drumbo -= 36000;
+        if (drumbo < -18000) drumbo += 36000;
+
+        p = put_varint(p, fix->ms_dia - a->ms_dia);
+        p = put_svarint(p, fix->lat_e7 - a->lat_e7);
+        p = put_svarint(p, fix->lon_e7 - a->lon_e7);
+        p = put_svarint(p, (int32_t)fix->vel_cent_kmh - a->vel_cent_kmh);
+        p = put_svarint(p, drumbo);
+        p = put_svarint(p, fix->alt_dm - a->alt_dm);
+    }
+    *p++ = fix->flags;
+
+    size_t payload = p - (buf + 3);
+    buf[0] = TELEMETRIA_SYNC;
+    buf[1] = clave ? TELEMETRIA_TIPO_CLAVE : TELEMETRIA_TIPO_DELTA;
+    buf[2] = (uint8_t)payload;
+    p = put_u16(p, crc16_ccitt(buf + 1, payload + 2));
+
+    c->anterior = *fix;
+    c->hay_anterior = true;
+    c->fixes_desde_clave++;
+    return p - buf;
+}
+
+#if CONFIG_TELEMETRIA_BINARIA
+// ===========================================================
+//  CONFIGURACIÓN UART DE TELEMETRÍA
+// ===========================================================
+void init_uart_telemetria(void)
+{
+    const uart_config_t uart_config = {
+        .baud_rate = CONFIG_TELEMETRIA_BAUD_RATE,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+    };
+
+    uart_param_config(CONFIG_TELEMETRIA_UART_PORT_NUM, &uart_config);
+    uart_set_pin(CONFIG_TELEMETRIA_UART_PORT_NUM, CONFIG_TELEMETRIA_TX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    // RX mínimo exigido por el driver; TX con buffer para no bloquear al lector GPS
+    uart_driver_install(CONFIG_TELEMETRIA_UART_PORT_NUM, 256, CONFIG_TELEMETRIA_TX_BUFFER, 0, NULL, 0);
+
+    telemetria_codificador_init(&codificador, CONFIG_TELEMETRIA_INTERVALO_CLAVE);
+
+    ESP_LOGI(TAG, "UART telemetría inicializado (UART%d, %d baudios)", CONFIG_TELEMETRIA_UART_PORT_NUM, CONFIG_TELEMETRIA_BAUD_RATE);
+}
+
+// ===========================================================
+//  ENVÍO DE UN FIX (llamado desde el lector GPS)
+// ===========================================================
+void telemetria_enviar_fix(const gps_data_t *gps, const gps_quality_t *q)
+{
+    telemetria_fix_t fix;
+    uint8_t trama[TELEMETRIA_MAX_TRAMA];
+    size_t libre = 0;
+
+    telemetria_fix_desde_gps(gps, q, &fix);
+
+    // si la trama no entra en el buffer TX se descarta: nunca bloquear al lector.
+    // Se fuerza clave en la siguiente para que el receptor pueda resincronizar.
+    uart_get_tx_buffer_free_size(CONFIG_TELEMETRIA_UART_PORT_NUM, &libre);
+    if (libre < TELEMETRIA_MAX_TRAMA) {
+        tramas_descartadas++;
+        codificador.hay_anterior = false;
+        return;
+    }
+
+    size_t len = telemetria_codificar(&codificador, &fix, trama);
+    uart_write_bytes(CONFIG_TELEMETRIA_UART_PORT_NUM, trama, len);
+    tramas_enviadas++;
+}
+
+uint32_t telemetria_get_tramas_enviadas(void) { return tramas_enviadas; }
+uint32_t telemetria_get_tramas_descartadas(void) { return tramas_descartadas; }
+#endif // CONFIG_TELEMETRIA_BINARIA
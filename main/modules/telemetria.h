@@ -0,0 +1,65 @@
+#ifndef TELEMETRIA_H
+#define TELEMETRIA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "modules/nmea_parser.h"
+
+// ==================== FORMATO DE TRAMA ====================
+// [SYNC 0xA5] [TIPO] [LEN] [payload LEN bytes] [CRC16 LE]
+// CRC16-CCITT (poly 0x1021, init 0xFFFF) sobre TIPO, LEN y payload.
+//
+// TIPO_CLAVE (payload fijo, little endian):
+//   seq u8 | ms_dia u32 | dia u8 | mes u8 | anio u8 | lat i32 (1e-7°) | lon i32 (1e-7°)
+//   vel u16 (0.01 km/h) | rumbo u16 (0.01°) | alt i32 (0.1 m) | sats u8 | hdop u8 (0.1) | flags u8
+// TIPO_DELTA (relativo al fix anterior):
+//   seq u8 | dt varint (ms) | dlat, dlon, dvel, drumbo, dalt varint zig-zag | flags u8
+#define TELEMETRIA_SYNC         0xA5
+#define TELEMETRIA_TIPO_CLAVE   0x01
+#define TELEMETRIA_TIPO_DELTA   0x02
+#define TELEMETRIA_MAX_TRAMA    48
+
+#define TELEMETRIA_FLAG_VALIDO  0x01
+
+// Fix en unidades enteras (lo que viaja por el enlace)
+typedef struct {
+    uint32_t ms_dia;
+    uint8_t dia, mes, anio;
+    int32_t lat_e7;
+    int32_t lon_e7;
+    uint16_t vel_cent_kmh;
+    uint16_t rumbo_cent_deg;
+    int32_t alt_dm;
+    uint8_t satelites;
+    uint8_t hdop_dec;
+    uint8_t flags;
+} telemetria_fix_t;
+
+// Estado del codificador (último fix enviado y contador de claves)
+typedef struct {
+    telemetria_fix_t anterior;
+    uint8_t seq;
+    uint16_t fixes_desde_clave;
+    uint16_t intervalo_clave;
+    bool hay_anterior;
+} telemetria_codificador_t;
+
+// ==================== CODIFICADOR (sin dependencias de hardware) ====================
+void telemetria_codificador_init(telemetria_codificador_t *c, uint16_t intervalo_clave);
+void telemetria_fix_desde_gps(const gps_data_t *gps, const gps_quality_t *q, telemetria_fix_t *out);
+// Escribe la trama del fix en buf (>= TELEMETRIA_MAX_TRAMA) y devuelve su largo
+size_t telemetria_codificar(telemetria_codificador_t *c, const telemetria_fix_t *fix, uint8_t *buf);
+
+// ==================== SALIDA POR UART ====================
+#if CONFIG_TELEMETRIA_BINARIA
+void init_uart_telemetria(void);
+// Codifica y encola el fix; si el buffer TX está lleno descarta la trama
+void telemetria_enviar_fix(const gps_data_t *gps, const gps_quality_t *q);
+
+uint32_t telemetria_get_tramas_enviadas(void);
+uint32_t telemetria_get_tramas_descartadas(void);
+#endif
+
+#endif // TELEMETRIA_H
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <esp_log.h>
+#include <esp_partition.h>
+
+#include "modules/trayecto.h"
+#include "modules/trayecto_codec.h"
+
+static const char *TAG = "TRAYECTO";
+
+#define TRAYECTO_SUBTIPO_PARTICION 0x40
+
+static const esp_partition_t *particion = NULL;
+static QueueHandle_t cola_fixes = NULL;
+
+static trayecto_almacen_t almacen;
+static trayecto_escritor_t escritor;
+static trayecto_simplificador_t simplificador;
+
+static uint32_t fixes_recibidos = 0;
+static uint32_t puntos_guardados = 0;
+static uint32_t fixes_descartados = 0;
+
+// ===========================================================
+//  ACCESO A LA PARTICIÓN
+// ===========================================================
+static bool flash_leer(void *ctx, uint32_t offset, void *dst, size_t len)
+{
+    return esp_partition_read(particion, offset, dst, len) == ESP_OK;
+}
+
+static bool flash_escribir(void *ctx, uint32_t offset, const void *src, size_t len)
+{
+    return esp_partition_write(particion, offset, src, len) == ESP_OK;
+}
+
+static bool flash_borrar_sector(void *ctx, uint32_t offset)
+{
+    return esp_partition_erase_range(particion, offset, TRAYECTO_SECTOR) == ESP_OK;
+}
+
+// ===========================================================
+//  INICIALIZACIÓN
+// ===========================================================
+void init_trayecto(void)
+{
+    particion = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, TRAYECTO_SUBTIPO_PARTICION, "trayecto");
+    if (particion == NULL) {
+        ESP_LOGE(TAG, "No existe la partición 'trayecto' (revisar partitions.csv)");
+        return;
+    }
+
+    almacen.ctx = NULL;
+    almacen.n_sectores = particion->size / TRAYECTO_SECTOR;
+    almacen.leer = flash_leer;
+    almacen.escribir = flash_escribir;
+    almacen.borrar_sector = flash_borrar_sector;
+
+    trayecto_escritor_init(&escritor, &almacen, CONFIG_TRAYECTO_PUNTOS_POR_CHUNK);
+    trayecto_simplificador_init(&simplificador, CONFIG_TRAYECTO_TOLERANCIA_M, CONFIG_TRAYECTO_MAX_INTERVALO_S);
+
+    cola_fixes = xQueueCreate(CONFIG_TRAYECTO_COLA, sizeof(trayecto_punto_t));
+
+    ESP_LOGI(TAG, "Partición trayecto: %lu sectores, sector actual %lu (seq %lu, %lu bytes)",
+             (unsigned long)almacen.n_sectores, (unsigned long)escritor.sector,
+             (unsigned long)escritor.seq, (unsigned long)escritor.usado);
+}
+
+// ===========================================================
+//  ENTRADA DESDE EL LECTOR GPS
+// ===========================================================
+void trayecto_registrar_fix(const gps_data_t *gps)
+{
+    if (cola_fixes == NULL) return;
+
+    trayecto_punto_t p;
+    trayecto_punto_desde_gps(gps, &p);
+    if (p.t == 0) return;  // sin fecha todavía
+
+    fixes_recibidos++;
+    if (xQueueSend(cola_fixes, &p, 0) != pdTRUE) {
+        fixes_descartados++;
+    }
+}
+
+// ===========================================================
+//  TAREA: SIMPLIFICAR Y ESCRIBIR
+// ===========================================================
+void task_trayecto(void *pvParameters)
+{
+    trayecto_punto_t p, conservado;
+    TickType_t ultimo_vaciado = xTaskGetTickCount();
+
+    while (1) {
+        if (cola_fixes == NULL) {
+            vTaskDelay(pdMS_TO_TICKS(10000));
+            continue;
+        }
+
+        if (xQueueReceive(cola_fixes, &p, pdMS_TO_TICKS(1000)) == pdTRUE) {
+            if (trayecto_simplificar(&simplificador, &p, &conservado)) {
+                if (trayecto_escritor_agregar(&escritor, &conservado)) {
+                    puntos_guardados++;
+                } else {
+                    ESP_LOGE(TAG, "Error escribiendo en la partición trayecto");
+                }
+            }
+        }
+
+        // limitar lo que se pierde ante un corte de energía
+        if (xTaskGetTickCount() - ultimo_vaciado > pdMS_TO_TICKS(CONFIG_TRAYECTO_VACIAR_S * 1000)) {
+            trayecto_escritor_vaciar(&escritor);
+            ultimo_vaciado = xTaskGetTickCount();
+        }
+    }
+}
+
+// ===========================================================
+//  GETTERS DE DIAGNÓSTICO
+// ===========================================================
+uint32_t trayecto_get_fixes_recibidos(void) { return fixes_recibidos; }
+uint32_t trayecto_get_puntos_guardados(void) { return puntos_guardados; }
+uint32_t trayecto_get_fixes_descartados(void) { return fixes_descartados; }
+uint32_t trayecto_get_bytes_escritos(void) { return escritor.bytes_escritos; }
@@ -0,0 +1,24 @@
+#ifndef TRAYECTO_H
+#define TRAYECTO_H
+
+#include <stdint.h>
+
+#include "modules/nmea_parser.h"
+
+// Registro del trayecto simplificado en la partición "trayecto".
+// El lector GPS solo encola el fix; la simplificación y la escritura en
+// flash ocurren en task_trayecto (prioridad baja).
+
+void init_trayecto(void);
+// Llamado por cada fix válido; nunca bloquea (descarta si la cola está llena)
+void trayecto_registrar_fix(const gps_data_t *gps);
+
+void task_trayecto(void *pvParameters);
+
+// GETTERS DE DIAGNÓSTICO
+uint32_t trayecto_get_fixes_recibidos(void);
+uint32_t trayecto_get_puntos_guardados(void);
+uint32_t trayecto_get_fixes_descartados(void);
+uint32_t trayecto_get_bytes_escritos(void);
+
+#endif // TRAYECTO_H
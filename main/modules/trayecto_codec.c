@@ -0,0 +1,328 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+
+#include "modules/trayecto_codec.h"
+#include "modules/varint.h"
+
+// metros por grado de latitud (esfera de 6371 km)
+#define METROS_POR_GRADO 111194.9f
+
+// ===========================================================
+//  CONVERSIONES
+// ===========================================================
+static int dos_digitos(const char *s)
+{
+    if (!isdigit((unsigned char)s[0]) || !isdigit((unsigned char)s[1])) return -1;
+    return (s[0] - '0') * 10 + (s[1] - '0');
+}
+
+uint32_t trayecto_segundos_desde_2000(const char *fecha, const char *hora)
+{
+    if (strlen(fecha) < 6 || strlen(hora) < 6) return 0;
+
+    int d = dos_digitos(fecha), m = dos_digitos(fecha + 2), a = dos_digitos(fecha + 4);
+    int hh = dos_digitos(hora), mm = dos_digitos(hora + 2), ss = dos_digitos(hora + 4);
+    if (d < 1 || m < 1 || m > 12 || a < 0 || hh < 0 || mm < 0 || ss < 0) return 0;
+
+    // días desde 2000-01-01 (calendario gregoriano, años 2000-2099)
+    static const uint16_t dias_antes_del_mes[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+    uint32_t dias = a * 365u + (a + 3) / 4 + dias_antes_del_mes[m - 1] + (d - 1);
+    if (m > 2 && (a % 4) == 0) dias++;
+
+    return dias * 86400u + hh * 3600u + mm * 60u + ss;
+}
+
+void trayecto_punto_desde_gps(const gps_data_t *gps, trayecto_punto_t *p)
+{
+    p->t = trayecto_segundos_desde_2000(gps->date, gps->time);
+    p->lat_e6 = (int32_t)lround(gps->latitude * 1e6);
+    p->lon_e6 = (int32_t)lround(gps->longitude * 1e6);
+}
+
+// Proyección local en metros respecto de ref
+static void a_metros(const trayecto_punto_t *p, const trayecto_punto_t *ref, float cos_lat, float *x, float *y)
+{
+    *x = (float)(p->lon_e6 - ref->lon_e6) * 1e-6f * METROS_POR_GRADO * cos_lat;
+    *y = (float)(p->lat_e6 - ref->lat_e6) * 1e-6f * METROS_POR_GRADO;
+}
+
+static float cos_latitud(const trayecto_punto_t *p)
+{
+    return cosf((float)p->lat_e6 * 1e-6f * (float)M_PI / 180.0f);
+}
+
+float trayecto_distancia_m(const trayecto_punto_t *a, const trayecto_punto_t *b)
+{
+    float x, y;
+    a_metros(b, a, cos_latitud(a), &x, &y);
+    return sqrtf(x * x + y * y);
+}
+
+float trayecto_distancia_segmento_m(const trayecto_punto_t *p, const trayecto_punto_t *a, const trayecto_punto_t *b)
+{
+    float c = cos_latitud(a);
+    float bx, by, px, py;
+    a_metros(b, a, c, &bx, &by);
+    a_metros(p, a, c, &px, &py);
+
+    float l2 = bx * bx + by * by;
+    float u = (l2 > 0.0f) ? (px * bx + py * by) / l2 : 0.0f;
+    if (u < 0.0f) u = 0.0f;
+    if (u > 1.0f) u = 1.0f;
+
+    float dx = px - u * bx;
+    float dy = py - u * by;
+    return sqrtf(dx * dx + dy * dy);
+}
+
+// ===========================================================
+//  SIMPLIFICADOR (ventana deslizante)
+// ===========================================================
+void trayecto_simplificador_init(trayecto_simplificador_t *s, float tolerancia_m, uint32_t max_intervalo_s)
+{
+    memset(s, 0, sizeof(*s));
+    s->tolerancia_m = tolerancia_m;
+    s->max_intervalo_s = max_intervalo_s;
+}
+
+static bool ventana_se_desvia(const trayecto_simplificador_t *s, const trayecto_punto_t *p)
+{
+    float c = cos_latitud(&s->ancla);
+    float bx, by;
+    a_metros(p, &s->ancla, c, &bx, &by);
+    float l2 = bx * bx + by * by;
+    float tol2 = s->tolerancia_m * s->tolerancia_m;
+
+    for (int i = 0; i < s->n; i++) {
+        float px, py;
+        a_metros(&s->ventana[i], &s->ancla, c, &px, &py);
+        float u = (l2 > 0.0f) ? (px * bx + py * by) / l2 : 0.0f;
+        if (u < 0.0f) u = 0.0f;
+        if (u > 1.0f) u = 1.0f;
+        float dx = px - u * bx;
+        float dy = py - u * by;
+        if (dx * dx + dy * dy > tol2) return true;
+    }
+    return false;
+}
+
+bool trayecto_simplificar(trayecto_simplificador_t *s, const trayecto_punto_t *p, trayecto_punto_t *salida)
+{
+    if (!s->hay_ancla) {
+        s->ancla = *p;
+        s->hay_ancla = true;
+        *salida = *p;
+        return true;
+    }
+
+    bool vencido = (p->t - s->ancla.t) >= s->max_intervalo_s;
+
+    if (s->n == 0) {
+        if (vencido) {
+            s->ancla = *p;
+            *salida = *p;
+            return true;
+        }
+        s->ventana[s->n++] = *p;
+        return false;
+    }
+
+    // ventana llena: se descarta uno de cada dos puntos intermedios para que el
+    // segmento pueda seguir creciendo en rectas largas sin aumentar el costo
+    if (s->n == TRAYECTO_VENTANA_MAX) {
+        for (int i = 0; i < TRAYECTO_VENTANA_MAX / 2; i++)
+            s->ventana[i] = s->ventana[2 * i + 1];
+        s->n = TRAYECTO_VENTANA_MAX / 2;
+    }
+
+    if (vencido || ventana_se_desvia(s, p)) {
+        // el último punto de la ventana pasa a ser el nuevo ancla
+        *salida = s->ventana[s->n - 1];
+        s->ancla = *salida;
+        s->n = 0;
+        s->ventana[s->n++] = *p;
+        return true;
+    }
+
+    s->ventana[s->n++] = *p;
+    return false;
+}
+
+bool trayecto_simplificador_vaciar(trayecto_simplificador_t *s, trayecto_punto_t *salida)
+{
+    if (s->n == 0) return false;
+    *salida = s->ventana[s->n - 1];
+    s->ancla = *salida;
+    s->n = 0;
+    return true;
+}
+
+// ===========================================================
+//  DECODIFICACIÓN DE UN SECTOR
+// ===========================================================
+int trayecto_decodificar_sector(const uint8_t *sector, uint32_t *seq, uint32_t *usado,
+                                trayecto_punto_t *ultimo, trayecto_punto_cb cb, void *ctx)
+{
+    if (get_u32(sector) != TRAYECTO_MAGIC) return -1;
+    if (get_u16(sector + TRAYECTO_CABECERA - 2) != crc16_ccitt(sector, TRAYECTO_CABECERA - 2)) return -1;
+
+    trayecto_punto_t p = {
+        .t = get_u32(sector + 8),
+        .lat_e6 = (int32_t)get_u32(sector + 12),
+        .lon_e6 = (int32_t)get_u32(sector + 16),
+    };
+    if (seq) *seq = get_u32(sector + 4);
+    if (cb) cb(ctx, &p);
+    int n = 1;
+
+    uint32_t pos = TRAYECTO_CABECERA;
+    while (pos + 3 <= TRAYECTO_SECTOR) {
+        uint8_t len = sector[pos];
+        if (len == 0 || len > TRAYECTO_CHUNK_MAX || pos + 3 + len > TRAYECTO_SECTOR) break;
+
+        const uint8_t *c = sector + pos + 1;
+        const uint8_t *fin = c + len;
+        if (get_u16(fin) != crc16_ccitt(sector + pos, len + 1)) break;
+
+        while (c < fin) {
+            uint32_t dt;
+            int32_t dlat, dlon;
+            if (!(c = get_varint(c, fin, &dt))) break;
+            if (!(c = get_svarint(c, fin, &dlat))) break;
+            if (!(c = get_svarint(c, fin, &dlon))) break;
+            p.t += dt;
+            p.lat_e6 += dlat;
+            p.lon_e6 += dlon;
+            if (cb) cb(ctx, &p);
+            n++;
+        }
+        pos += 3 + len;
+    }
+
+    if (usado) *usado = pos;
+    if (ultimo) *ultimo = p;
+    return n;
+}
+
+// ===========================================================
+//  ESCRITOR
+// ===========================================================
+void trayecto_escritor_init(trayecto_escritor_t *w, const trayecto_almacen_t *almacen, uint8_t puntos_por_chunk)
+{
+    memset(w, 0, sizeof(*w));
+    w->almacen = almacen;
+    w->puntos_por_chunk = puntos_por_chunk ? puntos_por_chunk : 1;
+
+    // sector con la secuencia más alta (comparación circular de seq)
+    uint8_t cab[TRAYECTO_CABECERA];
+    for (uint32_t s = 0; s < almacen->n_sectores; s++) {
+        if (!almacen->leer(almacen->ctx, s * TRAYECTO_SECTOR, cab, sizeof(cab))) continue;
+        if (get_u32(cab) != TRAYECTO_MAGIC) continue;
+        if (get_u16(cab + TRAYECTO_CABECERA - 2) != crc16_ccitt(cab, TRAYECTO_CABECERA - 2)) continue;
+        uint32_t seq = get_u32(cab + 4);
+        if (!w->hay_sector || (int32_t)(seq - w->seq) > 0) {
+            w->hay_sector = true;
+            w->seq = seq;
+            w->sector = s;
+        }
+    }
+    if (!w->hay_sector) return;
+
+    // retomar el sector más reciente a continuación del último chunk íntegro
+    uint8_t *buf = malloc(TRAYECTO_SECTOR);
+    if (buf == NULL) return;
+    if (almacen->leer(almacen->ctx, w->sector * TRAYECTO_SECTOR, buf, TRAYECTO_SECTOR)) {
+        uint32_t usado;
+        if (trayecto_decodificar_sector(buf, NULL, &usado, &w->ultimo, NULL, NULL) > 0) {
+            // si quedó basura tras el último chunk íntegro no se puede reescribir: sector nuevo
+            bool limpio = true;
+            for (uint32_t i = usado; i < TRAYECTO_SECTOR && i < usado + 8; i++)
+                if (buf[i] != 0xFF) limpio = false;
+            w->usado = usado;
+            w->abierto = limpio;
+        }
+    }
+    free(buf);
+}
+
+static bool abrir_sector(trayecto_escritor_t *w, const trayecto_punto_t *p)
+{
+    const trayecto_almacen_t *a = w->almacen;
+    if (w->hay_sector) {
+        w->sector = (w->sector + 1) % a->n_sectores;
+        w->seq++;
+    }
+
+    uint32_t base = w->sector * TRAYECTO_SECTOR;
+    if (!a->borrar_sector(a->ctx, base)) return false;
+
+    uint8_t cab[TRAYECTO_CABECERA];
+    uint8_t *q = cab;
+    q = put_u32(q, TRAYECTO_MAGIC);
+    q = put_u32(q, w->seq);
+    q = put_u32(q, p->t);
+    q = put_u32(q, (uint32_t)p->lat_e6);
+    q = put_u32(q, (uint32_t)p->lon_e6);
+    put_u16(q, crc16_ccitt(cab, TRAYECTO_CABECERA - 2));
+    if (!a->escribir(a->ctx, base, cab, sizeof(cab))) return false;
+
+    w->hay_sector = true;
+    w->abierto = true;
+    w->usado = TRAYECTO_CABECERA;
+    w->ultimo = *p;
+    w->bytes_escritos += sizeof(cab);
+    return true;
+}
+
+bool trayecto_escritor_vaciar(trayecto_escritor_t *w)
+{
+    if (w->chunk_len == 0) return true;
+
+    const trayecto_almacen_t *a = w->almacen;
+    uint8_t trama[TRAYECTO_CHUNK_MAX + 3];
+    trama[0] = (uint8_t)w->chunk_len;
+    memcpy(trama + 1, w->chunk, w->chunk_len);
+    put_u16(trama + 1 + w->chunk_len, crc16_ccitt(trama, w->chunk_len + 1));
+
+    size_t len = w->chunk_len + 3;
+    bool ok = a->escribir(a->ctx, w->sector * TRAYECTO_SECTOR + w->usado, trama, len);
+    w->usado += len;
+    w->bytes_escritos += len;
+    w->chunk_len = 0;
+    w->chunk_pts = 0;
+    return ok;
+}
+
+bool trayecto_escritor_agregar(trayecto_escritor_t *w, const trayecto_punto_t *p)
+{
+    if (!w->abierto) return abrir_sector(w, p);
+
+    uint8_t delta[3 * VARINT_MAX_BYTES];
+    uint8_t *q = delta;
+    q = put_varint(q, p->t - w->ultimo.t);
+    q = put_svarint(q, p->lat_e6 - w->ultimo.lat_e6);
+    q = put_svarint(q, p->lon_e6 - w->ultimo.lon_e6);
+    size_t n = q - delta;
+
+    // el chunk pendiente más este punto debe entrar en el chunk y en el sector
+    if (w->chunk_len + n > TRAYECTO_CHUNK_MAX ||
+        w->usado + 3 + w->chunk_len + n > TRAYECTO_SECTOR) {
+        if (!trayecto_escritor_vaciar(w)) return false;
+        if (w->usado + 3 + n > TRAYECTO_SECTOR) {
+            w->abierto = false;
+            return abrir_sector(w, p);
+        }
+    }
+
+    memcpy(w->chunk + w->chunk_len, delta, n);
+    w->chunk_len += n;
+    w->chunk_pts++;
+    w->ultimo = *p;
+
+    if (w->chunk_pts >= w->puntos_por_chunk)
+        return trayecto_escritor_vaciar(w);
+    return true;
+}
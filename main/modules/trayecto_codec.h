@@ -0,0 +1,102 @@
+#ifndef TRAYECTO_CODEC_H
+#define TRAYECTO_CODEC_H
+
+// Simplificación en línea y codificación del trayecto (migas de pan).
+// Sin dependencias de FreeRTOS ni de flash: el acceso al almacenamiento se
+// hace con callbacks, así el mismo código corre en el firmware y en host/.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "modules/nmea_parser.h"
+
+// ==================== FORMATO EN FLASH ====================
+// Cada sector de 4 KB es independiente:
+//   cabecera: magic u32 | seq u32 | t0 u32 | lat0 i32 | lon0 i32 | crc16
+//   chunks:   [len u8] [payload len bytes] [crc16 LE] ... hasta 0xFF (flash borrada)
+// payload = puntos en deltas respecto del anterior: dt varint (s),
+//           dlat, dlon varint zig-zag (1e-6°)
+#define TRAYECTO_SECTOR         4096
+#define TRAYECTO_MAGIC          0x31595254  // "TRY1"
+#define TRAYECTO_CABECERA       22
+#define TRAYECTO_CHUNK_MAX      240
+#define TRAYECTO_VENTANA_MAX    32
+
+// Punto del trayecto en unidades enteras
+typedef struct {
+    uint32_t t;         // segundos desde 2000-01-01 UTC
+    int32_t lat_e6;     // 1e-6 grados
+    int32_t lon_e6;
+} trayecto_punto_t;
+
+// ==================== SIMPLIFICADOR ====================
+// Ventana deslizante: se conserva el último punto de la ventana cuando algún
+// punto intermedio se aleja más de tolerancia_m del segmento ancla→nuevo o cuando
+// pasan max_intervalo_s desde el último conservado. Si la ventana se llena se
+// descarta uno de cada dos puntos intermedios: el costo por fix queda acotado
+// por TRAYECTO_VENTANA_MAX.
+typedef struct {
+    trayecto_punto_t ancla;
+    trayecto_punto_t ventana[TRAYECTO_VENTANA_MAX];
+    uint8_t n;
+    bool hay_ancla;
+    float tolerancia_m;
+    uint32_t max_intervalo_s;
+} trayecto_simplificador_t;
+
+void trayecto_simplificador_init(trayecto_simplificador_t *s, float tolerancia_m, uint32_t max_intervalo_s);
+// Devuelve true si hay un punto a conservar y lo deja en *salida
+bool trayecto_simplificar(trayecto_simplificador_t *s, const trayecto_punto_t *p, trayecto_punto_t *salida);
+// Conserva el último punto pendiente de la ventana (fin de viaje / apagado)
+bool trayecto_simplificador_vaciar(trayecto_simplificador_t *s, trayecto_punto_t *salida);
+
+// ==================== ALMACENAMIENTO ====================
+// Offsets relativos al inicio de la partición
+typedef struct {
+    void *ctx;
+    uint32_t n_sectores;
+    bool (*leer)(void *ctx, uint32_t offset, void *dst, size_t len);
+    bool (*escribir)(void *ctx, uint32_t offset, const void *src, size_t len);
+    bool (*borrar_sector)(void *ctx, uint32_t offset);
+} trayecto_almacen_t;
+
+typedef struct {
+    const trayecto_almacen_t *almacen;
+    uint32_t sector;            // sector en uso
+    uint32_t seq;               // número de secuencia del sector en uso
+    uint32_t usado;             // bytes ya escritos en el sector
+    bool abierto;
+    bool hay_sector;            // existe al menos un sector escrito
+    uint8_t puntos_por_chunk;
+    trayecto_punto_t ultimo;    // referencia del próximo delta
+    uint8_t chunk[TRAYECTO_CHUNK_MAX];
+    uint16_t chunk_len;
+    uint8_t chunk_pts;
+    uint32_t bytes_escritos;    // estadística
+} trayecto_escritor_t;
+
+// Busca el sector más reciente y continúa escribiendo a continuación
+void trayecto_escritor_init(trayecto_escritor_t *w, const trayecto_almacen_t *almacen, uint8_t puntos_por_chunk);
+bool trayecto_escritor_agregar(trayecto_escritor_t *w, const trayecto_punto_t *p);
+// Escribe el chunk pendiente aunque no esté lleno
+bool trayecto_escritor_vaciar(trayecto_escritor_t *w);
+
+// ==================== DECODIFICACIÓN ====================
+typedef void (*trayecto_punto_cb)(void *ctx, const trayecto_punto_t *p);
+
+// Decodifica un sector completo. Devuelve la cantidad de puntos o -1 si la
+// cabecera no es válida. usado = bytes válidos (cabecera + chunks íntegros).
+int trayecto_decodificar_sector(const uint8_t *sector, uint32_t *seq, uint32_t *usado,
+                                trayecto_punto_t *ultimo, trayecto_punto_cb cb, void *ctx);
+
+// ==================== CONVERSIONES ====================
+// Fecha ddmmyy + hora hhmmss → segundos desde 2000-01-01 (0 si no hay fecha)
+uint32_t trayecto_segundos_desde_2000(const char *fecha, const char *hora);
+void trayecto_punto_desde_gps(const gps_data_t *gps, trayecto_punto_t *p);
+// Distancia aproximada en metros (equirectangular, válida para tramos cortos)
+float trayecto_distancia_m(const trayecto_punto_t *a, const trayecto_punto_t *b);
+// Distancia en metros de p al segmento a-b
+float trayecto_distancia_segmento_m(const trayecto_punto_t *p, const trayecto_punto_t *a, const trayecto_punto_t *b);
+
+#endif // TRAYECTO_CODEC_H
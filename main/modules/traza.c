@@ -0,0 +1,222 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "modules/traza.h"
+
+#ifdef ESP_PLATFORM
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_attr.h>
+#include <esp_timer.h>
+#include <esp_cpu.h>
+#include <esp_log.h>
+#else
+#include <time.h>
+#include "esp_attr.h"
+#endif
+
+#ifdef ESP_PLATFORM
+#define TRAZA_NUCLEOS   2
+#else
+#define TRAZA_NUCLEOS   1
+#endif
+
+// ===========================================================
+//  ANILLO
+// ===========================================================
+typedef struct {
+    uint32_t t_us;      // esp_timer (común a los dos núcleos), 32 bits: ~71 min
+    uint32_t arg;       // tarea, cola o tarea dueña de la marca
+    uint8_t tipo;
+    uint8_t nucleo;
+    uint16_t extra;     // id de marca / 1 si viene de ISR
+} traza_registro_t;
+
+_Static_assert(sizeof(traza_registro_t) == 12, "registro de traza de 12 bytes");
+
+// Un anillo por núcleo: cada núcleo escribe solo el suyo con interrupciones
+// enmascaradas, sin spinlocks entre núcleos
+static DRAM_ATTR traza_registro_t anillo[TRAZA_NUCLEOS][CONFIG_TRAZA_EVENTOS];
+static DRAM_ATTR uint32_t escritos[TRAZA_NUCLEOS];
+static DRAM_ATTR volatile bool activa = true;
+// Núcleo dentro de registrar(): un hook del otro núcleo pudo pasar el chequeo de
+// activa justo antes del volcado, y traza_volcar espera a que salga
+static DRAM_ATTR volatile bool en_curso[TRAZA_NUCLEOS];
+
+static const char *nombres_marca[TRAZA_MARCAS] = {
+    [TRAZA_PARSE]   = "parse",
+    [TRAZA_DECIDIR] = "decidir",
+    [TRAZA_NVS]     = "nvs",
+    [TRAZA_BUZZER]  = "buzzer",
+};
+
+#ifdef ESP_PLATFORM
+static const char *TAG = "TRAZA";
+
+static inline uint32_t IRAM_ATTR reloj_us(void) { return (uint32_t)esp_timer_get_time(); }
+static inline uint32_t IRAM_ATTR tarea_actual(int nucleo)
+{
+    return (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandleForCore(nucleo);
+}
+#define NUCLEO_ACTUAL()         esp_cpu_get_core_id()
+#define BLOQUEAR(estado)        uint32_t estado = portSET_INTERRUPT_MASK_FROM_ISR()
+#define DESBLOQUEAR(estado)     portCLEAR_INTERRUPT_MASK_FROM_ISR(estado)
+#else
+static inline uint32_t reloj_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000ull + ts.tv_nsec / 1000);
+}
+static inline uint32_t tarea_actual(int nucleo) { return 0; }
+#define NUCLEO_ACTUAL()         0
+#define BLOQUEAR(estado)        (void)0
+#define DESBLOQUEAR(estado)     (void)0
+#endif
+
+static inline void IRAM_ATTR registrar(int nucleo, uint8_t tipo, uint32_t arg, uint16_t extra)
+{
+    uint32_t i = escritos[nucleo]++ % CONFIG_TRAZA_EVENTOS;
+    traza_registro_t *r = &anillo[nucleo][i];
+    r->t_us = reloj_us();
+    r->arg = arg;
+    r->tipo = tipo;
+    r->nucleo = (uint8_t)nucleo;
+    r->extra = extra;
+}
+
+// Con interrupciones enmascaradas: marca el núcleo como ocupado y recién después
+// mira activa (traza_volcar hace lo inverso), así uno de los dos ve al otro
+static inline bool IRAM_ATTR entrar(int nucleo)
+{
+    en_curso[nucleo] = true;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (activa) return true;
+    en_curso[nucleo] = false;
+    return false;
+}
+
+static inline void IRAM_ATTR salir(int nucleo)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    en_curso[nucleo] = false;
+}
+
+// ===========================================================
+//  HOOKS (traza_freertos.h) Y MARCAS
+// ===========================================================
+void IRAM_ATTR traza_evento(uint8_t tipo, uint32_t arg, uint16_t extra)
+{
+    if (!activa) return;
+    BLOQUEAR(estado);
+    int nucleo = NUCLEO_ACTUAL();
+    if (entrar(nucleo)) {
+        registrar(nucleo, tipo, arg, extra);
+        salir(nucleo);
+    }
+    DESBLOQUEAR(estado);
+}
+
+// Se llama dentro del planificador (ya en sección crítica)
+void IRAM_ATTR traza_cambio_tarea(uint8_t tipo)
+{
+    if (!activa) return;
+    int nucleo = NUCLEO_ACTUAL();
+    if (entrar(nucleo)) {
+        registrar(nucleo, tipo, tarea_actual(nucleo), 0);
+        salir(nucleo);
+    }
+}
+
+void traza_marca(uint8_t tipo, traza_marca_t marca)
+{
+    if (!activa) return;
+    BLOQUEAR(estado);
+    int nucleo = NUCLEO_ACTUAL();
+    if (entrar(nucleo)) {
+        registrar(nucleo, tipo, tarea_actual(nucleo), (uint16_t)marca);
+        salir(nucleo);
+    }
+    DESBLOQUEAR(estado);
+}
+
+// ===========================================================
+//  VOLCADO POR CONSOLA
+// ===========================================================
+#define TAREAS_MAX 32
+
+static const char *nombre_tarea(uint32_t h)
+{
+#ifdef ESP_PLATFORM
+    return h ? pcTaskGetName((TaskHandle_t)(uintptr_t)h) : "?";
+#else
+    return "host";
+#endif
+}
+
+void traza_volcar(void)
+{
+    // ningún núcleo vuelve a entrar a registrar(); se espera al que ya estaba
+    // (unos pocos ciclos) antes de leer y reiniciar los anillos
+    activa = false;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    for (int c = 0; c < TRAZA_NUCLEOS; c++) {
+        while (en_curso[c]) { }
+    }
+
+    uint32_t tareas[TAREAS_MAX];
+    int n_tareas = 0;
+    uint32_t total = 0;
+    for (int c = 0; c < TRAZA_NUCLEOS; c++)
+        total += escritos[c] < CONFIG_TRAZA_EVENTOS ? escritos[c] : CONFIG_TRAZA_EVENTOS;
+
+    printf("TRAZA_INICIO v1 nucleos=%d eventos=%lu\n", TRAZA_NUCLEOS, (unsigned long)total);
+    for (int m = 1; m < TRAZA_MARCAS; m++)
+        printf("TRAZA_MARCA %d %s\n", m, nombres_marca[m]);
+
+    for (int c = 0; c < TRAZA_NUCLEOS; c++) {
+        uint32_t n = escritos[c] < CONFIG_TRAZA_EVENTOS ? escritos[c] : CONFIG_TRAZA_EVENTOS;
+        uint32_t primero = escritos[c] - n;
+        char linea[8 + 16 * 24 + 2];
+        int largo = 0;
+
+        for (uint32_t k = 0; k < n; k++) {
+            const traza_registro_t *r = &anillo[c][(primero + k) % CONFIG_TRAZA_EVENTOS];
+
+            // nombres de las tareas que aparecen (una vez cada una)
+            if (r->tipo == TRAZA_EV_TAREA_ENTRA && r->arg) {
+                int t = 0;
+                while (t < n_tareas && tareas[t] != r->arg) t++;
+                if (t == n_tareas && n_tareas < TAREAS_MAX) {
+                    tareas[n_tareas++] = r->arg;
+                    printf("TRAZA_TAREA %08lx %s\n", (unsigned long)r->arg, nombre_tarea(r->arg));
+                }
+            }
+
+            if (largo == 0) largo = sprintf(linea, "TRAZA_E ");
+            const uint8_t *b = (const uint8_t *)r;
+            for (size_t i = 0; i < sizeof(*r); i++) largo += sprintf(linea + largo, "%02x", b[i]);
+            if ((k + 1) % 16 == 0 || k + 1 == n) {
+                puts(linea);
+                largo = 0;
+            }
+        }
+        escritos[c] = 0;
+    }
+    printf("TRAZA_FIN\n");
+    fflush(stdout);
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);   // los reinicios de escritos, antes de reactivar
+    activa = true;
+}
+
+#ifdef ESP_PLATFORM
+void task_traza(void *pvParameters)
+{
+    ESP_LOGI(TAG, "🧵 Traza activa: volcado en %d s (%d eventos por núcleo)", CONFIG_TRAZA_VOLCAR_S, CONFIG_TRAZA_EVENTOS);
+    vTaskDelay(pdMS_TO_TICKS(CONFIG_TRAZA_VOLCAR_S * 1000));
+    traza_volcar();
+    vTaskDelete(NULL);
+}
+#endif
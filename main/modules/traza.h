@@ -0,0 +1,38 @@
+#ifndef TRAZA_H
+#define TRAZA_H
+
+// Registro de planificación en RAM: cambios de tarea, colas, demoras y marcas
+// de usuario en un anillo por núcleo de eventos de 12 bytes. Se vuelca por la
+// consola como líneas TRAZA_* que tools/traza_a_perfetto.py convierte a JSON
+// de Chrome/Perfetto.
+
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "modules/traza_freertos.h"
+
+// Marcas de usuario (nombres en traza.c)
+typedef enum {
+    TRAZA_PARSE = 1,    // decodificar una línea NMEA / trama UBX
+    TRAZA_DECIDIR,      // evaluación del monitor
+    TRAZA_NVS,          // guardar_contador_eventos
+    TRAZA_BUZZER,       // bips con vTaskDelay dentro
+    TRAZA_MARCAS,
+} traza_marca_t;
+
+#if CONFIG_TRAZA
+void traza_marca(uint8_t tipo, traza_marca_t marca);
+#define TRAZA_INICIO(m)   traza_marca(TRAZA_EV_MARCA_INICIO, (m))
+#define TRAZA_FIN(m)      traza_marca(TRAZA_EV_MARCA_FIN, (m))
+
+// Detiene el registro, imprime el anillo y lo reinicia
+void traza_volcar(void);
+#ifdef ESP_PLATFORM
+// Vuelca una vez tras CONFIG_TRAZA_VOLCAR_S segundos
+void task_traza(void *pvParameters);
+#endif
+#else
+#define TRAZA_INICIO(m)   do { } while (0)
+#define TRAZA_FIN(m)      do { } while (0)
+#endif
+
+#endif // TRAZA_H
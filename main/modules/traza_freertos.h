@@ -0,0 +1,39 @@
+// Hooks de traza de FreeRTOS. El CMakeLists.txt raíz incluye este archivo en cada
+// fuente C del proyecto (también en el kernel) para que las macros trace* queden
+// definidas antes de FreeRTOS.h. Sin CONFIG_TRAZA no define nada.
+#pragma once
+
+#ifndef __ASSEMBLER__
+#include "sdkconfig.h"
+
+// Tipos de evento del anillo (también los usa tools/traza_a_perfetto.py)
+#define TRAZA_EV_TAREA_ENTRA    1
+#define TRAZA_EV_TAREA_SALE     2
+#define TRAZA_EV_COLA_ENVIO     3
+#define TRAZA_EV_COLA_RECIBE    4
+#define TRAZA_EV_COLA_BLOQUEO   5
+#define TRAZA_EV_DEMORA         6
+#define TRAZA_EV_NOTIFICA       7
+#define TRAZA_EV_MARCA_INICIO   8
+#define TRAZA_EV_MARCA_FIN      9
+
+#if CONFIG_TRAZA
+#include <stdint.h>
+
+void traza_evento(uint8_t tipo, uint32_t arg, uint16_t extra);
+void traza_cambio_tarea(uint8_t tipo);
+
+#define traceTASK_SWITCHED_IN()                 traza_cambio_tarea(TRAZA_EV_TAREA_ENTRA)
+#define traceTASK_SWITCHED_OUT()                traza_cambio_tarea(TRAZA_EV_TAREA_SALE)
+#define traceQUEUE_SEND(pxQueue)                traza_evento(TRAZA_EV_COLA_ENVIO, (uint32_t)(uintptr_t)(pxQueue), 0)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)       traza_evento(TRAZA_EV_COLA_ENVIO, (uint32_t)(uintptr_t)(pxQueue), 1)
+#define traceQUEUE_RECEIVE(pxQueue)             traza_evento(TRAZA_EV_COLA_RECIBE, (uint32_t)(uintptr_t)(pxQueue), 0)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue)    traza_evento(TRAZA_EV_COLA_RECIBE, (uint32_t)(uintptr_t)(pxQueue), 1)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) traza_evento(TRAZA_EV_COLA_BLOQUEO, (uint32_t)(uintptr_t)(pxQueue), 0)
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)    traza_evento(TRAZA_EV_COLA_BLOQUEO, (uint32_t)(uintptr_t)(pxQueue), 1)
+#define traceTASK_DELAY()                       traza_evento(TRAZA_EV_DEMORA, 0, 0)
+// xTaskToNotify es el parámetro de xTaskGenericNotify (FreeRTOS 10.5)
+#define traceTASK_NOTIFY(uxIndexToNotify)       traza_evento(TRAZA_EV_NOTIFICA, (uint32_t)(uintptr_t)xTaskToNotify, 0)
+#endif // CONFIG_TRAZA
+
+#endif // __ASSEMBLER__
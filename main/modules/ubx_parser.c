@@ -0,0 +1,190 @@
+#include <string.h>
+
+#include "modules/ubx_parser.h"
+
+enum {
+    UBX_E_SYNC1 = 0,
+    UBX_E_SYNC2,
+    UBX_E_CLASE,
+    UBX_E_ID,
+    UBX_E_LARGO1,
+    UBX_E_LARGO2,
+    UBX_E_PAYLOAD,
+    UBX_E_CK_A,
+    UBX_E_CK_B,
+};
+
+// ===========================================================
+//  CHECKSUM FLETCHER-8
+// ===========================================================
+void ubx_fletcher(const uint8_t *datos, size_t largo, uint8_t *ck_a, uint8_t *ck_b)
+{
+    uint8_t a = 0, b = 0;
+    for (size_t i = 0; i < largo; i++) {
+        a += datos[i];
+        b += a;
+    }
+    *ck_a = a;
+    *ck_b = b;
+}
+
+size_t ubx_armar_trama(uint8_t clase, uint8_t id, const void *payload, uint16_t largo, uint8_t *salida)
+{
+    salida[0] = UBX_SYNC1;
+    salida[1] = UBX_SYNC2;
+    salida[2] = clase;
+    salida[3] = id;
+    salida[4] = (uint8_t)(largo & 0xFF);
+    salida[5] = (uint8_t)(largo >> 8);
+    if (largo) memcpy(salida + 6, payload, largo);
+    ubx_fletcher(salida + 2, 4 + largo, &salida[6 + largo], &salida[7 + largo]);
+    return largo + UBX_SOBRECARGA;
+}
+
+// ===========================================================
+//  FRAMER POR FLUJO
+// ===========================================================
+void ubx_framer_init(ubx_framer_t *f)
+{
+    memset(f, 0, sizeof(*f));
+    f->estado = UBX_E_SYNC1;
+}
+
+static inline void sumar(ubx_framer_t *f, uint8_t b)
+{
+    f->ck_a += b;
+    f->ck_b += f->ck_a;
+}
+
+// Los bytes entre tramas se saltan con memchr y el payload se copia por bloques,
+// así el costo por byte queda en el Fletcher.
+GPS_HOT_ATTR ubx_resultado_t ubx_framer_alimentar(ubx_framer_t *f, const uint8_t *datos, size_t largo, size_t *usados)
+{
+    size_t i = 0;
+
+    while (i < largo) {
+        switch (f->estado) {
+            case UBX_E_SYNC1: {
+                const uint8_t *p = memchr(datos + i, UBX_SYNC1, largo - i);
+                if (p == NULL) {
+                    i = largo;
+                } else {
+                    i = (size_t)(p - datos) + 1;
+                    f->estado = UBX_E_SYNC2;
+                }
+                break;
+            }
+            case UBX_E_SYNC2: {
+                uint8_t b = datos[i++];
+                if (b == UBX_SYNC2) f->estado = UBX_E_CLASE;
+                else if (b != UBX_SYNC1) f->estado = UBX_E_SYNC1;
+                break;
+            }
+            case UBX_E_CLASE:
+                f->clase = datos[i++];
+                f->ck_a = f->ck_b = 0;
+                sumar(f, f->clase);
+                f->estado = UBX_E_ID;
+                break;
+            case UBX_E_ID:
+                f->id = datos[i++];
+                sumar(f, f->id);
+                f->estado = UBX_E_LARGO1;
+                break;
+            case UBX_E_LARGO1:
+                f->largo = datos[i++];
+                sumar(f, (uint8_t)f->largo);
+                f->estado = UBX_E_LARGO2;
+                break;
+            case UBX_E_LARGO2: {
+                uint8_t b = datos[i++];
+                sumar(f, b);
+                f->largo |= (uint16_t)b << 8;
+                f->pos = 0;
+                // mensaje no configurado o sync falso dentro de otra trama: resincronizar
+                if (f->largo > UBX_PAYLOAD_MAX) f->estado = UBX_E_SYNC1;
+                else f->estado = f->largo ? UBX_E_PAYLOAD : UBX_E_CK_A;
+                break;
+            }
+            case UBX_E_PAYLOAD: {
+                size_t n = f->largo - f->pos;
+                if (n > largo - i) n = largo - i;
+                memcpy(f->payload + f->pos, datos + i, n);
+                uint8_t a = f->ck_a, b = f->ck_b;
+                for (size_t k = 0; k < n; k++) {
+                    a += datos[i + k];
+                    b += a;
+                }
+                f->ck_a = a;
+                f->ck_b = b;
+                f->pos += n;
+                i += n;
+                if (f->pos == f->largo) f->estado = UBX_E_CK_A;
+                break;
+            }
+            case UBX_E_CK_A:
+                f->ck_a ^= datos[i++];          // queda en 0 si coincide
+                f->estado = UBX_E_CK_B;
+                break;
+            case UBX_E_CK_B: {
+                uint8_t b = datos[i++];
+                bool ok = f->ck_a == 0 && b == f->ck_b;
+                f->estado = UBX_E_SYNC1;
+                *usados = i;
+                return ok ? UBX_TRAMA_OK : UBX_TRAMA_ERROR;
+            }
+            default:
+                f->estado = UBX_E_SYNC1;
+                break;
+        }
+    }
+
+    *usados = i;
+    return UBX_SIN_TRAMA;
+}
+
+// ===========================================================
+//  NAV-PVT → REGISTRO DE FIX
+// ===========================================================
+static inline void dos_digitos(char *p, unsigned v)
+{
+    p[0] = (char)('0' + v / 10 % 10);
+    p[1] = (char)('0' + v % 10);
+}
+
+GPS_HOT_ATTR bool ubx_nav_pvt_a_fix(const uint8_t *payload, uint16_t largo, gps_data_t *gps, gps_quality_t *q)
+{
+    if (largo != UBX_LARGO_NAV_PVT) return false;
+
+    ubx_nav_pvt_t pvt;
+    memcpy(&pvt, payload, sizeof(pvt));
+
+    gps->valid = (pvt.flags & UBX_PVT_FLAG_FIX_OK) && pvt.tipo_fix >= 2 && pvt.tipo_fix <= 4;
+    gps->latitude = pvt.lat_e7 * 1e-7;
+    gps->longitude = pvt.lon_e7 * 1e-7;
+    gps->speed_kmh = pvt.vel_suelo_mms * 0.0036;
+    gps->course_deg = pvt.rumbo_e5 * 1e-5;
+
+    // hh:mm:ss redondeado por el receptor + nano (±): milisegundos del día
+    int32_t ms = ((pvt.hora * 60 + pvt.min) * 60 + pvt.seg) * 1000 + pvt.nano / 1000000;
+    if (ms < 0) ms += 86400000;
+    if (ms >= 86400000) ms -= 86400000;
+    unsigned s = (unsigned)ms / 1000;
+    dos_digitos(gps->time, s / 3600);
+    dos_digitos(gps->time + 2, s / 60 % 60);
+    dos_digitos(gps->time + 4, s % 60);
+    gps->time[6] = '.';
+    gps->time[7] = (char)('0' + ms / 100 % 10);
+    dos_digitos(gps->time + 8, (unsigned)ms % 100);
+    gps->time[10] = '\0';
+
+    dos_digitos(gps->date, pvt.dia);
+    dos_digitos(gps->date + 2, pvt.mes);
+    dos_digitos(gps->date + 4, pvt.anio % 100);
+    gps->date[6] = '\0';
+
+    q->altitude = pvt.h_msl_mm / 1000.0;
+    q->satellites = pvt.satelites;
+    q->hdop = pvt.pdop_cent / 100.0;
+    return true;
+}
@@ -0,0 +1,107 @@
+#ifndef UBX_PARSER_H
+#define UBX_PARSER_H
+
+// Protocolo binario UBX de u-blox: armado de tramas, framer por flujo con
+// checksum Fletcher-8 y decodificación directa de NAV-PVT al mismo registro
+// de fix que llena el parser NMEA. Sin dependencias de FreeRTOS ni de drivers
+// (se compila también en host/).
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "modules/nmea_parser.h"
+
+// ==================== FORMATO DE TRAMA ====================
+// [0xB5] [0x62] [CLASE] [ID] [LEN u16 LE] [payload LEN bytes] [CK_A] [CK_B]
+// Fletcher-8 sobre CLASE, ID, LEN y payload.
+#define UBX_SYNC1           0xB5
+#define UBX_SYNC2           0x62
+#define UBX_SOBRECARGA      8       // sync + clase + id + largo + checksum
+
+#define UBX_CLASE_NAV       0x01
+#define UBX_CLASE_ACK       0x05
+#define UBX_CLASE_CFG       0x06
+
+#define UBX_ID_NAV_PVT      0x07
+#define UBX_ID_CFG_PRT      0x00
+#define UBX_ID_CFG_MSG      0x01
+#define UBX_ID_CFG_RATE     0x08
+#define UBX_ID_CFG_CFG      0x09
+
+#define UBX_LARGO_NAV_PVT   92
+// NAV-PVT es el mensaje más largo que se decodifica; los mayores se descartan
+#define UBX_PAYLOAD_MAX     UBX_LARGO_NAV_PVT
+
+// ==================== NAV-PVT ====================
+// Disposición fija del payload (little endian, igual que el ESP32 y x86):
+// se copia tal cual sobre la estructura, sin parseo campo por campo.
+typedef struct __attribute__((packed)) {
+    uint32_t itow_ms;       // tiempo de la semana GPS
+    uint16_t anio;
+    uint8_t mes, dia;
+    uint8_t hora, min, seg;
+    uint8_t validez;        // bit0 fecha válida, bit1 hora válida
+    uint32_t t_acc_ns;
+    int32_t nano;           // fracción de segundo (puede ser negativa)
+    uint8_t tipo_fix;       // 0 sin fix, 2 2D, 3 3D, 4 GNSS+DR, 5 solo tiempo
+    uint8_t flags;          // bit0 gnssFixOK
+    uint8_t flags2;
+    uint8_t satelites;
+    int32_t lon_e7;
+    int32_t lat_e7;
+    int32_t altura_mm;      // sobre el elipsoide
+    int32_t h_msl_mm;       // sobre el nivel del mar
+    uint32_t h_acc_mm;
+    uint32_t v_acc_mm;
+    int32_t vel_n_mms;
+    int32_t vel_e_mms;
+    int32_t vel_d_mms;
+    int32_t vel_suelo_mms;  // gSpeed
+    int32_t rumbo_e5;       // headMot, 1e-5 grados
+    uint32_t s_acc_mms;
+    uint32_t rumbo_acc_e5;
+    uint16_t pdop_cent;
+    uint8_t flags3;
+    uint8_t reservado[5];
+    int32_t rumbo_vehiculo_e5;
+    int16_t decl_mag_e2;
+    uint16_t decl_mag_acc_e2;
+} ubx_nav_pvt_t;
+
+_Static_assert(sizeof(ubx_nav_pvt_t) == UBX_LARGO_NAV_PVT, "NAV-PVT de 92 bytes");
+
+#define UBX_PVT_FLAG_FIX_OK 0x01
+
+// ==================== FRAMER ====================
+typedef enum {
+    UBX_SIN_TRAMA = 0,      // se consumieron bytes sin completar una trama
+    UBX_TRAMA_OK,           // trama completa en f->clase / f->id / f->payload
+    UBX_TRAMA_ERROR,        // trama completa con checksum inválido
+} ubx_resultado_t;
+
+typedef struct {
+    uint8_t estado;
+    uint8_t clase, id;
+    uint16_t largo;
+    uint16_t pos;
+    uint8_t ck_a, ck_b;
+    uint8_t payload[UBX_PAYLOAD_MAX];
+} ubx_framer_t;
+
+void ubx_framer_init(ubx_framer_t *f);
+// Consume bytes hasta completar una trama o agotar la entrada; *usados indica
+// cuántos. Llamar en bucle mientras queden bytes.
+ubx_resultado_t ubx_framer_alimentar(ubx_framer_t *f, const uint8_t *datos, size_t largo, size_t *usados);
+
+// ==================== ARMADO Y DECODIFICACIÓN ====================
+void ubx_fletcher(const uint8_t *datos, size_t largo, uint8_t *ck_a, uint8_t *ck_b);
+// Arma una trama completa en salida (largo + UBX_SOBRECARGA bytes). Devuelve su largo.
+size_t ubx_armar_trama(uint8_t clase, uint8_t id, const void *payload, uint16_t largo, uint8_t *salida);
+
+// NAV-PVT → registro de fix (hora "hhmmss.sss", fecha "ddmmyy", km/h) y calidad
+// (altitud sobre el nivel del mar, satélites; NAV-PVT no trae HDOP y se usa el PDOP).
+// Devuelve false si el payload no tiene el largo de NAV-PVT.
+bool ubx_nav_pvt_a_fix(const uint8_t *payload, uint16_t largo, gps_data_t *gps, gps_quality_t *q);
+
+#endif // UBX_PARSER_H
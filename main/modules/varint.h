@@ -0,0 +1,91 @@
+#ifndef VARINT_H
+#define VARINT_H
+
+// Utilidades de codificación binaria compartidas (telemetría, trayecto):
+// enteros little endian, varint LEB128, zig-zag y CRC16-CCITT. Sin dependencias de hardware.
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Enteros de ancho fijo en little endian
+static inline uint8_t *put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+    return p + 2;
+}
+
+static inline uint8_t *put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = v >> 24;
+    return p + 4;
+}
+
+static inline uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Máximo de bytes que ocupa un varint de 32 bits
+#define VARINT_MAX_BYTES 5
+
+static inline uint8_t *put_varint(uint8_t *p, uint32_t v)
+{
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+// zig-zag: enteros chicos con signo → varints cortos
+static inline uint8_t *put_svarint(uint8_t *p, int32_t v)
+{
+    return put_varint(p, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+// Devuelve NULL si el varint no termina antes de fin
+static inline const uint8_t *get_varint(const uint8_t *p, const uint8_t *fin, uint32_t *v)
+{
+    uint32_t r = 0;
+    for (int desplazamiento = 0; p < fin && desplazamiento < 35; desplazamiento += 7) {
+        uint8_t b = *p++;
+        r |= (uint32_t)(b & 0x7F) << desplazamiento;
+        if (b < 0x80) {
+            *v = r;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static inline const uint8_t *get_svarint(const uint8_t *p, const uint8_t *fin, int32_t *v)
+{
+    uint32_t u;
+    p = get_varint(p, fin, &u);
+    if (p) *v = (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+    return p;
+}
+
+// CRC16-CCITT (poly 0x1021, init 0xFFFF)
+static inline uint16_t crc16_ccitt(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++)
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+#endif // VARINT_H
@@ -5,6 +5,7 @@
 #include "driver/gpio.h"
 
 #include "screens/display_7seg.h"
+#include "modules/atributos.h"
 
 static const char* TAG = "DISPLAY_7SEG";
 
@@ -48,14 +49,13 @@ void init_7seg_display_gpio(void)
 void display_set_number(uint16_t number)
 {
     if (number > 999) number = 999;
-    if (number < 0) number = 0;
     number_to_display = number;
 }
 
 // ----------------------
 // Mostrar un dígito específico
 // ----------------------
-static void show_digit(uint8_t digit, uint8_t value)
+GPS_HOT_ATTR void show_digit(uint8_t digit, uint8_t value)
 {
     // bits BCD
     gpio_set_level(BIT_0_GPIO, (value >> 0) & 0x01);
@@ -4,23 +4,26 @@
 #include "driver/gpio.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h" 
+#include "sdkconfig.h"
 
 // bit para el decodificador 7 segmentos 
-#define BIT_0_GPIO GPIO_NUM_2
-#define BIT_1_GPIO GPIO_NUM_4
-#define BIT_2_GPIO GPIO_NUM_13
-#define BIT_3_GPIO GPIO_NUM_33
+#define BIT_0_GPIO CONFIG_DISPLAY_BIT0_GPIO
+#define BIT_1_GPIO CONFIG_DISPLAY_BIT1_GPIO
+#define BIT_2_GPIO CONFIG_DISPLAY_BIT2_GPIO
+#define BIT_3_GPIO CONFIG_DISPLAY_BIT3_GPIO
 
 //pines gpio de los digitos (de los 3 displays)
-#define DIGITO_1_GPIO GPIO_NUM_18
-#define DIGITO_2_GPIO GPIO_NUM_19
-#define DIGITO_3_GPIO GPIO_NUM_21
+#define DIGITO_1_GPIO CONFIG_DISPLAY_DIGITO1_GPIO
+#define DIGITO_2_GPIO CONFIG_DISPLAY_DIGITO2_GPIO
+#define DIGITO_3_GPIO CONFIG_DISPLAY_DIGITO3_GPIO
 
 //pin gpio para el punto decimal (no usado)
-#define DP_GPIO GPIO_NUM_14
+#define DP_GPIO CONFIG_DISPLAY_DP_GPIO
 
 void init_7seg_display_gpio(void);
 void display_set_number(uint16_t number);
+// Escribe un valor BCD y activa solo el dígito indicado (1-3)
+void show_digit(uint8_t digit, uint8_t value);
 
 //task para manejar el display 7 seg
 void task_display_7seg(void *arg);
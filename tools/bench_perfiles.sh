@@ -0,0 +1,48 @@
+#!/usr/bin/env bash
+# Compila el modo benchmark con -Og, -O2 y -Os, con y sin IRAM_ATTR en las
+# funciones críticas, lo ejecuta en QEMU (idf.py qemu) y junta las líneas BENCH.
+# Uso: tools/bench_perfiles.sh [segundos_por_corrida]
+# Requiere el entorno de ESP-IDF cargado y qemu-xtensa instalado
+# (python $IDF_PATH/tools/idf_tools.py install qemu-xtensa).
+#
+# En QEMU los ciclos sirven para comparar perfiles entre sí; los valores
+# absolutos deben medirse en placa (idf.py flash monitor con el mismo fragmento).
+set -euo pipefail
+
+cd "$(dirname "$0")/.."
+limite=${1:-120}
+salida=bench_resultados.txt
+: > "$salida"
+
+declare -A opt_cfg=(
+    [Og]="CONFIG_COMPILER_OPTIMIZATION_DEBUG=y"
+    [O2]="CONFIG_COMPILER_OPTIMIZATION_PERF=y"
+    [Os]="CONFIG_COMPILER_OPTIMIZATION_SIZE=y"
+)
+
+for opt in Og O2 Os; do
+    for iram in n y; do
+        dir="build_bench_${opt}_iram${iram}"
+        mkdir -p "$dir"
+        {
+            echo "CONFIG_CONTOMETRO_BENCHMARK=y"
+            echo "# CONFIG_CONTOMETRO_LOG_VERBOSE is not set"
+            echo "${opt_cfg[$opt]}"
+            if [ "$iram" = y ]; then
+                echo "CONFIG_CONTOMETRO_HOT_IRAM=y"
+            else
+                echo "# CONFIG_CONTOMETRO_HOT_IRAM is not set"
+            fi
+        } > "$dir/sdkconfig.perfil"
+
+        idf.py -B "$dir" -DSDKCONFIG="$dir/sdkconfig" \
+            -DSDKCONFIG_DEFAULTS="sdkconfig;$dir/sdkconfig.perfil" build > "$dir/build.log" 2>&1 \
+            || { echo "$dir: fallo la compilación (ver $dir/build.log)"; continue; }
+
+        # QEMU no termina solo: se corta al ver "BENCH fin" o al vencer el límite
+        timeout "$limite" idf.py -B "$dir" -DSDKCONFIG="$dir/sdkconfig" qemu 2>&1 \
+            | sed -n '/BENCH inicio/,/BENCH fin/p;/BENCH fin/q' >> "$salida" || true
+    done
+done
+
+grep '^BENCH' "$salida"
@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""Decodifica una captura de telemetría binaria (CONFIG_TELEMETRIA_BINARIA) a CSV o GeoJSON.
+
+    tools/decodificar_telemetria.py captura.bin > fixes.csv
+    tools/decodificar_telemetria.py --geojson captura.bin > recorrido.geojson
+
+El formato de trama está descrito en main/modules/telemetria.h. Las tramas con CRC
+inválido se saltan y el decodificador busca el siguiente SYNC; tras una pérdida
+(salto de seq) los deltas se ignoran hasta la próxima trama clave.
+
+Una trama clave lleva el fix completo; un delta lleva solo seq, dt (ms) y las
+diferencias de lat, lon, vel, rumbo y alt más flags, sin satélites ni HDOP. En el
+CSV las filas de delta dejan vacías las columnas satelites y hdop: solo las filas
+de clave tienen esos valores medidos.
+"""
+import argparse
+import json
+import struct
+import sys
+
+SYNC = 0xA5
+TIPO_CLAVE = 0x01
+TIPO_DELTA = 0x02
+FMT_CLAVE = "<BIBBBiiHHiBBB"
+LARGO_CLAVE = struct.calcsize(FMT_CLAVE)
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def leer_varint(buf, i):
+    v = 0
+    desplazamiento = 0
+    while True:
+        b = buf[i]
+        i += 1
+        v |= (b & 0x7F) << desplazamiento
+        if b < 0x80:
+            return v, i
+        desplazamiento += 7
+
+
+def leer_svarint(buf, i):
+    v, i = leer_varint(buf, i)
+    return (v >> 1) ^ -(v & 1), i
+
+
+def tramas(datos, stats):
+    """Recorre el flujo y entrega (tipo, payload) de cada trama con CRC válido."""
+    i = 0
+    n = len(datos)
+    while i + 5 <= n:
+        if datos[i] != SYNC:
+            i += 1
+            continue
+        tipo, largo = datos[i + 1], datos[i + 2]
+        fin = i + 3 + largo
+        if tipo not in (TIPO_CLAVE, TIPO_DELTA) or fin + 2 > n:
+            i += 1
+            continue
+        crc = datos[fin] | (datos[fin + 1] << 8)
+        if crc16(datos[i + 1:fin]) != crc:
+            stats["crc"] += 1
+            i += 1
+            continue
+        yield tipo, datos[i + 3:fin]
+        i = fin + 2
+
+
+def decodificar(datos, stats):
+    ant = None
+    seq_esperado = None
+    for tipo, p in tramas(datos, stats):
+        seq = p[0]
+        perdida = seq_esperado is not None and seq != seq_esperado
+        seq_esperado = (seq + 1) & 0xFF
+        if perdida:
+            stats["perdidas"] += 1
+
+        if tipo == TIPO_CLAVE:
+            if len(p) != LARGO_CLAVE:
+                continue
+            (_, ms, dia, mes, anio, lat, lon, vel, rumbo, alt,
+             sats, hdop, flags) = struct.unpack(FMT_CLAVE, p)
+            ant = dict(ms=ms, dia=dia, mes=mes, anio=anio, lat=lat, lon=lon, vel=vel,
+                       rumbo=rumbo, alt=alt, sats=sats, hdop=hdop, flags=flags)
+            stats["claves"] += 1
+        else:
+            if ant is None or perdida:
+                ant = None  # sin referencia válida hasta la próxima clave
+                stats["sin_referencia"] += 1
+                continue
+            i = 1
+            dt, i = leer_varint(p, i)
+            dlat, i = leer_svarint(p, i)
+            dlon, i = leer_svarint(p, i)
+            dvel, i = leer_svarint(p, i)
+            drumbo, i = leer_svarint(p, i)
+            dalt, i = leer_svarint(p, i)
+            ant = dict(ant)
+            ant["ms"] += dt
+            ant["lat"] += dlat
+            ant["lon"] += dlon
+            ant["vel"] += dvel
+            ant["rumbo"] = (ant["rumbo"] + drumbo) % 36000
+            ant["alt"] += dalt
+            ant["flags"] = p[i]
+            ant["sats"] = ant["hdop"] = None    # el delta no los trae
+            stats["deltas"] += 1
+        yield ant
+
+
+def hora(ms):
+    s, ms = divmod(ms, 1000)
+    return "%02d:%02d:%02d.%03d" % (s // 3600, (s // 60) % 60, s % 60, ms)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("captura", help="archivo binario capturado del UART ('-' = stdin)")
+    ap.add_argument("--geojson", action="store_true", help="salida GeoJSON (LineString)")
+    args = ap.parse_args()
+
+    datos = sys.stdin.buffer.read() if args.captura == "-" else open(args.captura, "rb").read()
+    stats = dict(claves=0, deltas=0, crc=0, perdidas=0, sin_referencia=0)
+    fixes = decodificar(datos, stats)
+    out = sys.stdout
+
+    if args.geojson:
+        coords = [[f["lon"] / 1e7, f["lat"] / 1e7, f["alt"] / 10.0] for f in fixes]
+        json.dump({"type": "FeatureCollection", "features": [{
+            "type": "Feature", "properties": {},
+            "geometry": {"type": "LineString", "coordinates": coords}}]}, out)
+        out.write("\n")
+    else:
+        out.write("fecha,hora_utc,lat,lon,vel_kmh,rumbo_deg,alt_m,satelites,hdop,valido\n")
+        for f in fixes:
+            sats = "" if f["sats"] is None else "%d" % f["sats"]
+            hdop = "" if f["hdop"] is None else "%.1f" % (f["hdop"] / 10.0)
+            out.write("20%02d-%02d-%02d,%s,%.7f,%.7f,%.2f,%.2f,%.1f,%s,%s,%d\n" % (
+                f["anio"], f["mes"], f["dia"], hora(f["ms"]), f["lat"] / 1e7, f["lon"] / 1e7,
+                f["vel"] / 100.0, f["rumbo"] / 100.0, f["alt"] / 10.0, sats, hdop, f["flags"] & 1))
+
+    print("claves=%(claves)d deltas=%(deltas)d crc_invalido=%(crc)d "
+          "saltos_seq=%(perdidas)d deltas_sin_referencia=%(sin_referencia)d" % stats,
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
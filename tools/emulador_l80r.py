@@ -0,0 +1,589 @@
+#!/usr/bin/env python3
+"""Emulador del receptor L80-R en un pseudo-terminal (o TCP) para pruebas sin hardware.
+
+Emite RMC/GGA (y GLL/VTG/GSA/GSV según PMTK314) a partir de un trayecto, a la
+frecuencia configurada y al ritmo de los baudios; responde PMTK220/300/314/251/161
+con $PMTK001 y un retardo realista, e inyecta fallas para probar el camino del UART,
+los comandos PMTK del firmware y el desborde del lector. Como el L80-R, ignora los
+comandos sin '$' o con checksum inválido, salvo con --permisivo.
+
+    tools/emulador_l80r.py --enlace /tmp/l80r                 # 9600 baudios, 5 Hz, viaje sintético
+    tools/emulador_l80r.py --trayecto viaje.csv --hz 10 --falla silencio@20:5 --falla basura@40:2
+    tools/emulador_l80r.py --enlace /tmp/l80r --baudios 0 --rampa 50:400:50:3   # techo de la tarea lectora,
+    build_host/simulador -d /tmp/l80r -q -e /dev/null                            # con el firmware en host
+    tools/emulador_l80r.py --tcp 5556                          # QEMU: -serial tcp:127.0.0.1:5556
+
+Fallas (--falla TIPO@inicio_s:duración_s[:parámetro], se puede repetir):
+    silencio    no sale nada
+    rafaga      se retiene la salida y al terminar se entrega de golpe
+    basura      bytes aleatorios en lugar de tramas
+    perdida     se pierde cada byte con probabilidad parámetro (0.01 por defecto)
+    baudios     el receptor transmite a parámetro baudios (desfase con el UART del ESP32)
+
+Lo que sale por el pseudo-terminal cuando el emulador transmite a baudios distintos
+de los del lado del firmware (--baudios-receptor, o "auto" para leer el termios del
+pty) se remuestrea bit a bit, como lo vería un UART real.
+"""
+import argparse
+import os
+import random
+import select
+import socket
+import sys
+import termios
+import time
+import tty
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from generar_nmea import a_nmea, gpgga, gprmc, hora_utc, leer_trayecto, trama, viaje_sintetico  # noqa: E402
+
+NUDOS_POR_KMH = 1 / 1.852
+
+# Orden de los campos de PMTK314
+SENTENCIAS = ["GLL", "RMC", "VTG", "GGA", "GSA", "GSV"]
+SALIDA_FABRICA = {"GLL": 1, "RMC": 1, "VTG": 1, "GGA": 1, "GSA": 1, "GSV": 5}
+
+INTERVALO_MIN_MS = 100      # el L80-R no baja de 10 Hz
+FIFO_UART = 128             # bytes que el UART puede sacar de golpe
+
+VELOCIDADES_TERMIOS = {getattr(termios, "B%d" % b): b
+                       for b in (4800, 9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600)
+                       if hasattr(termios, "B%d" % b)}
+
+
+def log(msg):
+    print("[L80-R %8.3f] %s" % (time.monotonic() - T0, msg), file=sys.stderr, flush=True)
+
+
+T0 = time.monotonic()
+
+
+# ===========================================================
+#  TRAYECTO
+# ===========================================================
+class Trayecto:
+    """Interpola el trayecto a cualquier instante; al terminar vuelve a empezar."""
+
+    def __init__(self, puntos):
+        self.p = sorted(puntos, key=lambda x: x["t"])
+        self.t0 = self.p[0]["t"]
+        self.duracion = max(self.p[-1]["t"] - self.t0, 1e-3)
+        self.i = 0
+
+    def en(self, t_rel):
+        vuelta, t = divmod(t_rel, self.duracion)
+        t += self.t0
+        if t < self.p[self.i]["t"]:
+            self.i = 0
+        while self.i + 2 < len(self.p) and self.p[self.i + 1]["t"] <= t:
+            self.i += 1
+        a, b = self.p[self.i], self.p[min(self.i + 1, len(self.p) - 1)]
+        f = 0.0 if b["t"] == a["t"] else min(max((t - a["t"]) / (b["t"] - a["t"]), 0.0), 1.0)
+        punto = {k: a[k] + (b[k] - a[k]) * f for k in ("lat", "lon", "vel", "alt")}
+        punto["rumbo"] = a["rumbo"]
+        punto["t"] = self.t0 + t_rel          # la hora sigue corriendo entre vueltas
+        punto["valido"] = a.get("valido", True)
+        return punto
+
+
+# ===========================================================
+#  OTRAS SENTENCIAS (GLL, VTG, GSA, GSV)
+# ===========================================================
+def gpgll(p):
+    lat_g, lat_m, ns = a_nmea(p["lat"], "N", "S")
+    lon_g, lon_m, ew = a_nmea(p["lon"], "E", "W")
+    return trama("GPGLL,%02d%07.4f,%s,%03d%07.4f,%s,%s,A,A" % (lat_g, lat_m, ns, lon_g, lon_m, ew, hora_utc(p["t"])))
+
+
+def gpvtg(p):
+    return trama("GPVTG,%.2f,T,,M,%.2f,N,%.2f,K,A" % (p["rumbo"], p["vel"] * NUDOS_POR_KMH, p["vel"]))
+
+
+def gpgsa(p):
+    return trama("GPGSA,A,3,03,06,09,12,17,19,22,25,28,,,,1.60,0.90,1.32")
+
+
+def gpgsv(p):
+    sats = [(3, 48, 73, 42), (6, 28, 295, 38), (9, 61, 187, 45), (12, 17, 41, 33),
+            (17, 35, 241, 40), (19, 52, 128, 44), (22, 9, 325, 28), (25, 22, 100, 31)]
+    lineas = []
+    for i in range(0, len(sats), 4):
+        campos = ",".join("%02d,%02d,%03d,%02d" % s for s in sats[i:i + 4])
+        lineas.append(trama("GPGSV,%d,%d,%02d,%s" % ((len(sats) + 3) // 4, i // 4 + 1, len(sats), campos)))
+    return "".join(lineas)
+
+
+GENERADORES = {"GLL": gpgll, "RMC": gprmc, "VTG": gpvtg, "GGA": gpgga, "GSA": gpgsa, "GSV": gpgsv}
+
+
+# ===========================================================
+#  UART CON BAUDIOS DISTINTOS
+# ===========================================================
+def remuestrear(datos, baud_tx, baud_rx):
+    """Bytes que decodifica un UART a baud_rx de una transmisión 8N1 a baud_tx."""
+    bits = []
+    for b in datos:
+        bits.append(0)
+        bits.extend((b >> i) & 1 for i in range(8))
+        bits.append(1)
+    n = len(bits)
+
+    def nivel(t):
+        k = int(t * baud_tx)
+        return bits[k] if 0 <= k < n else 1
+
+    salida = bytearray()
+    t, fin = 0.0, n / baud_tx
+    paso = 1.0 / baud_rx
+    fino = min(paso, 1.0 / baud_tx) / 4
+    while t < fin:
+        if nivel(t) == 1:
+            t += fino
+            continue
+        # bit de inicio: muestrear cada dato en el centro de su bit
+        valor = 0
+        for i in range(8):
+            valor |= nivel(t + (i + 1.5) * paso) << i
+        salida.append(valor)
+        t += 9.5 * paso               # hasta el centro del bit de parada
+        while t < fin and nivel(t) == 0:
+            t += fino                 # error de trama: esperar la vuelta a reposo
+    return bytes(salida)
+
+
+# ===========================================================
+#  FALLAS
+# ===========================================================
+class Falla:
+    TIPOS = ("silencio", "rafaga", "basura", "perdida", "baudios")
+
+    def __init__(self, texto):
+        tipo, _, resto = texto.partition("@")
+        if tipo not in self.TIPOS or not resto:
+            raise argparse.ArgumentTypeError("falla inválida: %s" % texto)
+        partes = resto.split(":")
+        self.tipo = tipo
+        self.inicio = float(partes[0])
+        self.fin = self.inicio + (float(partes[1]) if len(partes) > 1 else 1.0)
+        self.param = float(partes[2]) if len(partes) > 2 else None
+        self.avisada = self.terminada = False
+
+    def activa(self, t):
+        return self.inicio <= t < self.fin
+
+
+# ===========================================================
+#  EMULADOR
+# ===========================================================
+class Emulador:
+    def __init__(self, args, trayecto, fd, slave_fd):
+        self.args = args
+        self.trayecto = trayecto
+        self.fd = fd
+        self.slave_fd = slave_fd
+        self.baudios = args.baudios
+        self.intervalo_ms = 1000.0 / args.hz
+        self.salidas = {s: 0 for s in SENTENCIAS}
+        self.salidas.update(RMC=1, GGA=1) if args.solo_rmc_gga else self.salidas.update(SALIDA_FABRICA)
+        self.standby = False
+        self.cola = bytearray()           # buffer TX del receptor
+        self.entrada = bytearray()
+        self.pendientes = []              # (t, función) acciones diferidas (acks, cambios)
+        self.fallas = args.falla
+        self.n_fix = 0
+        self.t_inicio = time.monotonic()
+        self.proximo_fix = self.t_inicio
+        self.t_tx = self.t_inicio
+        self.credito = 0.0
+        self.retenido = bytearray()       # ráfaga en curso
+        self.stats = dict(fixes=0, tramas=0, bytes=0, descartadas=0, pty_lleno=0, pmtk=0)
+        self.stats_previas = dict(self.stats)
+
+    # -------------------- tiempo --------------------
+    def t_rel(self, ahora):
+        return ahora - self.t_inicio
+
+    def diferir(self, retardo_s, accion):
+        self.pendientes.append((time.monotonic() + retardo_s, accion))
+
+    def retardo_ack(self):
+        return random.uniform(self.args.retardo_ack[0], self.args.retardo_ack[1]) / 1000.0
+
+    def falla_activa(self, tipo, t):
+        for f in self.fallas:
+            if f.tipo == tipo and f.activa(t):
+                return f
+        return None
+
+    # -------------------- salida --------------------
+    def encolar(self, texto):
+        datos = texto.encode("ascii")
+        if len(self.cola) + len(datos) > self.args.buffer_tx:
+            self.stats["descartadas"] += texto.count("$")
+            return
+        self.cola += datos
+        self.stats["tramas"] += texto.count("$")
+
+    def generar_fix(self, ahora):
+        p = self.trayecto.en(self.t_rel(ahora))
+        self.n_fix += 1
+        self.stats["fixes"] += 1
+        if self.falla_activa("basura", self.t_rel(ahora)):
+            self.encolar_bytes(os.urandom(random.randint(20, 120)))
+            return
+        for s in SENTENCIAS:
+            cada = self.salidas[s]
+            if cada and self.n_fix % cada == 0:
+                self.encolar(GENERADORES[s](p))
+
+    def encolar_bytes(self, datos):
+        if len(self.cola) + len(datos) <= self.args.buffer_tx:
+            self.cola += datos
+
+    def baudios_receptor(self):
+        if self.args.baudios_receptor == "auto" and self.slave_fd is not None:
+            velocidad = termios.tcgetattr(self.slave_fd)[5]
+            return VELOCIDADES_TERMIOS.get(velocidad, self.args.baudios)
+        if self.args.baudios_receptor not in (None, "auto"):
+            return int(self.args.baudios_receptor)
+        return self.args.baudios
+
+    def transmitir(self, ahora):
+        t = self.t_rel(ahora)
+        baudios = self.baudios
+        f = self.falla_activa("baudios", t)
+        if f:
+            baudios = int(f.param or 4800)
+
+        if baudios > 0:
+            self.credito = min(self.credito + (ahora - self.t_tx) * baudios / 10.0, FIFO_UART)
+        else:
+            self.credito = float("inf")
+        self.t_tx = ahora
+
+        if self.falla_activa("silencio", t) or self.standby:
+            self.credito = 0.0
+            return
+        n = len(self.cola) if self.credito == float("inf") else min(int(self.credito), len(self.cola))
+        if n <= 0:
+            return
+        datos = bytes(self.cola[:n])
+        del self.cola[:n]
+        self.credito -= n
+
+        perdida = self.falla_activa("perdida", t)
+        if perdida:
+            p = perdida.param if perdida.param is not None else 0.01
+            datos = bytes(b for b in datos if random.random() >= p)
+        rx = self.baudios_receptor()
+        if baudios > 0 and rx != baudios:
+            datos = remuestrear(datos, baudios, rx)
+
+        if self.falla_activa("rafaga", t):
+            self.retenido += datos
+            return
+        if self.retenido:
+            datos = bytes(self.retenido) + datos
+            self.retenido.clear()
+        self.escribir(datos)
+
+    def escribir(self, datos):
+        while datos:
+            try:
+                n = os.write(self.fd, datos)
+            except BlockingIOError:
+                # el lector no vacía el pty: lo que no entra vuelve al buffer TX
+                self.stats["pty_lleno"] += 1
+                self.cola[:0] = datos
+                if len(self.cola) > self.args.buffer_tx:
+                    self.stats["descartadas"] += self.cola.count(b"$", self.args.buffer_tx)
+                    del self.cola[self.args.buffer_tx:]
+                return
+            except OSError:
+                return                    # nadie conectado al pty
+            self.stats["bytes"] += n
+            datos = datos[n:]
+
+    # -------------------- PMTK --------------------
+    def responder(self, cmd, flag):
+        self.encolar(trama("PMTK001,%s,%d" % (cmd, flag)))
+
+    def recibir(self, datos):
+        if self.standby and datos:
+            self.standby = False
+            log("despierta de standby")
+            self.encolar(trama("PMTK010,002"))
+        self.entrada += datos
+        while b"\n" in self.entrada:
+            linea, _, resto = self.entrada.partition(b"\n")
+            self.entrada = bytearray(resto)
+            self.procesar_linea(linea.decode("ascii", "replace").strip())
+        if len(self.entrada) > 256:
+            self.entrada.clear()
+
+    def procesar_linea(self, linea):
+        if not linea:
+            return
+        cuerpo = linea
+        if linea.startswith("$"):
+            cuerpo, _, cs = linea[1:].partition("*")
+            try:
+                valido = len(cs) >= 2 and int(cs[:2], 16) == self.checksum(cuerpo)
+            except ValueError:
+                valido = False
+            if not valido:
+                log("checksum inválido, ignorado: %s" % linea)
+                return
+        elif not self.args.permisivo:
+            log("sin '$' ni checksum, ignorado (como el receptor real): %s" % linea)
+            return
+        else:
+            log("aceptado sin '$' ni checksum: %s" % linea)
+        if not cuerpo.startswith("PMTK"):
+            return
+        self.stats["pmtk"] += 1
+        campos = cuerpo[4:].split(",")
+        cmd, params = campos[0], campos[1:]
+        manejador = getattr(self, "pmtk_" + cmd, None)
+        if manejador is None:
+            self.diferir(self.retardo_ack(), lambda: self.responder(cmd, 1))
+            log("PMTK%s no soportado" % cmd)
+            return
+        manejador(params)
+
+    @staticmethod
+    def checksum(cuerpo):
+        c = 0
+        for ch in cuerpo.encode("ascii", "replace"):
+            c ^= ch
+        return c
+
+    def pmtk_intervalo(self, cmd, params):
+        try:
+            ms = int(params[0])
+        except (IndexError, ValueError):
+            self.diferir(self.retardo_ack(), lambda: self.responder(cmd, 0))
+            return
+        minimo = 1 if self.args.sin_limite else INTERVALO_MIN_MS
+        if not minimo <= ms <= 10000:
+            self.diferir(self.retardo_ack(), lambda: self.responder(cmd, 2))
+            log("PMTK%s,%d fuera de rango" % (cmd, ms))
+            return
+
+        def aplicar():
+            self.responder(cmd, 3)
+            if self.args.rampa:
+                log("intervalo de fix %d ms ignorado: la frecuencia la fija --rampa" % ms)
+                return
+            self.intervalo_ms = float(ms)
+            log("intervalo de fix %d ms (%.1f Hz)" % (ms, 1000.0 / ms))
+        self.diferir(self.retardo_ack(), aplicar)
+
+    def pmtk_220(self, params):
+        self.pmtk_intervalo("220", params)
+
+    def pmtk_300(self, params):
+        self.pmtk_intervalo("300", params)
+
+    def pmtk_314(self, params):
+        if params and params[0] == "-1":
+            nuevas = dict(SALIDA_FABRICA)
+        elif 17 <= len(params) <= 19 and all(p.isdigit() for p in params):
+            nuevas = {s: min(int(params[i]), 5) for i, s in enumerate(SENTENCIAS)}
+        else:
+            self.diferir(self.retardo_ack(), lambda: self.responder("314", 0))
+            log("PMTK314 con %d campos: inválido" % len(params))
+            return
+
+        def aplicar():
+            self.salidas = nuevas
+            self.responder("314", 3)
+            log("salidas: %s" % ", ".join("%s/%d" % (s, c) for s, c in nuevas.items() if c) or "ninguna")
+        self.diferir(self.retardo_ack(), aplicar)
+
+    def pmtk_251(self, params):
+        try:
+            nuevos = int(params[0]) or 9600
+        except (IndexError, ValueError):
+            self.diferir(self.retardo_ack(), lambda: self.responder("251", 0))
+            return
+
+        # el ack sale a los baudios viejos; el cambio llega unos 100 ms después
+        def aplicar():
+            self.baudios = nuevos
+            log("baudios → %d" % nuevos)
+        self.diferir(self.retardo_ack(), lambda: self.responder("251", 3))
+        self.diferir(self.retardo_ack() + 0.1, aplicar)
+
+    def pmtk_161(self, params):
+        def aplicar():
+            self.responder("161", 3)
+            self.diferir(0.05, self.entrar_standby)
+        self.diferir(self.retardo_ack(), aplicar)
+
+    def entrar_standby(self):
+        self.standby = True
+        log("standby (cualquier byte lo despierta)")
+
+    # -------------------- bucle --------------------
+    def fijar_hz(self, hz):
+        self.intervalo_ms = 1000.0 / hz
+
+    def reportar(self, etiqueta):
+        d = {k: self.stats[k] - self.stats_previas[k] for k in self.stats}
+        self.stats_previas = dict(self.stats)
+        log("%s: %d fixes, %d tramas, %d bytes, descartadas %d, pty lleno %d, cola %d B" % (
+            etiqueta, d["fixes"], d["tramas"], d["bytes"], d["descartadas"], d["pty_lleno"], len(self.cola)))
+        return d
+
+    def ejecutar(self):
+        rampa = self.args.rampa
+        escalones = []
+        t_escalon = self.t_inicio
+        if rampa:
+            self.fijar_hz(rampa[0])
+        proximo_reporte = self.t_inicio + self.args.estadisticas
+        self.encolar(trama("PMTK010,001"))        # mensaje de arranque
+
+        while True:
+            ahora = time.monotonic()
+            t = self.t_rel(ahora)
+            if self.args.duracion and t >= self.args.duracion:
+                break
+
+            for f in self.fallas:
+                if f.activa(t) and not f.avisada:
+                    f.avisada = True
+                    log("falla %s durante %.1f s" % (f.tipo, f.fin - f.inicio))
+                elif f.avisada and not f.terminada and t >= f.fin:
+                    f.terminada = True
+                    log("fin de la falla %s" % f.tipo)
+
+            for item in [x for x in self.pendientes if x[0] <= ahora]:
+                self.pendientes.remove(item)
+                item[1]()
+
+            if ahora >= self.proximo_fix:
+                if not self.standby:
+                    self.generar_fix(ahora)
+                self.proximo_fix += self.intervalo_ms / 1000.0
+                if self.proximo_fix < ahora - 1.0:
+                    self.proximo_fix = ahora      # no acumular atraso si el host se trabó
+
+            self.transmitir(ahora)
+
+            if rampa and ahora - t_escalon >= rampa[3]:
+                hz = 1000.0 / self.intervalo_ms
+                d = self.reportar("escalón %.0f Hz" % hz)
+                escalones.append((hz, d, rampa[3]))
+                t_escalon = ahora
+                if hz + rampa[2] > rampa[1] + 1e-9:
+                    break
+                self.fijar_hz(hz + rampa[2])
+            elif self.args.estadisticas and ahora >= proximo_reporte:
+                self.reportar("últimos %.0f s a %.1f Hz" % (self.args.estadisticas, 1000.0 / self.intervalo_ms))
+                proximo_reporte += self.args.estadisticas
+
+            espera = max(0.0, min(self.proximo_fix - time.monotonic(), 0.002))
+            r, _, _ = select.select([self.fd], [], [], espera)
+            if r:
+                try:
+                    datos = os.read(self.fd, 1024)
+                except (BlockingIOError, OSError):
+                    datos = b""
+                if datos:
+                    self.recibir(datos)
+
+        if escalones:
+            print("hz,fixes_s,tramas_s,bytes_s,descartadas_s,pty_lleno_s")
+            for hz, d, dur in escalones:
+                print("%.0f,%.1f,%.1f,%.0f,%.1f,%.1f" % (hz, d["fixes"] / dur, d["tramas"] / dur,
+                                                          d["bytes"] / dur, d["descartadas"] / dur,
+                                                          d["pty_lleno"] / dur))
+
+
+# ===========================================================
+#  PTY / TCP
+# ===========================================================
+def abrir_pty(enlace):
+    master, slave = os.openpty()
+    tty.setraw(slave)                # sin eco ni edición de línea
+    os.set_blocking(master, False)
+    ruta = os.ttyname(slave)
+    if enlace:
+        if os.path.islink(enlace):
+            os.unlink(enlace)
+        os.symlink(ruta, enlace)
+        ruta = "%s → %s" % (enlace, ruta)
+    return master, slave, ruta
+
+
+def abrir_tcp(puerto):
+    srv = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    srv.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    srv.bind(("127.0.0.1", puerto))
+    srv.listen(1)
+    log("esperando conexión en 127.0.0.1:%d" % puerto)
+    con, _ = srv.accept()
+    con.setblocking(False)
+    con.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    return con, "tcp 127.0.0.1:%d" % puerto
+
+
+def rampa(texto):
+    partes = [float(x) for x in texto.split(":")]
+    if len(partes) != 4 or partes[0] <= 0 or partes[2] <= 0 or partes[3] <= 0:
+        raise argparse.ArgumentTypeError("rampa: desde_hz:hasta_hz:paso_hz:segundos")
+    return partes
+
+
+def rango_ms(texto):
+    a, _, b = texto.partition(":")
+    return (float(a), float(b or a))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0],
+                                 formatter_class=argparse.RawDescriptionHelpFormatter,
+                                 epilog="\n".join(__doc__.splitlines()[2:]))
+    ap.add_argument("--trayecto", help="CSV t_s,lat,lon,vel_kmh,rumbo_deg,alt_m (por defecto viaje sintético)")
+    ap.add_argument("--hz", type=float, default=5.0, help="frecuencia de fix inicial")
+    ap.add_argument("--baudios", type=int, default=9600, help="baudios del receptor (0 = sin ritmo)")
+    ap.add_argument("--baudios-receptor", help="baudios del UART del firmware (N o auto; por defecto iguales)")
+    ap.add_argument("--solo-rmc-gga", action="store_true", help="arrancar con RMC+GGA en vez de la salida de fábrica")
+    ap.add_argument("--buffer-tx", type=int, default=2048, help="buffer TX del receptor (bytes)")
+    ap.add_argument("--retardo-ack", type=rango_ms, default=(20.0, 80.0), help="ms del $PMTK001 (min:max)")
+    ap.add_argument("--permisivo", action="store_true", help="aceptar PMTK sin '$' ni checksum (el receptor real los ignora)")
+    ap.add_argument("--sin-limite", action="store_true", help="aceptar PMTK220/300 por debajo de 100 ms")
+    ap.add_argument("--falla", type=Falla, action="append", default=[], help="TIPO@inicio:duración[:parámetro]")
+    ap.add_argument("--rampa", type=rampa, help="desde_hz:hasta_hz:paso_hz:segundos; CSV por escalón en stdout")
+    ap.add_argument("--estadisticas", type=float, default=10.0, help="reporte periódico (s, 0 = nunca)")
+    ap.add_argument("--duracion", type=float, default=0.0, help="segundos de emulación (0 = sin fin)")
+    ap.add_argument("--semilla", type=int, default=1)
+    destino = ap.add_mutually_exclusive_group()
+    destino.add_argument("--enlace", help="symlink estable al pty (p. ej. /tmp/l80r)")
+    destino.add_argument("--tcp", type=int, help="escuchar en este puerto TCP en vez de crear un pty")
+    args = ap.parse_args()
+
+    random.seed(args.semilla)
+    puntos = leer_trayecto(args.trayecto) if args.trayecto else viaje_sintetico(6000, 10.0)
+    trayecto = Trayecto(puntos)
+
+    if args.tcp:
+        con, ruta = abrir_tcp(args.tcp)
+        fd, slave = con.fileno(), None
+    else:
+        fd, slave, ruta = abrir_pty(args.enlace)
+    log("emulando en %s: %d baudios, %.1f Hz, trayecto de %.0f s" % (ruta, args.baudios, args.hz, trayecto.duracion))
+
+    try:
+        Emulador(args, trayecto, fd, slave).ejecutar()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if args.enlace and os.path.islink(args.enlace):
+            os.unlink(args.enlace)
+
+
+if __name__ == "__main__":
+    main()
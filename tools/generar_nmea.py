@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""Genera tramas NMEA (GPRMC + GPGGA) con checksum válido.
+
+La trayectoria sale de un CSV (t_s,lat,lon,vel_kmh,rumbo_deg,alt_m) o, si no se
+indica, de un viaje sintético: arranque, crucero sobre el umbral, frenado y detención.
+
+    tools/generar_nmea.py --fixes 400 --hz 5 > main/bench/captura_nmea.txt
+"""
+import argparse
+import csv
+import math
+import sys
+
+NUDOS_POR_KMH = 1 / 1.852
+RADIO_TIERRA_M = 6371000.0
+
+
+def checksum(cuerpo):
+    c = 0
+    for ch in cuerpo.encode("ascii"):
+        c ^= ch
+    return c
+
+
+def trama(cuerpo):
+    return "$%s*%02X\r\n" % (cuerpo, checksum(cuerpo))
+
+
+def a_nmea(grados, positivo, negativo):
+    hem = positivo if grados >= 0 else negativo
+    grados = abs(grados)
+    g = int(grados)
+    minutos = (grados - g) * 60.0
+    return g, minutos, hem
+
+
+def hora_utc(t_s):
+    t = int(t_s)
+    cs = int(round((t_s - t) * 100)) % 100
+    return "%02d%02d%02d.%02d" % ((t // 3600) % 24, (t // 60) % 60, t % 60, cs)
+
+
+def gprmc(p, fecha="191026"):
+    lat_g, lat_m, ns = a_nmea(p["lat"], "N", "S")
+    lon_g, lon_m, ew = a_nmea(p["lon"], "E", "W")
+    cuerpo = "GPRMC,%s,%s,%02d%07.4f,%s,%03d%07.4f,%s,%.2f,%.2f,%s,,,A" % (
+        hora_utc(p["t"]), "A" if p.get("valido", True) else "V",
+        lat_g, lat_m, ns, lon_g, lon_m, ew,
+        p["vel"] * NUDOS_POR_KMH, p["rumbo"], fecha)
+    return trama(cuerpo)
+
+
+def gpgga(p, satelites=9, hdop=0.9):
+    lat_g, lat_m, ns = a_nmea(p["lat"], "N", "S")
+    lon_g, lon_m, ew = a_nmea(p["lon"], "E", "W")
+    cuerpo = "GPGGA,%s,%02d%07.4f,%s,%03d%07.4f,%s,%d,%02d,%.2f,%.1f,M,32.0,M,," % (
+        hora_utc(p["t"]), lat_g, lat_m, ns, lon_g, lon_m, ew,
+        1 if p.get("valido", True) else 0, satelites, hdop, p["alt"])
+    return trama(cuerpo)
+
+
+def viaje_sintetico(fixes, hz, lat=-33.4489, lon=-70.6693, t0=12 * 3600.0):
+    """Perfil de velocidad: 0 → 50 km/h, crucero, baja a 20, vuelve a 45 y se detiene."""
+    dt = 1.0 / hz
+    rumbo = 35.0
+    puntos = []
+    for i in range(fixes):
+        f = i / max(fixes - 1, 1)
+        if f < 0.1:
+            vel = 0.0
+        elif f < 0.3:
+            vel = 50.0 * (f - 0.1) / 0.2
+        elif f < 0.5:
+            vel = 50.0 + 3.0 * math.sin(i * 0.3)
+        elif f < 0.6:
+            vel = 20.0
+        elif f < 0.8:
+            vel = 45.0 + 2.0 * math.sin(i * 0.2)
+        elif f < 0.9:
+            vel = 45.0 * (0.9 - f) / 0.1
+        else:
+            vel = 0.0
+        rumbo = (rumbo + 0.5 * math.sin(i * 0.05)) % 360.0
+        d = vel / 3.6 * dt
+        lat += math.degrees(d * math.cos(math.radians(rumbo)) / RADIO_TIERRA_M)
+        lon += math.degrees(d * math.sin(math.radians(rumbo)) /
+                            (RADIO_TIERRA_M * math.cos(math.radians(lat))))
+        puntos.append({"t": t0 + i * dt, "lat": lat, "lon": lon,
+                       "vel": vel, "rumbo": rumbo, "alt": 550.0})
+    return puntos
+
+
+def leer_trayecto(ruta):
+    puntos = []
+    with open(ruta, newline="") as f:
+        for fila in csv.DictReader(f):
+            puntos.append({"t": float(fila["t_s"]), "lat": float(fila["lat"]),
+                           "lon": float(fila["lon"]), "vel": float(fila["vel_kmh"]),
+                           "rumbo": float(fila["rumbo_deg"]), "alt": float(fila["alt_m"])})
+    return puntos
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--trayecto", help="CSV t_s,lat,lon,vel_kmh,rumbo_deg,alt_m")
+    ap.add_argument("--fixes", type=int, default=400, help="fixes del viaje sintético")
+    ap.add_argument("--hz", type=float, default=5.0, help="frecuencia del viaje sintético")
+    ap.add_argument("--sin-gga", action="store_true", help="solo GPRMC")
+    args = ap.parse_args()
+
+    puntos = leer_trayecto(args.trayecto) if args.trayecto else viaje_sintetico(args.fixes, args.hz)
+    out = sys.stdout
+    for p in puntos:
+        if not args.sin_gga:
+            out.write(gpgga(p))
+        out.write(gprmc(p))
+
+
+if __name__ == "__main__":
+    main()
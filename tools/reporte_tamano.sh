@@ -0,0 +1,38 @@
+#!/usr/bin/env bash
+# Compila cada variante de configs/ y reporta el tamaño de la imagen.
+# Uso: tools/reporte_tamano.sh [variante ...]   (por defecto todas)
+# Cada variante parte del sdkconfig del repositorio y aplica su fragmento.
+# Requiere el entorno de ESP-IDF cargado (idf.py en el PATH).
+set -euo pipefail
+
+cd "$(dirname "$0")/.."
+
+variantes=("$@")
+if [ ${#variantes[@]} -eq 0 ]; then
+    for f in configs/sdkconfig.*; do
+        variantes+=("${f#configs/sdkconfig.}")
+    done
+fi
+
+printf "%-12s %10s %10s %10s %10s\n" "variante" "bin" "iram" "dram" "flash"
+for v in "${variantes[@]}"; do
+    dir="build_${v}"
+    mkdir -p "$dir"
+    # SDKCONFIG_DEFAULTS solo se aplica si el sdkconfig no existe: sin esto, un
+    # fragmento editado después de la primera corrida no cambiaría nada
+    rm -f "$dir/sdkconfig"
+    idf.py -B "$dir" -DSDKCONFIG="$dir/sdkconfig" \
+        -DSDKCONFIG_DEFAULTS="sdkconfig;configs/sdkconfig.${v}" build > "$dir/build.log" 2>&1 \
+        || { echo "$v: fallo la compilación (ver $dir/build.log)"; continue; }
+
+    bin=$(stat -c %s "$dir/contometro_vehicular.bin")
+    json=$(idf.py -B "$dir" -DSDKCONFIG="$dir/sdkconfig" size --format json2 2>/dev/null | sed -n '/^{/,$p')
+    read -r iram dram flash < <(python3 -c '
+import json, sys
+d = json.load(sys.stdin)["layout"]
+def usado(*nombres):
+    return sum(m["used"] for m in d if m["name"] in nombres)
+print(usado("IRAM"), usado("DRAM"), usado("Flash Code", "Flash Data"))
+' <<< "$json")
+    printf "%-12s %10d %10d %10d %10d\n" "$v" "$bin" "$iram" "$dram" "$flash"
+done
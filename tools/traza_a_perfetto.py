@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+"""Convierte un volcado de la traza de planificación (CONFIG_TRAZA) a JSON de Chrome/Perfetto.
+
+    idf.py monitor | tee consola.log        # esperar la línea TRAZA_FIN
+    tools/traza_a_perfetto.py consola.log > traza.json
+    # abrir traza.json en https://ui.perfetto.dev o chrome://tracing
+
+Cada núcleo es una pista con la tarea que corría y los eventos de colas,
+notificaciones y vTaskDelay como instantes. Las marcas de usuario (parse,
+decidir, nvs, buzzer) van en una pista por tarea. El formato de las líneas
+TRAZA_* está en main/modules/traza.c; si hay varios volcados se usa el último.
+"""
+import argparse
+import json
+import re
+import struct
+import sys
+
+FMT_REGISTRO = "<IIBBH"
+LARGO_REGISTRO = struct.calcsize(FMT_REGISTRO)
+
+TAREA_ENTRA, TAREA_SALE = 1, 2
+INSTANTES = {
+    3: "cola_envio",
+    4: "cola_recibe",
+    5: "cola_bloqueo",
+    6: "vTaskDelay",
+    7: "notifica",
+}
+MARCA_INICIO, MARCA_FIN = 8, 9
+
+PID_NUCLEOS = 0
+PID_MARCAS = 1
+
+LINEA = re.compile(r"TRAZA_(INICIO|MARCA|TAREA|E|FIN)\b ?(.*)")
+
+
+def leer_volcado(lineas):
+    """Devuelve (marcas, tareas, registros) del último volcado completo."""
+    volcado = None
+    actual = None
+    for linea in lineas:
+        m = LINEA.search(linea)
+        if not m:
+            continue
+        tipo, resto = m.group(1), m.group(2).strip()
+        if tipo == "INICIO":
+            actual = {"marcas": {}, "tareas": {}, "datos": bytearray()}
+        elif actual is None:
+            continue
+        elif tipo == "MARCA":
+            ident, nombre = resto.split(" ", 1)
+            actual["marcas"][int(ident)] = nombre
+        elif tipo == "TAREA":
+            handle, nombre = (resto.split(" ", 1) + ["?"])[:2]
+            actual["tareas"][int(handle, 16)] = nombre
+        elif tipo == "E":
+            actual["datos"] += bytes.fromhex(resto)
+        elif tipo == "FIN":
+            volcado, actual = actual, None
+    if volcado is None:
+        sys.exit("no hay un volcado completo (TRAZA_INICIO ... TRAZA_FIN)")
+
+    datos = volcado["datos"]
+    registros = [struct.unpack_from(FMT_REGISTRO, datos, i)
+                 for i in range(0, len(datos) - LARGO_REGISTRO + 1, LARGO_REGISTRO)]
+    return volcado["marcas"], volcado["tareas"], registros
+
+
+def desenvolver(registros):
+    """Tiempos de 32 bits → continuos, por núcleo (cada anillo está en orden)."""
+    salida = []
+    previo, suma = {}, {}
+    for t, arg, tipo, nucleo, extra in registros:
+        suma.setdefault(nucleo, 0)
+        t += suma[nucleo]
+        if nucleo in previo and t < previo[nucleo] - (1 << 31):
+            suma[nucleo] += 1 << 32
+            t += 1 << 32
+        previo[nucleo] = t
+        salida.append((t, arg, tipo, nucleo, extra))
+    return salida
+
+
+def convertir(marcas, tareas, registros):
+    registros = desenvolver(registros)
+    if not registros:
+        return []
+    base = min(r[0] for r in registros)
+    fin = max(r[0] for r in registros) - base
+
+    def nombre_tarea(h):
+        return tareas.get(h, "0x%08x" % h)
+
+    eventos = [{"ph": "M", "pid": PID_NUCLEOS, "name": "process_name", "args": {"name": "CPU"}},
+               {"ph": "M", "pid": PID_MARCAS, "name": "process_name", "args": {"name": "marcas"}}]
+    nucleos = sorted({r[3] for r in registros})
+    for n in nucleos:
+        eventos.append({"ph": "M", "pid": PID_NUCLEOS, "tid": n, "name": "thread_name",
+                        "args": {"name": "núcleo %d" % n}})
+
+    corriendo = {}      # núcleo → (tarea, inicio)
+    abiertas = {}       # (tarea, marca) → cantidad de B sin E
+    tareas_con_marcas = set()
+
+    for t, arg, tipo, nucleo, extra in sorted(registros, key=lambda r: r[0]):
+        ts = t - base
+        if tipo == TAREA_ENTRA:
+            corriendo[nucleo] = (arg, ts)
+        elif tipo == TAREA_SALE:
+            tarea, inicio = corriendo.pop(nucleo, (arg, 0))
+            eventos.append({"ph": "X", "pid": PID_NUCLEOS, "tid": nucleo, "ts": inicio,
+                            "dur": max(ts - inicio, 0), "name": nombre_tarea(tarea)})
+        elif tipo in INSTANTES:
+            args = {"tarea": nombre_tarea(corriendo.get(nucleo, (0, 0))[0])}
+            if tipo != 6:
+                args["objeto"] = "0x%08x" % arg
+                args["isr"] = bool(extra)
+            eventos.append({"ph": "i", "s": "t", "pid": PID_NUCLEOS, "tid": nucleo, "ts": ts,
+                            "name": INSTANTES[tipo], "args": args})
+        elif tipo in (MARCA_INICIO, MARCA_FIN):
+            clave = (arg, extra)
+            if tipo == MARCA_INICIO:
+                abiertas[clave] = abiertas.get(clave, 0) + 1
+            elif abiertas.get(clave, 0) == 0:
+                continue        # el inicio quedó fuera del anillo
+            else:
+                abiertas[clave] -= 1
+            tareas_con_marcas.add(arg)
+            eventos.append({"ph": "B" if tipo == MARCA_INICIO else "E", "pid": PID_MARCAS, "tid": arg,
+                            "ts": ts, "name": marcas.get(extra, "marca %d" % extra),
+                            "args": {"nucleo": nucleo}})
+
+    # lo que seguía abierto al volcar
+    for nucleo, (tarea, inicio) in corriendo.items():
+        eventos.append({"ph": "X", "pid": PID_NUCLEOS, "tid": nucleo, "ts": inicio,
+                        "dur": max(fin - inicio, 0), "name": nombre_tarea(tarea)})
+    for (tarea, marca), n in abiertas.items():
+        for _ in range(n):
+            eventos.append({"ph": "E", "pid": PID_MARCAS, "tid": tarea, "ts": fin,
+                            "name": marcas.get(marca, "marca %d" % marca)})
+    for tarea in tareas_con_marcas:
+        eventos.append({"ph": "M", "pid": PID_MARCAS, "tid": tarea, "name": "thread_name",
+                        "args": {"name": nombre_tarea(tarea)}})
+    return eventos
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("consola", nargs="?", help="log de consola con el volcado (stdin si se omite)")
+    args = ap.parse_args()
+
+    entrada = open(args.consola, errors="replace") if args.consola else sys.stdin
+    marcas, tareas, registros = leer_volcado(entrada)
+    eventos = convertir(marcas, tareas, registros)
+    json.dump({"traceEvents": eventos, "displayTimeUnit": "ms"}, sys.stdout)
+    print("%d registros → %d eventos" % (len(registros), len(eventos)), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()